@@ -0,0 +1,87 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// Quantile accuracy against memory for the sketching samples, on
+// heavy-tailed synthetic latencies where the tail is what matters.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "harness.h"
+#include "medida/stats/ckms_sample.h"
+#include "medida/stats/windowed_sketch_sample.h"
+
+using namespace medida;
+using namespace medida::bench;
+
+namespace {
+
+const std::size_t kValues = 500000;
+
+// Lognormal latencies in microseconds: a median near 20 with a tail
+// reaching into the tens of seconds.
+std::vector<std::int64_t> HeavyTailed() {
+  std::mt19937_64 rng {42};
+  std::lognormal_distribution<double> dist {3.0, 2.5};
+  std::vector<std::int64_t> values;
+  values.reserve(kValues);
+  for (std::size_t i = 0; i < kValues; i++) {
+    values.push_back(static_cast<std::int64_t>(std::min(1e8, 1 + dist(rng))));
+  }
+  return values;
+}
+
+// Fills the sample from `make` with one window of values and compares its
+// quantiles with the exact ones. The timestamped overloads keep every value
+// in the same window.
+template <typename T>
+void Measure(const char* name, std::function<T*()> make, const std::vector<std::int64_t>& values,
+             const std::vector<std::int64_t>& sorted, std::vector<Record>& out) {
+  auto t = Clock::time_point();
+  auto before = LiveHeapBytes();
+  std::unique_ptr<T> sample {make()};
+  for (auto v : values) {
+    sample->Update(v, t);
+  }
+  auto bytes = LiveHeapBytes() - before;
+  auto snapshot = sample->MakeSnapshot(t + std::chrono::seconds(30));
+
+  Record r;
+  r.Set("suite", "accuracy")
+   .Set("name", name)
+   .Set("values", kValues)
+   .Set("bytes", bytes);
+  const std::pair<const char*, double> quantiles[] = {
+    {"p50", 0.5}, {"p99", 0.99}, {"p999", 0.999}, {"p9999", 0.9999},
+  };
+  for (auto& q : quantiles) {
+    auto exact = static_cast<double>(sorted[static_cast<std::size_t>(q.second * (sorted.size() - 1))]);
+    r.Set(std::string(q.first) + "_rel_error", std::abs(snapshot.getValue(q.second) - exact) / exact);
+  }
+  out.push_back(r);
+}
+
+Suite accuracy("accuracy", [](const Options&, std::vector<Record>& out) {
+  auto values = HeavyTailed();
+  auto sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  Measure<stats::CKMSSample>("ckms", [] { return new stats::CKMSSample(); }, values, sorted, out);
+  Measure<stats::CKMSSample>("ckms/tail", [] {
+    return new stats::CKMSSample(std::chrono::seconds(30),
+        {{0.5, 0.01}, {0.99, 0.001}, {0.999, 0.0001}, {0.9999, 0.00001}});
+  }, values, sorted, out);
+  Measure<stats::DDSketchSample>("ddsketch", [] { return new stats::DDSketchSample(); },
+                                 values, sorted, out);
+  Measure<stats::TDigestSample>("tdigest/100", [] { return new stats::TDigestSample(); },
+                                values, sorted, out);
+  Measure<stats::TDigestSample>("tdigest/200", [] {
+    return new stats::TDigestSample(std::chrono::seconds(30), 200);
+  }, values, sorted, out);
+});
+
+} // namespace
@@ -0,0 +1,108 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// Cost of a warm restart: checkpointing a registry of 50k metrics, then
+// restoring it into a fresh one and recreating every metric, against
+// creating them with nothing to restore.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "harness.h"
+#include "medida/metrics_registry.h"
+
+using namespace medida;
+using namespace medida::bench;
+
+namespace {
+
+const int kCounters = 40000;
+const int kMeters = 5000;
+const int kTimers = 5000;
+
+MetricName Name(const char* type, int i) {
+  return {"bench", type, "metric" + std::to_string(i)};
+}
+
+// Creates every metric, as a service would on startup.
+void CreateAll(MetricsRegistry& registry) {
+  for (int i = 0; i < kCounters; i++) {
+    registry.NewCounter(Name("counter", i));
+  }
+  for (int i = 0; i < kMeters; i++) {
+    registry.NewMeter(Name("meter", i), "events");
+  }
+  for (int i = 0; i < kTimers; i++) {
+    registry.NewTimer(Name("timer", i));
+  }
+}
+
+double MillisSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+Suite checkpoint("checkpoint", [](const Options&, std::vector<Record>& out) {
+  auto path = "/tmp/medida-bench-checkpoint-" + std::to_string(getpid());
+  {
+    MetricsRegistry registry;
+    CreateAll(registry);
+    for (int i = 0; i < kCounters; i++) {
+      registry.NewCounter(Name("counter", i)).inc(i);
+    }
+    for (int i = 0; i < kMeters; i++) {
+      registry.NewMeter(Name("meter", i), "events").Mark(i);
+    }
+    for (int i = 0; i < kTimers; i++) {
+      auto& timer = registry.NewTimer(Name("timer", i));
+      for (int j = 0; j < 20; j++) {
+        timer.Update(std::chrono::microseconds(100 * (i + j)));
+      }
+    }
+    auto start = std::chrono::steady_clock::now();
+    registry.Checkpoint(path);
+    auto ms = MillisSince(start);
+    struct stat st;
+    stat(path.c_str(), &st);
+    Record r;
+    r.Set("suite", "checkpoint")
+     .Set("name", "checkpoint")
+     .Set("metrics", kCounters + kMeters + kTimers)
+     .Set("ms", ms)
+     .Set("file_bytes", static_cast<double>(st.st_size));
+    out.push_back(r);
+  }
+
+  double cold_ms;
+  {
+    MetricsRegistry registry;
+    auto start = std::chrono::steady_clock::now();
+    CreateAll(registry);
+    cold_ms = MillisSince(start);
+  }
+  {
+    MetricsRegistry registry;
+    auto start = std::chrono::steady_clock::now();
+    auto restored = registry.Restore(path);
+    auto restore_ms = MillisSince(start);
+    CreateAll(registry);
+    auto total_ms = MillisSince(start);
+    Record r;
+    r.Set("suite", "checkpoint")
+     .Set("name", "restore")
+     .Set("metrics", static_cast<double>(restored))
+     .Set("restore_ms", restore_ms)
+     .Set("restore_and_create_ms", total_ms)
+     .Set("create_only_ms", cold_ms);
+    out.push_back(r);
+  }
+  std::remove(path.c_str());
+});
+
+} // namespace
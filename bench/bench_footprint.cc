@@ -0,0 +1,145 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// Heap footprint of each metric type, idle and after it has seen traffic.
+//
+// The global allocation functions are replaced for this binary so that
+// every allocation, including those made inside libmedida, is counted.
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "harness.h"
+#include "medida/buckets.h"
+#include "medida/counter.h"
+#include "medida/histogram.h"
+#include "medida/meter.h"
+#include "medida/timer.h"
+
+namespace {
+
+std::atomic<std::int64_t> live_bytes {0};
+
+// Every block carries its size in a header that keeps max_align_t
+// alignment for the caller.
+const std::size_t kHeader = alignof(std::max_align_t) < 16 ? 16 : alignof(std::max_align_t);
+
+void* Allocate(std::size_t size) {
+  auto block = static_cast<char*>(std::malloc(size + kHeader));
+  if (!block) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t*>(block) = size;
+  live_bytes.fetch_add(size, std::memory_order_relaxed);
+  return block + kHeader;
+}
+
+void Deallocate(void* p) {
+  if (p) {
+    auto block = static_cast<char*>(p) - kHeader;
+    live_bytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+  }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try { return Allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  try { return Allocate(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { Deallocate(p); }
+void operator delete[](void* p) noexcept { Deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Deallocate(p); }
+
+using namespace medida;
+using namespace medida::bench;
+
+std::int64_t medida::bench::LiveHeapBytes() {
+  return live_bytes.load();
+}
+
+namespace {
+
+const int kMetrics = 1000;
+const int kUpdatesPerMetric = 1000;
+
+struct Kind {
+  const char* name;
+  std::function<std::shared_ptr<void>()> make;
+  std::function<void(void*, std::int64_t)> update;
+};
+
+template <typename T>
+std::function<void(void*, std::int64_t)> Updater(std::function<void(T&, std::int64_t)> f) {
+  return [f](void* p, std::int64_t v) { f(*static_cast<T*>(p), v); };
+}
+
+std::shared_ptr<void> MakeHistogram(SamplingInterface::SampleType type) {
+  return std::make_shared<Histogram>(type);
+}
+
+void Measure(const Kind& kind, std::vector<Record>& out) {
+  std::vector<std::shared_ptr<void>> metrics;
+  metrics.reserve(kMetrics);
+  auto before = live_bytes.load();
+  for (int i = 0; i < kMetrics; i++) {
+    metrics.push_back(kind.make());
+  }
+  auto idle = live_bytes.load();
+  for (auto& m : metrics) {
+    for (int i = 1; i <= kUpdatesPerMetric; i++) {
+      kind.update(m.get(), i);
+    }
+  }
+  auto active = live_bytes.load();
+  Record r;
+  r.Set("suite", "footprint")
+   .Set("name", kind.name)
+   .Set("idle_bytes", double(idle - before) / kMetrics)
+   .Set("active_bytes", double(active - before) / kMetrics)
+   .Set("updates_per_metric", kUpdatesPerMetric);
+  out.push_back(r);
+}
+
+Suite footprint("footprint", [](const Options&, std::vector<Record>& out) {
+  std::vector<Kind> kinds = {
+    {"counter", [] { return std::make_shared<Counter>(); },
+     Updater<Counter>([](Counter& c, std::int64_t v) { c.inc(v); })},
+    {"meter", [] { return std::make_shared<Meter>("events"); },
+     Updater<Meter>([](Meter& m, std::int64_t) { m.Mark(); })},
+    {"histogram/ckms", [] { return MakeHistogram(SamplingInterface::kCKMS); },
+     Updater<Histogram>([](Histogram& h, std::int64_t v) { h.Update(v); })},
+    {"histogram/ddsketch", [] { return MakeHistogram(SamplingInterface::kDDSketch); },
+     Updater<Histogram>([](Histogram& h, std::int64_t v) { h.Update(v); })},
+    {"histogram/tdigest", [] { return MakeHistogram(SamplingInterface::kTDigest); },
+     Updater<Histogram>([](Histogram& h, std::int64_t v) { h.Update(v); })},
+    {"histogram/uniform", [] { return MakeHistogram(SamplingInterface::kUniform); },
+     Updater<Histogram>([](Histogram& h, std::int64_t v) { h.Update(v); })},
+    {"histogram/biased", [] { return MakeHistogram(SamplingInterface::kBiased); },
+     Updater<Histogram>([](Histogram& h, std::int64_t v) { h.Update(v); })},
+    {"histogram/sliding", [] { return MakeHistogram(SamplingInterface::kSliding); },
+     Updater<Histogram>([](Histogram& h, std::int64_t v) { h.Update(v); })},
+    {"timer", [] { return std::make_shared<Timer>(); },
+     Updater<Timer>([](Timer& t, std::int64_t v) { t.Update(std::chrono::microseconds(v)); })},
+    {"buckets", [] {
+       return std::make_shared<Buckets>(std::set<double> {1, 10, 100});
+     },
+     Updater<Buckets>([](Buckets& b, std::int64_t v) { b.Update(std::chrono::microseconds(v * 100)); })},
+  };
+  for (auto& kind : kinds) {
+    Measure(kind, out);
+  }
+});
+
+} // namespace
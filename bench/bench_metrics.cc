@@ -0,0 +1,235 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// Throughput cases for the update and read paths of every metric type.
+
+#include <memory>
+
+#include "harness.h"
+#include "medida/buckets.h"
+#include "medida/counter.h"
+#include "medida/histogram.h"
+#include "medida/meter.h"
+#include "medida/stats/ckms_sample.h"
+#include "medida/stats/exp_decay_sample.h"
+#include "medida/stats/sliding_window_sample.h"
+#include "medida/stats/uniform_sample.h"
+#include "medida/stats/windowed_sketch_sample.h"
+#include "medida/timer.h"
+
+using namespace medida;
+using namespace medida::bench;
+
+namespace {
+
+// A cheap, well-spread input value in [1, 100000] for iteration i, so
+// histograms see a realistic spread rather than one repeated value.
+std::int64_t Value(std::uint64_t i) {
+  return static_cast<std::int64_t>((i * 2654435761u) % 100000) + 1;
+}
+
+// Fills a histogram with enough values that its snapshots do real work.
+std::shared_ptr<Histogram> FilledHistogram(SamplingInterface::SampleType type) {
+  auto h = std::make_shared<Histogram>(type);
+  for (std::uint64_t i = 0; i < 100000; i++) {
+    h->Update(Value(i));
+  }
+  return h;
+}
+
+void ReadQuantiles(const stats::Snapshot& s) {
+  volatile double sink = s.getMedian() + s.get75thPercentile() +
+      s.get95thPercentile() + s.get98thPercentile() +
+      s.get99thPercentile() + s.get999thPercentile() + s.max();
+  (void)sink;
+}
+
+ThroughputCase counter_inc("counter_inc", [] {
+  auto c = std::make_shared<Counter>();
+  return [c](std::uint64_t) { c->inc(); };
+});
+
+ThroughputCase meter_mark("meter_mark", [] {
+  auto m = std::make_shared<Meter>("events");
+  return [m](std::uint64_t) { m->Mark(); };
+});
+
+ThroughputCase histogram_update_ckms("histogram_update/ckms", [] {
+  auto h = std::make_shared<Histogram>(SamplingInterface::kCKMS);
+  return [h](std::uint64_t i) { h->Update(Value(i)); };
+});
+
+ThroughputCase histogram_update_ddsketch("histogram_update/ddsketch", [] {
+  auto h = std::make_shared<Histogram>(SamplingInterface::kDDSketch);
+  return [h](std::uint64_t i) { h->Update(Value(i)); };
+});
+
+ThroughputCase histogram_update_tdigest("histogram_update/tdigest", [] {
+  auto h = std::make_shared<Histogram>(SamplingInterface::kTDigest);
+  return [h](std::uint64_t i) { h->Update(Value(i)); };
+});
+
+ThroughputCase histogram_update_uniform("histogram_update/uniform", [] {
+  auto h = std::make_shared<Histogram>(SamplingInterface::kUniform);
+  return [h](std::uint64_t i) { h->Update(Value(i)); };
+});
+
+ThroughputCase histogram_update_biased("histogram_update/biased", [] {
+  auto h = std::make_shared<Histogram>(SamplingInterface::kBiased);
+  return [h](std::uint64_t i) { h->Update(Value(i)); };
+});
+
+ThroughputCase histogram_update_sliding("histogram_update/sliding", [] {
+  auto h = std::make_shared<Histogram>(SamplingInterface::kSliding);
+  return [h](std::uint64_t i) { h->Update(Value(i)); };
+});
+
+ThroughputCase histogram_create_uniform("histogram_create/uniform", [] {
+  return [](std::uint64_t) { Histogram h {SamplingInterface::kUniform}; };
+});
+
+ThroughputCase histogram_create_biased("histogram_create/biased", [] {
+  return [](std::uint64_t) { Histogram h {SamplingInterface::kBiased}; };
+});
+
+ThroughputCase histogram_create_sliding("histogram_create/sliding", [] {
+  return [](std::uint64_t) { Histogram h {SamplingInterface::kSliding}; };
+});
+
+ThroughputCase sample_update_ckms("sample_update/ckms", [] {
+  auto s = std::make_shared<stats::CKMSSample>();
+  return [s](std::uint64_t i) { s->Update(Value(i)); };
+});
+
+ThroughputCase sample_update_ckms_background("sample_update/ckms_background", [] {
+  auto s = std::make_shared<stats::CKMSSample>(std::chrono::seconds(30),
+                                               std::vector<stats::CKMS::Quantile> {}, 1, true);
+  return [s](std::uint64_t i) { s->Update(Value(i)); };
+});
+
+ThroughputCase sample_update_uniform("sample_update/uniform", [] {
+  auto s = std::make_shared<stats::UniformSample>(1028);
+  return [s](std::uint64_t i) { s->Update(Value(i)); };
+});
+
+ThroughputCase sample_update_biased("sample_update/biased", [] {
+  auto s = std::make_shared<stats::ExpDecaySample>(1028, 0.015);
+  return [s](std::uint64_t i) { s->Update(Value(i)); };
+});
+
+ThroughputCase sample_update_biased_aging("sample_update/biased_aging", [] {
+  // Time advances 100ms per update, so a steady share of updates displaces
+  // reservoir entries instead of being rejected outright, and a full run
+  // spans several hours of sample time.
+  auto s = std::make_shared<stats::ExpDecaySample>(1028, 0.015);
+  auto start = Clock::now();
+  return [s, start](std::uint64_t i) {
+    s->Update(Value(i), start + std::chrono::milliseconds(100 * i));
+  };
+});
+
+ThroughputCase sample_update_sliding("sample_update/sliding", [] {
+  auto s = std::make_shared<stats::SlidingWindowSample>(1028, std::chrono::seconds(300));
+  return [s](std::uint64_t i) { s->Update(Value(i)); };
+});
+
+ThroughputCase sample_update_sliding_advancing("sample_update/sliding_advancing", [] {
+  // One update per 300ms time slice, so every update appends a new entry
+  // and, once the window is full, retires the oldest.
+  auto s = std::make_shared<stats::SlidingWindowSample>(1028, std::chrono::seconds(300));
+  auto start = Clock::now();
+  return [s, start](std::uint64_t i) {
+    s->Update(Value(i), start + std::chrono::milliseconds(300 * i));
+  };
+});
+
+ThroughputCase timer_update("timer_update", [] {
+  auto t = std::make_shared<Timer>();
+  return [t](std::uint64_t i) { t->Update(std::chrono::nanoseconds(Value(i))); };
+});
+
+ThroughputCase timer_time_scope("timer_time_scope", [] {
+  auto t = std::make_shared<Timer>();
+  return [t](std::uint64_t) { t->TimeScope(); };
+});
+
+ThroughputCase buckets_update("buckets_update", [] {
+  // Boundaries in microseconds, spread over the range Value() produces.
+  auto b = std::make_shared<Buckets>(std::set<double> {10, 100, 1000, 10000},
+                                     std::chrono::microseconds(1));
+  return [b](std::uint64_t i) { b->Update(std::chrono::microseconds(Value(i))); };
+});
+
+ThroughputCase snapshot_ckms("snapshot/ckms", [] {
+  // CKMS reports the previous window, so feed one window and read it back
+  // from the next one.
+  auto s = std::make_shared<stats::CKMSSample>();
+  auto t = Clock::time_point();
+  for (std::uint64_t i = 0; i < 100000; i++) {
+    s->Update(Value(i), t);
+  }
+  t += std::chrono::seconds(30);
+  return [s, t](std::uint64_t) { ReadQuantiles(s->MakeSnapshot(t)); };
+});
+
+ThroughputCase snapshot_ckms_horizon("snapshot/ckms_horizon", [] {
+  // Ten 30-second windows read back as one five-minute horizon. The merge
+  // is cached until the windows rotate, so this measures the cached read.
+  auto s = std::make_shared<stats::CKMSSample>(std::chrono::seconds(30),
+                                               std::vector<stats::CKMS::Quantile> {}, 10);
+  auto t = Clock::time_point();
+  for (int w = 0; w < 10; w++) {
+    for (std::uint64_t i = 0; i < 10000; i++) {
+      s->Update(Value(i + w * 10000), t);
+    }
+    t += std::chrono::seconds(30);
+  }
+  return [s, t](std::uint64_t) {
+    ReadQuantiles(s->MakeSnapshot(std::chrono::seconds(300), t));
+  };
+});
+
+ThroughputCase snapshot_ddsketch("snapshot/ddsketch", [] {
+  auto s = std::make_shared<stats::DDSketchSample>();
+  auto t = Clock::time_point();
+  for (std::uint64_t i = 0; i < 100000; i++) {
+    s->Update(Value(i), t);
+  }
+  t += std::chrono::seconds(30);
+  return [s, t](std::uint64_t) { ReadQuantiles(s->MakeSnapshot(t)); };
+});
+
+ThroughputCase snapshot_tdigest("snapshot/tdigest", [] {
+  auto s = std::make_shared<stats::TDigestSample>();
+  auto t = Clock::time_point();
+  for (std::uint64_t i = 0; i < 100000; i++) {
+    s->Update(Value(i), t);
+  }
+  t += std::chrono::seconds(30);
+  return [s, t](std::uint64_t) { ReadQuantiles(s->MakeSnapshot(t)); };
+});
+
+ThroughputCase snapshot_uniform("snapshot/uniform", [] {
+  auto h = FilledHistogram(SamplingInterface::kUniform);
+  return [h](std::uint64_t) { ReadQuantiles(h->GetSnapshot()); };
+});
+
+ThroughputCase snapshot_biased("snapshot/biased", [] {
+  auto h = FilledHistogram(SamplingInterface::kBiased);
+  return [h](std::uint64_t) { ReadQuantiles(h->GetSnapshot()); };
+});
+
+ThroughputCase snapshot_sliding("snapshot/sliding", [] {
+  // The sliding window keeps one value per time slice, so spread the input
+  // over the whole window to fill it.
+  auto s = std::make_shared<stats::SlidingWindowSample>(1028, std::chrono::seconds(300));
+  auto t = Clock::now();
+  for (std::uint64_t i = 0; i < 100000; i++) {
+    s->Update(Value(i), t);
+    t += std::chrono::milliseconds(3);
+  }
+  return [s](std::uint64_t) { ReadQuantiles(s->MakeSnapshot()); };
+});
+
+} // namespace
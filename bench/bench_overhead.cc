@@ -0,0 +1,91 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// What instrumenting a tight loop costs over the same loop without it.
+//
+// Each call is inlined into a plain loop rather than going through a
+// ThroughputCase, whose std::function call would hide anything smaller.
+// Built with MEDIDA_DISABLE, every overhead should be zero, within noise.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "harness.h"
+#include "medida/counter.h"
+#include "medida/histogram.h"
+#include "medida/meter.h"
+#include "medida/timer.h"
+
+using namespace medida;
+using namespace medida::bench;
+
+namespace {
+
+const int kRuns = 5;
+
+#ifdef MEDIDA_DISABLE
+const bool kDisabled = true;
+#else
+const bool kDisabled = false;
+#endif
+
+// Hides `v` from the optimizer, so that neither loop can be folded away.
+inline void Opaque(std::uint64_t& v) {
+  asm volatile("" : "+r"(v));
+}
+
+// The best of several runs of `ops` calls to body, in nanoseconds per call.
+template <typename F>
+double NanosPerOp(std::uint64_t ops, F body) {
+  double best = 0;
+  for (int run = 0; run < kRuns; run++) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < ops; i++) {
+      auto v = i;
+      Opaque(v);
+      body(v);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    auto ns = elapsed.count() / ops;
+    best = run == 0 ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+template <typename F>
+void Measure(const char* name, const Options& options, double baseline, F body,
+             std::vector<Record>& out) {
+  auto ns = NanosPerOp(options.ops_per_thread, body);
+  Record r;
+  r.Set("suite", "overhead")
+   .Set("name", name)
+   .Set("disabled", kDisabled ? 1 : 0)
+   .Set("ns_per_op", ns)
+   .Set("baseline_ns_per_op", baseline)
+   .Set("overhead_ns", ns - baseline);
+  out.push_back(r);
+}
+
+Suite overhead("overhead", [](const Options& options, std::vector<Record>& out) {
+  auto baseline = NanosPerOp(options.ops_per_thread, [](std::uint64_t) {});
+  Counter counter;
+  Meter meter {"events"};
+  Histogram histogram;
+  Timer timer;
+  Measure("counter_inc", options, baseline, [&](std::uint64_t) { counter.inc(); }, out);
+  Measure("meter_mark", options, baseline, [&](std::uint64_t) { meter.Mark(); }, out);
+  Measure("histogram_update", options, baseline,
+          [&](std::uint64_t v) { histogram.Update(static_cast<std::int64_t>(v % 100000)); }, out);
+  Measure("timer_update", options, baseline,
+          [&](std::uint64_t v) { timer.Update(std::chrono::nanoseconds(v % 100000)); }, out);
+  Measure("timer_scope", options, baseline,
+          [&](std::uint64_t) {
+            auto context = timer.TimeScope();
+            (void)context;
+          }, out);
+});
+
+} // namespace
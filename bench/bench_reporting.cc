@@ -0,0 +1,66 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// Cost of reporting a sparse registry, where few of many metrics move
+// between reports, under each Temporality.
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "harness.h"
+#include "medida/metrics_registry.h"
+#include "medida/reporting/console_reporter.h"
+
+using namespace medida;
+using namespace medida::bench;
+using namespace medida::reporting;
+
+namespace {
+
+const int kCounters = 50000;
+// One in this many counters is updated between reports.
+const int kUpdateEvery = 100;
+const int kReports = 5;
+
+Suite reporting("reporting", [](const Options&, std::vector<Record>& out) {
+  MetricsRegistry registry;
+  std::vector<Counter*> counters;
+  for (int i = 0; i < kCounters; i++) {
+    counters.push_back(&registry.NewCounter({"bench", "counter", "metric" + std::to_string(i)}));
+  }
+  const std::pair<const char*, Temporality> temporalities[] = {
+    {"cumulative", Temporality::kCumulative},
+    {"changed_only", Temporality::kChangedOnly},
+    {"delta", Temporality::kDelta},
+  };
+  for (auto& t : temporalities) {
+    std::ostringstream text;
+    ConsoleReporter reporter {registry, text, t.second};
+    // The first report covers everything whatever the temporality.
+    reporter.Run();
+    double ms = 0, bytes = 0;
+    for (int r = 0; r < kReports; r++) {
+      for (int i = r; i < kCounters; i += kUpdateEvery) {
+        counters[i]->inc();
+      }
+      text.str("");
+      auto start = std::chrono::steady_clock::now();
+      reporter.Run();
+      ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      bytes += text.str().size();
+    }
+    Record rec;
+    rec.Set("suite", "reporting")
+       .Set("name", t.first)
+       .Set("metrics", kCounters)
+       .Set("updated", kCounters / kUpdateEvery)
+       .Set("ms_per_report", ms / kReports)
+       .Set("bytes_per_report", bytes / kReports);
+    out.push_back(rec);
+  }
+});
+
+} // namespace
@@ -0,0 +1,245 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "harness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace medida {
+namespace bench {
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+struct NamedCase {
+  std::string name;
+  std::function<Operation()> setup;
+};
+
+struct NamedSuite {
+  std::string name;
+  std::function<void(const Options&, std::vector<Record>&)> run;
+};
+
+// Function-local statics, so registration order across translation units
+// does not matter.
+std::vector<NamedCase>& Cases() {
+  static std::vector<NamedCase> cases;
+  return cases;
+}
+
+std::vector<NamedSuite>& Suites() {
+  static std::vector<NamedSuite> suites;
+  return suites;
+}
+
+std::string Quote(const std::string& s) {
+  std::string out = "\"";
+  for (auto c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out += buf;
+    } else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+bool Matches(const std::string& name, const Options& options) {
+  return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+std::vector<unsigned> ThreadCounts(unsigned max_threads) {
+  std::vector<unsigned> counts;
+  for (unsigned t = 1; t < max_threads; t *= 2) {
+    counts.push_back(t);
+  }
+  counts.push_back(std::max(1u, max_threads));
+  return counts;
+}
+
+// Starts `threads` threads running body(thread_index) and releases them at
+// the same moment. Returns the wall time from release until the last one
+// finished.
+BenchClock::duration RunConcurrently(unsigned threads,
+                                     const std::function<void(unsigned)>& body) {
+  std::atomic<unsigned> ready {0};
+  std::atomic<bool> go {false};
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; t++) {
+    pool.emplace_back([&, t] {
+      ready++;
+      while (!go.load()) {
+        std::this_thread::yield();
+      }
+      body(t);
+    });
+  }
+  while (ready.load() < threads) {
+    std::this_thread::yield();
+  }
+  auto start = BenchClock::now();
+  go = true;
+  for (auto& th : pool) {
+    th.join();
+  }
+  return BenchClock::now() - start;
+}
+
+Record RunCase(const NamedCase& c, unsigned threads, const Options& options) {
+  auto op = c.setup();
+
+  // Warm caches and any lazily allocated state before timing, and use the
+  // warm-up rate to keep slow cases (snapshots) within the time budget.
+  const auto kWarmupBudget = std::chrono::milliseconds(50);
+  std::uint64_t warmup = 0;
+  auto warmup_start = BenchClock::now();
+  auto warmup_elapsed = BenchClock::duration::zero();
+  while (warmup < 10000 && warmup_elapsed < kWarmupBudget) {
+    op(warmup++);
+    warmup_elapsed = BenchClock::now() - warmup_start;
+  }
+  double ns_per_op = std::chrono::duration<double, std::nano>(warmup_elapsed).count() / warmup;
+  auto budgeted = static_cast<std::uint64_t>(options.seconds_per_case * 1e9 / std::max(ns_per_op, 1.0));
+  auto ops = std::max<std::uint64_t>(100, std::min(options.ops_per_thread, budgeted));
+  auto samples = std::min(options.latency_samples, ops);
+  auto wall = RunConcurrently(threads, [&](unsigned) {
+    for (std::uint64_t i = 0; i < ops; i++) {
+      op(i);
+    }
+  });
+
+  // Per-op latency is measured in a separate pass so the clock reads do not
+  // distort the throughput figures above.
+  std::vector<std::vector<double>> latencies(threads);
+  RunConcurrently(threads, [&](unsigned t) {
+    auto& mine = latencies[t];
+    mine.reserve(samples);
+    for (std::uint64_t i = 0; i < samples; i++) {
+      auto begin = BenchClock::now();
+      op(ops + i);
+      auto end = BenchClock::now();
+      mine.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+    }
+  });
+  std::vector<double> all;
+  for (auto& l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  double p99 = 0.0;
+  if (!all.empty()) {
+    auto nth = all.begin() + static_cast<std::size_t>(0.99 * (all.size() - 1));
+    std::nth_element(all.begin(), nth, all.end());
+    p99 = *nth;
+  }
+
+  double wall_ns = std::chrono::duration<double, std::nano>(wall).count();
+  double total_ops = static_cast<double>(ops) * threads;
+  Record r;
+  r.Set("suite", "throughput")
+   .Set("name", c.name)
+   .Set("threads", threads)
+   .Set("ops", total_ops)
+   .Set("ns_per_op", wall_ns * threads / total_ops)
+   .Set("ops_per_sec", total_ops / (wall_ns / 1e9))
+   .Set("p99_ns", p99);
+  return r;
+}
+
+} // namespace
+
+
+Record& Record::Set(const std::string& key, const std::string& value) {
+  fields_.emplace_back(key, Quote(value));
+  return *this;
+}
+
+
+Record& Record::Set(const std::string& key, const char* value) {
+  return Set(key, std::string(value));
+}
+
+
+Record& Record::Set(const std::string& key, double value) {
+  std::ostringstream ss;
+  if (std::isfinite(value)) {
+    ss << std::setprecision(10) << value;
+  } else {
+    ss << "null";
+  }
+  fields_.emplace_back(key, ss.str());
+  return *this;
+}
+
+
+std::string Record::ToJson() const {
+  std::string out = "{";
+  for (auto it = fields_.begin(); it != fields_.end(); ++it) {
+    if (it != fields_.begin()) {
+      out += ",";
+    }
+    out += Quote(it->first) + ":" + it->second;
+  }
+  return out + "}";
+}
+
+
+ThroughputCase::ThroughputCase(std::string name, std::function<Operation()> setup) {
+  Cases().push_back({name, setup});
+}
+
+
+Suite::Suite(std::string name,
+             std::function<void(const Options&, std::vector<Record>&)> run) {
+  Suites().push_back({name, run});
+}
+
+
+double ClockOverheadNanos() {
+  static double overhead = [] {
+    const int kReads = 100000;
+    auto begin = BenchClock::now();
+    for (int i = 0; i < kReads; i++) {
+      BenchClock::now();
+    }
+    auto end = BenchClock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / kReads;
+  }();
+  return overhead;
+}
+
+
+std::vector<Record> RunAll(const Options& options) {
+  std::vector<Record> records;
+  for (auto& c : Cases()) {
+    if (!Matches(c.name, options)) {
+      continue;
+    }
+    for (auto threads : ThreadCounts(options.max_threads)) {
+      records.push_back(RunCase(c, threads, options));
+    }
+  }
+  for (auto& s : Suites()) {
+    if (Matches(s.name, options)) {
+      s.run(options, records);
+    }
+  }
+  return records;
+}
+
+} // namespace bench
+} // namespace medida
@@ -0,0 +1,73 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_BENCH_HARNESS_H_
+#define MEDIDA_BENCH_HARNESS_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace medida {
+namespace bench {
+
+// Knobs shared by every suite, set from the command line.
+struct Options {
+  std::uint64_t ops_per_thread = 200000;
+  std::uint64_t latency_samples = 20000;
+  // Slow cases run fewer ops so that each stays within roughly this budget.
+  double seconds_per_case = 0.25;
+  unsigned max_threads = 1;
+  std::string filter;
+};
+
+// One machine-readable result: an ordered set of named fields, written out
+// as a JSON object.
+class Record {
+ public:
+  Record& Set(const std::string& key, const std::string& value);
+  Record& Set(const std::string& key, const char* value);
+  Record& Set(const std::string& key, double value);
+  std::string ToJson() const;
+ private:
+  std::vector<std::pair<std::string, std::string>> fields_;
+};
+
+// An operation under test. It is called concurrently from every benchmark
+// thread with that thread's iteration number, which cases use to vary their
+// input values.
+using Operation = std::function<void(std::uint64_t i)>;
+
+// Throughput cases are set up once per thread count; whatever state the
+// returned operation captures is shared by all threads.
+class ThroughputCase {
+ public:
+  ThroughputCase(std::string name, std::function<Operation()> setup);
+};
+
+// Suites that measure something other than throughput (memory, accuracy)
+// append their own records.
+class Suite {
+ public:
+  Suite(std::string name,
+        std::function<void(const Options&, std::vector<Record>&)> run);
+};
+
+// Bytes the process has allocated and not yet freed. bench_footprint.cc
+// replaces the global allocation functions to keep this count.
+std::int64_t LiveHeapBytes();
+
+// Nanoseconds taken by one steady_clock read, measured once at startup and
+// included in every per-op latency.
+double ClockOverheadNanos();
+
+// Runs every registered case and suite whose name contains options.filter.
+std::vector<Record> RunAll(const Options& options);
+
+} // namespace bench
+} // namespace medida
+
+#endif // MEDIDA_BENCH_HARNESS_H_
@@ -0,0 +1,95 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// medida-bench: micro-benchmarks for the metric hot paths.
+//
+// Every throughput case runs at 1, 2, 4, ... up to --threads threads and
+// reports ns/op, ops/s and the p99 latency of a single op. Results are
+// written as one JSON document so they can be tracked across releases:
+//
+//   medida-bench [--threads=N] [--ops=N] [--latency-samples=N]
+//                [--seconds=S] [--filter=SUBSTRING] [--out=PATH]
+//
+// --ops caps the ops per thread; slow cases run fewer so that each case
+// takes about --seconds per thread count.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "harness.h"
+
+using namespace medida::bench;
+
+namespace {
+
+bool ParseFlag(const char* arg, const char* name, std::string& value) {
+  auto len = strlen(name);
+  if (strncmp(arg, name, len) == 0 && arg[len] == '=') {
+    value = arg + len + 1;
+    return true;
+  }
+  return false;
+}
+
+void Usage(const char* argv0) {
+  std::cerr << "usage: " << argv0
+            << " [--threads=N] [--ops=N] [--latency-samples=N]"
+            << " [--seconds=S] [--filter=SUBSTRING] [--out=PATH]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  options.max_threads = std::max(1u, std::thread::hardware_concurrency());
+  std::string out_path;
+  for (int i = 1; i < argc; i++) {
+    std::string value;
+    if (ParseFlag(argv[i], "--threads", value)) {
+      options.max_threads = std::max(1, atoi(value.c_str()));
+    } else if (ParseFlag(argv[i], "--ops", value)) {
+      options.ops_per_thread = strtoull(value.c_str(), nullptr, 10);
+    } else if (ParseFlag(argv[i], "--latency-samples", value)) {
+      options.latency_samples = strtoull(value.c_str(), nullptr, 10);
+    } else if (ParseFlag(argv[i], "--seconds", value)) {
+      options.seconds_per_case = atof(value.c_str());
+    } else if (ParseFlag(argv[i], "--filter", value)) {
+      options.filter = value;
+    } else if (ParseFlag(argv[i], "--out", value)) {
+      out_path = value;
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  auto records = RunAll(options);
+
+  std::ofstream file;
+  if (!out_path.empty()) {
+    file.open(out_path);
+    if (!file) {
+      std::cerr << "cannot open " << out_path << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = out_path.empty() ? std::cout : file;
+  Record header;
+  header.Set("medida_version", MEDIDA_VERSION)
+        .Set("hardware_threads", std::thread::hardware_concurrency())
+        .Set("clock_overhead_ns", ClockOverheadNanos());
+  auto doc = header.ToJson();
+  doc.pop_back();
+  out << doc << ",\"results\":[" << std::endl;
+  for (std::size_t i = 0; i < records.size(); i++) {
+    out << records[i].ToJson() << (i + 1 < records.size() ? "," : "") << std::endl;
+  }
+  out << "]}" << std::endl;
+  return 0;
+}
@@ -5,8 +5,10 @@
 #include "medida/buckets.h"
 #include "medida/timer.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <stdexcept>
 
 namespace medida
 {
@@ -52,6 +54,28 @@ class Buckets::Impl
         it->second->Update(value);
     }
 
+    void
+    MergeFrom(Impl const& other)
+    {
+        if (mDurationUnit != other.mDurationUnit ||
+            mBuckets.size() != other.mBuckets.size() ||
+            !std::equal(mBuckets.begin(), mBuckets.end(),
+                        other.mBuckets.begin(),
+                        [](std::pair<const double, std::shared_ptr<Timer>> const& a,
+                           std::pair<const double, std::shared_ptr<Timer>> const& b) {
+                            return a.first == b.first;
+                        }))
+        {
+            throw std::invalid_argument(
+                "can only merge buckets with the same boundaries");
+        }
+        auto theirs = other.mBuckets.begin();
+        for (auto& kv: mBuckets)
+        {
+            kv.second->MergeFrom(*(theirs++)->second);
+        }
+    }
+
     void Clear()
     {
         for (auto kv: mBuckets)
@@ -94,12 +118,21 @@ Buckets::boundary_unit() const
 void
 Buckets::Update(std::chrono::nanoseconds value)
 {
+    Touch();
     impl_->Update(value);
 }
 
+void
+Buckets::MergeFrom(Buckets const& other)
+{
+    Touch();
+    impl_->MergeFrom(*other.impl_);
+}
+
 void
 Buckets::Clear()
 {
+    Touch();
     impl_->Clear();
 }
 
@@ -32,6 +32,9 @@ class Buckets : public MetricInterface
 
    std::chrono::nanoseconds boundary_unit() const;
    void Update(std::chrono::nanoseconds value);
+   // Merges the other's buckets pairwise. Both must have the same
+   // boundaries and unit; otherwise std::invalid_argument is thrown.
+   void MergeFrom(Buckets const& other);
    void Clear();
  private:
   class Impl;
@@ -5,28 +5,62 @@
 #ifndef MEDIDA_COUNTER_H_
 #define MEDIDA_COUNTER_H_
 
+#include <atomic>
 #include <cstdint>
-#include <memory>
 
+#include "medida/disable.h"
 #include "medida/metric_interface.h"
 
 namespace medida {
 
+#ifndef MEDIDA_DISABLE
+
+// The count is held inline rather than behind a pimpl so that updates
+// compile to an atomic add in the caller, with no call into the library.
 class Counter : public MetricInterface {
  public:
   Counter(std::int64_t init = 0);
   ~Counter();
   void Process(MetricProcessor& processor);
-  std::int64_t count() const;
-  void set_count(std::int64_t n);
-  void inc(std::int64_t n = 1);
-  void dec(std::int64_t n = 1);
+  std::int64_t count() const {
+    return count_.load();
+  }
+  void set_count(std::int64_t n) {
+    Touch();
+    count_ = n;
+  }
+  void inc(std::int64_t n = 1) {
+    Touch();
+    count_.fetch_add(n, std::memory_order_relaxed);
+  }
+  void dec(std::int64_t n = 1) {
+    Touch();
+    count_.fetch_sub(n, std::memory_order_relaxed);
+  }
   void clear();
  private:
-  class Impl;
-  std::unique_ptr<Impl> impl_;
+  std::atomic<std::int64_t> count_;
 };
 
+#else
+
+MEDIDA_BEGIN_DISABLED
+
+class Counter : public MetricInterface {
+ public:
+  Counter(std::int64_t = 0) {}
+  void Process(MetricProcessor& processor) { processor.Process(*this); }
+  std::int64_t count() const { return 0; }
+  void set_count(std::int64_t) {}
+  void inc(std::int64_t = 1) {}
+  void dec(std::int64_t = 1) {}
+  void clear() {}
+};
+
+MEDIDA_END_DISABLED
+
+#endif // MEDIDA_DISABLE
+
 } // namespace medida
 
 #endif // MEDIDA_COUNTER_H_
@@ -0,0 +1,25 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_DISABLE_H_
+#define MEDIDA_DISABLE_H_
+
+// Building with MEDIDA_DISABLE defined (the MEDIDA_DISABLE CMake option)
+// replaces Counter, Meter, Histogram, Timer and TimerContext with
+// header-only types that have the same API but do nothing: updates are
+// empty inline functions the compiler drops, and reads return 0. The
+// registry and reporters still work, and report zeros.
+//
+// The no-op types live in the inline namespace medida::disabled, so code
+// built with the macro fails to link against a library built without it,
+// and vice versa, instead of silently mixing the two.
+#ifdef MEDIDA_DISABLE
+#define MEDIDA_BEGIN_DISABLED inline namespace disabled {
+#define MEDIDA_END_DISABLED }
+#else
+#define MEDIDA_BEGIN_DISABLED
+#define MEDIDA_END_DISABLED
+#endif
+
+#endif // MEDIDA_DISABLE_H_
@@ -0,0 +1,149 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_ENCODING_H_
+#define MEDIDA_ENCODING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace medida {
+namespace encoding {
+
+// The fixed-width, little-endian encoding that serialized sketches and
+// registry checkpoints are written in. Internal to the library.
+
+inline void PutU32(std::string& out, std::uint32_t value) {
+  char bytes[4];
+  for (int i = 0; i < 4; i++) {
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+  out.append(bytes, sizeof(bytes));
+}
+
+
+inline void PutU64(std::string& out, std::uint64_t value) {
+  char bytes[8];
+  for (int i = 0; i < 8; i++) {
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+  out.append(bytes, sizeof(bytes));
+}
+
+
+inline void PutI64(std::string& out, std::int64_t value) {
+  PutU64(out, static_cast<std::uint64_t>(value));
+}
+
+
+inline void PutDouble(std::string& out, double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  PutU64(out, bits);
+}
+
+
+// A length, then the bytes.
+inline void PutBytes(std::string& out, const std::string& bytes) {
+  PutU32(out, static_cast<std::uint32_t>(bytes.size()));
+  out.append(bytes);
+}
+
+
+// Reads back what the Put functions wrote. Every read throws
+// std::invalid_argument, naming `what`, if it would run past the end.
+class Reader {
+ public:
+  Reader(const char* data, std::size_t size, const char* what)
+      : pos_ {reinterpret_cast<const unsigned char*>(data)},
+        end_ {pos_ + size},
+        what_ {what} {
+  }
+
+  Reader(const std::string& bytes, const char* what)
+      : Reader(bytes.data(), bytes.size(), what) {
+  }
+
+  std::uint32_t GetU32() {
+    Need(4);
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+      value |= static_cast<std::uint32_t>(pos_[i]) << (8 * i);
+    }
+    pos_ += 4;
+    return value;
+  }
+
+  std::uint64_t GetU64() {
+    Need(8);
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+      value |= static_cast<std::uint64_t>(pos_[i]) << (8 * i);
+    }
+    pos_ += 8;
+    return value;
+  }
+
+  std::int64_t GetI64() {
+    return static_cast<std::int64_t>(GetU64());
+  }
+
+  double GetDouble() {
+    auto bits = GetU64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  std::string GetBytes() {
+    auto size = GetU32();
+    Need(size);
+    std::string bytes(reinterpret_cast<const char*>(pos_), size);
+    pos_ += size;
+    return bytes;
+  }
+
+  // Checks that `size` bytes of magic come next, and skips them.
+  bool Expect(const char* magic, std::size_t size) {
+    if (remaining() < size || std::memcmp(pos_, magic, size) != 0) {
+      return false;
+    }
+    pos_ += size;
+    return true;
+  }
+
+  std::size_t remaining() const {
+    return end_ - pos_;
+  }
+
+  // Throws unless everything has been read.
+  void Finish() const {
+    if (pos_ != end_) {
+      Malformed();
+    }
+  }
+
+  [[noreturn]] void Malformed() const {
+    throw std::invalid_argument(std::string("malformed ") + what_);
+  }
+
+ private:
+  void Need(std::size_t size) const {
+    if (remaining() < size) {
+      throw std::invalid_argument(std::string("truncated ") + what_);
+    }
+  }
+
+  const unsigned char* pos_;
+  const unsigned char* end_;
+  const char* what_;
+};
+
+} // namespace encoding
+} // namespace medida
+
+#endif // MEDIDA_ENCODING_H_
@@ -0,0 +1,106 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/gauge.h"
+
+#include <atomic>
+#include <stdexcept>
+
+namespace medida {
+
+class Gauge::Impl {
+ public:
+  Impl(std::function<double()> callback);
+  Impl(double init);
+  ~Impl();
+  double value() const;
+  void set_value(double value);
+  bool is_callback() const;
+ private:
+  const std::function<double()> callback_;
+  std::atomic<double> value_;
+};
+
+
+Gauge::Gauge(std::function<double()> callback)
+    : impl_ {new Gauge::Impl {callback}} {
+}
+
+
+Gauge::Gauge(double init)
+    : impl_ {new Gauge::Impl {init}} {
+}
+
+
+Gauge::~Gauge() {
+}
+
+
+void Gauge::Process(MetricProcessor& processor) {
+  processor.Process(*this);
+}
+
+
+double Gauge::value() {
+  if (impl_->is_callback()) {
+    Touch();
+  }
+  return impl_->value();
+}
+
+
+void Gauge::set_value(double value) {
+  Touch();
+  impl_->set_value(value);
+}
+
+
+bool Gauge::is_callback() const {
+  return impl_->is_callback();
+}
+
+
+// === Implementation ===
+
+
+Gauge::Impl::Impl(std::function<double()> callback)
+    : callback_ (callback),
+      value_    (0.0) {
+  if (!callback_) {
+    throw std::invalid_argument("Gauge callback is empty");
+  }
+}
+
+
+Gauge::Impl::Impl(double init)
+    : value_ (init) {
+}
+
+
+Gauge::Impl::~Impl() {
+}
+
+
+double Gauge::Impl::value() const {
+  if (callback_) {
+    return callback_();
+  }
+  return value_.load(std::memory_order_relaxed);
+}
+
+
+void Gauge::Impl::set_value(double value) {
+  if (callback_) {
+    throw std::logic_error("Cannot set the value of a callback Gauge");
+  }
+  value_.store(value, std::memory_order_relaxed);
+}
+
+
+bool Gauge::Impl::is_callback() const {
+  return static_cast<bool>(callback_);
+}
+
+
+} // namespace medida
@@ -0,0 +1,43 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_GAUGE_H_
+#define MEDIDA_GAUGE_H_
+
+#include <functional>
+#include <memory>
+
+#include "medida/metric_interface.h"
+
+namespace medida {
+
+// A Gauge reports an instantaneous value, such as a queue depth or a cache
+// size. It comes in two flavours:
+//
+// - A callback gauge calls its function each time value() is read, which
+//   normally means once per reporter pass, so the code that owns the value
+//   pays nothing between reports. The callback runs on the reporter's
+//   thread and must stay valid until the gauge is removed from its registry.
+//   A callback gauge counts as updated whenever it is read, so idle-metric
+//   sweeping never evicts it.
+//
+// - A settable gauge holds the last value passed to set_value().
+class Gauge : public MetricInterface {
+ public:
+  explicit Gauge(std::function<double()> callback);
+  explicit Gauge(double init = 0.0);
+  ~Gauge();
+  void Process(MetricProcessor& processor);
+  double value();
+  // Throws std::logic_error on a callback gauge.
+  void set_value(double value);
+  bool is_callback() const;
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace medida
+
+#endif // MEDIDA_GAUGE_H_
@@ -7,11 +7,14 @@
 #include <cmath>
 #include <mutex>
 #include <algorithm>
+#include <stdexcept>
 
 #include "medida/stats/exp_decay_sample.h"
 #include "medida/stats/uniform_sample.h"
 #include "medida/stats/sliding_window_sample.h"
 #include "medida/stats/ckms_sample.h"
+#include "medida/stats/windowed_sketch_sample.h"
+#include "medida/encoding.h"
 
 namespace medida {
 
@@ -21,17 +24,29 @@ static const double kDefaultAlpha = 0.015;
 // limit by stochastic rate-limiting of additions.
 static const std::chrono::seconds kDefaultWindowTime = std::chrono::seconds(5 * 60);
 
+static const double kDefaultQuantiles[] = {0.5, 0.75, 0.95, 0.98, 0.99, 0.999};
+
+static const char kMagic[] = {'H', 'S', 'T', '1'};
+
 class Histogram::Impl {
  public:
-  Impl(SampleType sample_type = kCKMS, std::chrono::seconds ckms_window_size = std::chrono::seconds(30));
+  Impl(SampleType sample_type, std::chrono::seconds ckms_window_size,
+       const std::vector<stats::CKMS::Quantile>& quantiles, std::size_t ckms_windows,
+       bool ckms_background_compaction);
   ~Impl();
   stats::Snapshot GetSnapshot(uint64_t divisor) const;
+  stats::Snapshot GetSnapshot(std::chrono::seconds horizon, uint64_t divisor) const;
+  std::vector<double> quantiles() const;
+  bool windowed() const;
   double sum() const;
   double max() const;
   double min() const;
   double mean() const;
   double std_dev() const;
   void Update(std::int64_t value);
+  void MergeFrom(const Impl& other);
+  std::string SaveState() const;
+  void RestoreState(const std::string& state, Clock::duration idle);
   std::uint64_t count() const;
   double variance() const;
   void Process(MetricProcessor& processor);
@@ -39,6 +54,10 @@ class Histogram::Impl {
  private:
   static const std::uint64_t kDefaultSampleSize = 1028;
   std::unique_ptr<stats::Sample> sample_;
+  // sample_, when it is a CKMSSample.
+  stats::CKMSSample* ckms_;
+  std::vector<double> quantiles_;
+  bool const windowed_;
   double min_;
   double max_;
   double sum_;
@@ -46,12 +65,18 @@ class Histogram::Impl {
   double variance_m_;
   double variance_s_;
   mutable std::mutex mutex_;
+  // Folds in the summary statistics of n other values.
+  void Combine(std::uint64_t n, double min, double max, double sum, double m, double s);
 };
 
 
 
-Histogram::Histogram(SampleType sample_type, std::chrono::seconds ckms_window_size)
-    : impl_ {new Histogram::Impl {sample_type, ckms_window_size}} {
+Histogram::Histogram(SampleType sample_type, std::chrono::seconds ckms_window_size,
+                     const std::vector<stats::CKMS::Quantile>& quantiles,
+                     std::size_t ckms_windows,
+                     bool ckms_background_compaction)
+    : impl_ {new Histogram::Impl {sample_type, ckms_window_size, quantiles, ckms_windows,
+                                  ckms_background_compaction}} {
 }
 
 
@@ -65,6 +90,7 @@ void Histogram::Process(MetricProcessor& processor) {
 
 
 void Histogram::Clear() {
+  Touch();
   impl_->Clear();
 }
 
@@ -100,9 +126,24 @@ double Histogram::std_dev() const {
 
 
 void Histogram::Update(std::int64_t value) {
+  Touch();
   impl_->Update(value);
 }
 
+void Histogram::MergeFrom(const Histogram& other) {
+  Touch();
+  impl_->MergeFrom(*other.impl_);
+}
+
+std::string Histogram::SaveState() const {
+  return impl_->SaveState();
+}
+
+void Histogram::RestoreState(const std::string& state, Clock::duration idle) {
+  Touch();
+  impl_->RestoreState(state, idle);
+}
+
 stats::Snapshot Histogram::GetSnapshot() const {
   // We pass 1 here as dividing metrics by 1 changes nothing!
   return GetSnapshot(1);
@@ -112,6 +153,19 @@ stats::Snapshot Histogram::GetSnapshot(uint64_t divisor) const {
   return impl_->GetSnapshot(divisor);
 }
 
+stats::Snapshot Histogram::GetSnapshot(std::chrono::seconds horizon, uint64_t divisor) const {
+  return impl_->GetSnapshot(horizon, divisor);
+}
+
+std::vector<double> Histogram::quantiles() const {
+  return impl_->quantiles();
+}
+
+
+bool Histogram::windowed() const {
+  return impl_->windowed();
+}
+
 double Histogram::variance() const {
   return impl_->variance();
 }
@@ -120,7 +174,24 @@ double Histogram::variance() const {
 // === Implementation ===
 
 
-Histogram::Impl::Impl(SampleType sample_type, std::chrono::seconds ckms_window_size) {
+Histogram::Impl::Impl(SampleType sample_type, std::chrono::seconds ckms_window_size,
+                      const std::vector<stats::CKMS::Quantile>& quantiles,
+                      std::size_t ckms_windows,
+                      bool ckms_background_compaction)
+    : ckms_ {nullptr},
+      windowed_ {sample_type == kCKMS || sample_type == kDDSketch || sample_type == kTDigest} {
+  for (auto& q : quantiles) {
+    if (!(q.quantile > 0.0 && q.quantile < 1.0) || !(q.error >= 0.0 && q.error < 1.0)) {
+      throw std::invalid_argument("quantile targets must lie in (0, 1) with errors in [0, 1)");
+    }
+    quantiles_.push_back(q.quantile);
+  }
+  if (quantiles_.empty()) {
+    quantiles_.assign(std::begin(kDefaultQuantiles), std::end(kDefaultQuantiles));
+  }
+  std::sort(quantiles_.begin(), quantiles_.end());
+  quantiles_.erase(std::unique(quantiles_.begin(), quantiles_.end()), quantiles_.end());
+
   if (sample_type == kUniform) {
     sample_ = std::unique_ptr<stats::Sample>(new stats::UniformSample(kDefaultSampleSize));
   } else if (sample_type == kBiased) {
@@ -129,7 +200,13 @@ Histogram::Impl::Impl(SampleType sample_type, std::chrono::seconds ckms_window_s
     sample_ = std::unique_ptr<stats::Sample>(new stats::SlidingWindowSample(kDefaultSampleSize,
                                                                             kDefaultWindowTime));
   } else if (sample_type == kCKMS) {
-    sample_ = std::unique_ptr<stats::Sample>(new stats::CKMSSample(ckms_window_size));
+    ckms_ = new stats::CKMSSample(ckms_window_size, quantiles, ckms_windows,
+                                  ckms_background_compaction);
+    sample_ = std::unique_ptr<stats::Sample>(ckms_);
+  } else if (sample_type == kDDSketch) {
+    sample_ = std::unique_ptr<stats::Sample>(new stats::DDSketchSample(ckms_window_size));
+  } else if (sample_type == kTDigest) {
+    sample_ = std::unique_ptr<stats::Sample>(new stats::TDigestSample(ckms_window_size));
   } else {
       throw std::invalid_argument("invalid sample_type");
   }
@@ -216,6 +293,24 @@ stats::Snapshot Histogram::Impl::GetSnapshot(uint64_t divisor) const {
 }
 
 
+stats::Snapshot Histogram::Impl::GetSnapshot(std::chrono::seconds horizon, uint64_t divisor) const {
+  if (ckms_) {
+    return ckms_->MakeSnapshot(horizon, divisor);
+  }
+  return sample_->MakeSnapshot(divisor);
+}
+
+
+std::vector<double> Histogram::Impl::quantiles() const {
+  return quantiles_;
+}
+
+
+bool Histogram::Impl::windowed() const {
+  return windowed_;
+}
+
+
 void Histogram::Impl::Update(std::int64_t value) {
   sample_->Update(value);
   std::lock_guard<std::mutex> lock {mutex_};
@@ -240,4 +335,87 @@ void Histogram::Impl::Update(std::int64_t value) {
 }
 
 
+void Histogram::Impl::MergeFrom(const Impl& other) {
+  sample_->Merge(*other.sample_);
+  double min, max, sum, m, s;
+  std::uint64_t n;
+  {
+    std::lock_guard<std::mutex> lock {other.mutex_};
+    min = other.min_;
+    max = other.max_;
+    sum = other.sum_;
+    m = other.variance_m_;
+    s = other.variance_s_;
+    n = other.count_;
+  }
+  Combine(n, min, max, sum, m, s);
+}
+
+
+std::string Histogram::Impl::SaveState() const {
+  std::string out(kMagic, sizeof(kMagic));
+  {
+    std::lock_guard<std::mutex> lock {mutex_};
+    encoding::PutU64(out, count_);
+    encoding::PutDouble(out, min_);
+    encoding::PutDouble(out, max_);
+    encoding::PutDouble(out, sum_);
+    encoding::PutDouble(out, variance_m_);
+    encoding::PutDouble(out, variance_s_);
+  }
+  encoding::PutBytes(out, sample_->SaveState());
+  return out;
+}
+
+
+void Histogram::Impl::RestoreState(const std::string& state, Clock::duration idle) {
+  encoding::Reader in {state, "histogram state"};
+  if (!in.Expect(kMagic, sizeof(kMagic))) {
+    throw std::invalid_argument("not a saved histogram");
+  }
+  auto n = in.GetU64();
+  auto min = in.GetDouble();
+  auto max = in.GetDouble();
+  auto sum = in.GetDouble();
+  auto m = in.GetDouble();
+  auto s = in.GetDouble();
+  auto sample = in.GetBytes();
+  in.Finish();
+  if (!sample.empty()) {
+    try {
+      sample_->RestoreState(sample, idle);
+    } catch (const stats::IncompatibleState&) {
+      // Saved by another type of sample, or one with other windows; the
+      // summary statistics are still good. A malformed one is not.
+    }
+  }
+  Combine(n, min, max, sum, m, s);
+}
+
+
+void Histogram::Impl::Combine(std::uint64_t n, double min, double max, double sum,
+                              double m, double s) {
+  if (n == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock {mutex_};
+  if (count_ > 0) {
+    max_ = std::max(max_, max);
+    min_ = std::min(min_, min);
+  } else {
+    max_ = max;
+    min_ = min;
+  }
+  sum_ += sum;
+  // Chan et al.'s pairwise combination of the running means and sums of
+  // squared deviations.
+  double na = (double)count_;
+  double nb = (double)n;
+  double delta = m - variance_m_;
+  variance_m_ += delta * nb / (na + nb);
+  variance_s_ += s + delta * delta * na * nb / (na + nb);
+  count_ += n;
+}
+
+
 } // namespace medida
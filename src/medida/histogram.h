@@ -8,18 +8,40 @@
 #include <cstdint>
 #include <memory>
 #include <chrono>
+#include <string>
+#include <vector>
 
+#include "medida/disable.h"
 #include "medida/metric_interface.h"
 #include "medida/sampling_interface.h"
 #include "medida/summarizable_interface.h"
+#include "medida/types.h"
+#include "medida/stats/ckms.h"
 #include "medida/stats/sample.h"
 
 namespace medida {
 
+#ifndef MEDIDA_DISABLE
+
 class Histogram : public MetricInterface, SamplingInterface, SummarizableInterface {
  public:
+  // `quantiles` lists the quantiles to report, each with the rank error a
+  // CKMS sample may make for it; sample types that keep exact values
+  // ignore the error. Quantiles must lie in (0, 1) and errors in [0, 1).
+  // An empty list reports the median, p75, p95, p98, p99 and p99.9, with
+  // CKMS targeting only the median and p99 to within 0.001.
+  //
+  // A CKMS histogram keeps `ckms_windows` completed windows, which bounds
+  // the horizon GetSnapshot can report over, and compresses them off the
+  // update path if `ckms_background_compaction` is set (see CKMSSample).
+  // DDSketch and t-digest histograms use windows of `ckms_window_size` too.
+  // DDSketch reports any quantile to within 1% of its value; t-digest is
+  // most accurate in the tails.
   Histogram(SampleType sample_type = kCKMS,
-            std::chrono::seconds ckms_window_size = std::chrono::seconds(30));
+            std::chrono::seconds ckms_window_size = std::chrono::seconds(30),
+            const std::vector<stats::CKMS::Quantile>& quantiles = {},
+            std::size_t ckms_windows = 1,
+            bool ckms_background_compaction = false);
   ~Histogram();
   virtual stats::Snapshot GetSnapshot() const override;
 
@@ -30,12 +52,38 @@ class Histogram : public MetricInterface, SamplingInterface, SummarizableInterfa
   // and ask for metrics in microseconds in order to prevent
   // small samples from being ignored as rounding errors.
   virtual stats::Snapshot GetSnapshot(uint64_t divisor) const;
+
+  // Reports the completed CKMS windows covering the last `horizon`. Other
+  // sample types have no notion of a horizon and ignore it.
+  virtual stats::Snapshot GetSnapshot(std::chrono::seconds horizon,
+                                      uint64_t divisor = 1) const;
+  virtual std::vector<double> quantiles() const override;
+  virtual bool windowed() const override;
+  // The sum, max, min, mean and standard deviation below cover every value
+  // since the histogram was created or cleared. A snapshot has the same
+  // statistics for just the values it covers; for a CKMS, DDSketch or
+  // t-digest histogram those are the windows its quantiles come from, and
+  // reporters print them instead (see SamplingInterface::windowed).
   virtual double sum() const override;
   virtual double max() const override;
   virtual double min() const override;
   virtual double mean() const override;
   virtual double std_dev() const override;
   void Update(std::int64_t value);
+  // Folds in another histogram's sample and its count, sum, min, max and
+  // variance, as if this one had seen both streams. The two must use the
+  // same sample type; otherwise std::invalid_argument is thrown.
+  void MergeFrom(const Histogram& other);
+  // For checkpoints (see MetricsRegistry::Checkpoint). SaveState encodes
+  // the count, sum, min, max and variance, and the windows of a CKMS,
+  // DDSketch or t-digest sample; other samples are not saved. RestoreState
+  // folds such an encoding in as MergeFrom would, with the windows moved on
+  // by `idle`. Saved windows that this histogram's sample cannot take, being
+  // of another type or window size, are left out. It throws
+  // std::invalid_argument, and restores nothing, for a state it cannot
+  // read, saved windows included.
+  std::string SaveState() const;
+  void RestoreState(const std::string& state, Clock::duration idle);
   std::uint64_t count() const;
   double variance() const;
   void Process(MetricProcessor& processor) override;
@@ -45,6 +93,43 @@ class Histogram : public MetricInterface, SamplingInterface, SummarizableInterfa
   std::unique_ptr<Impl> impl_;
 };
 
+#else
+
+MEDIDA_BEGIN_DISABLED
+
+class Histogram : public MetricInterface, SamplingInterface, SummarizableInterface {
+ public:
+  Histogram(SampleType = kCKMS,
+            std::chrono::seconds = std::chrono::seconds(30),
+            const std::vector<stats::CKMS::Quantile>& = {},
+            std::size_t = 1,
+            bool = false) {}
+  virtual stats::Snapshot GetSnapshot() const override { return {std::vector<double>()}; }
+  virtual stats::Snapshot GetSnapshot(uint64_t) const { return {std::vector<double>()}; }
+  virtual stats::Snapshot GetSnapshot(std::chrono::seconds, uint64_t = 1) const {
+    return {std::vector<double>()};
+  }
+  virtual std::vector<double> quantiles() const override { return {}; }
+  virtual bool windowed() const override { return false; }
+  virtual double sum() const override { return 0.0; }
+  virtual double max() const override { return 0.0; }
+  virtual double min() const override { return 0.0; }
+  virtual double mean() const override { return 0.0; }
+  virtual double std_dev() const override { return 0.0; }
+  void Update(std::int64_t) {}
+  void MergeFrom(const Histogram&) {}
+  std::string SaveState() const { return std::string(); }
+  void RestoreState(const std::string&, Clock::duration) {}
+  std::uint64_t count() const { return 0; }
+  double variance() const { return 0.0; }
+  void Process(MetricProcessor& processor) override { processor.Process(*this); }
+  void Clear() {}
+};
+
+MEDIDA_END_DISABLED
+
+#endif // MEDIDA_DISABLE
+
 } // namespace medida
 
 #endif // MEDIDA_HISTOGRAM_H_
@@ -4,16 +4,26 @@
 
 #include "medida/meter.h"
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
+#include <stdexcept>
+
+#include "medida/encoding.h"
 
 namespace medida {
 
-static const auto kTickInterval = Clock::duration(std::chrono::seconds(5)).count();
+constexpr Clock::rep Meter::kTickInterval;
+
+namespace {
+
+const char kMagic[] = {'M', 'T', 'R', '1'};
+
+} // namespace
 
 class Meter::Impl {
  public:
-  Impl(std::string event_type, std::chrono::nanoseconds rate_unit = std::chrono::seconds(1));
+  Impl(Meter& self, std::string event_type, std::chrono::nanoseconds rate_unit = std::chrono::seconds(1));
   ~Impl();
   std::chrono::nanoseconds rate_unit() const;
   std::string event_type() const;
@@ -22,25 +32,30 @@ class Meter::Impl {
   double five_minute_rate();
   double one_minute_rate();
   double mean_rate();
-  void Mark(std::uint64_t n = 1);
+  void MergeFrom(const Impl& other);
+  std::string SaveState();
+  void RestoreState(const std::string& state, Clock::duration idle);
   void Clear();
-  void Process(MetricProcessor& processor);
+  void TickIfNecessary();
  private:
+  Meter& self_;
   const std::string event_type_;
   const std::chrono::nanoseconds rate_unit_;
-  std::atomic<std::uint64_t> count_;
+  // Guarded, along with the moving averages, by tick_mutex_.
   Clock::time_point start_time_;
-  std::atomic<std::int64_t> last_tick_;
+  mutable std::mutex tick_mutex_;
   stats::EWMA m1_rate_;
   stats::EWMA m5_rate_;
   stats::EWMA m15_rate_;
   void Tick();
-  void TickIfNecessary();
 };
 
 
 Meter::Meter(std::string event_type, std::chrono::nanoseconds rate_unit)
-    : impl_ {new Meter::Impl {event_type, rate_unit}} {
+    : count_     {0},
+      uncounted_ {0},
+      last_tick_ {Clock::now().time_since_epoch().count()},
+      impl_      {new Meter::Impl {*this, event_type, rate_unit}} {
 }
 
 
@@ -83,12 +98,27 @@ double Meter::mean_rate() {
 }
 
 
-void Meter::Mark(std::uint64_t n) {
-  impl_->Mark(n);
+void Meter::TickIfNecessary() {
+  impl_->TickIfNecessary();
+}
+
+void Meter::MergeFrom(const Meter& other) {
+  Touch();
+  impl_->MergeFrom(*other.impl_);
+}
+
+std::string Meter::SaveState() const {
+  return impl_->SaveState();
+}
+
+void Meter::RestoreState(const std::string& state, Clock::duration idle) {
+  Touch();
+  impl_->RestoreState(state, idle);
 }
 
 void Meter::Clear()
 {
+  Touch();
   impl_->Clear();
 }
 
@@ -100,12 +130,11 @@ void Meter::Process(MetricProcessor& processor) {
 // === Implementation ===
 
 
-Meter::Impl::Impl(std::string event_type, std::chrono::nanoseconds rate_unit) 
-    : event_type_ (event_type),
+Meter::Impl::Impl(Meter& self, std::string event_type, std::chrono::nanoseconds rate_unit)
+    : self_       (self),
+      event_type_ (event_type),
       rate_unit_  (rate_unit),
-      count_      (0),
       start_time_ (Clock::now()),
-      last_tick_  (std::chrono::duration_cast<std::chrono::nanoseconds>(start_time_.time_since_epoch()).count()),
       m1_rate_    (stats::EWMA::oneMinuteEWMA()),
       m5_rate_    (stats::EWMA::fiveMinuteEWMA()),
       m15_rate_   (stats::EWMA::fifteenMinuteEWMA()) {
@@ -127,7 +156,7 @@ std::string Meter::Impl::event_type() const {
 
 
 std::uint64_t Meter::Impl::count() const {
-  return count_.load();
+  return self_.count_.load();
 }
 
 
@@ -150,34 +179,121 @@ double Meter::Impl::one_minute_rate() {
 
 
 double Meter::Impl::mean_rate() {
-  double c = count_.load();
+  double c = self_.count_.load();
   if (c > 0) {
-    std::chrono::nanoseconds elapsed = Clock::now() - start_time_;
+    Clock::time_point start_time;
+    {
+      std::lock_guard<std::mutex> lock {tick_mutex_};
+      start_time = start_time_;
+    }
+    std::chrono::nanoseconds elapsed = Clock::now() - start_time;
     return c * rate_unit_.count() / elapsed.count();
   }
   return 0.0;
 }
 
 
-void Meter::Impl::Mark(std::uint64_t n) {
+void Meter::Impl::MergeFrom(const Impl& other) {
+  // The other meter's state is copied under its lock and then added under
+  // ours. Never holding both keeps a.MergeFrom(b) and b.MergeFrom(a) from
+  // deadlocking.
+  std::uint64_t count, uncounted;
+  Clock::time_point start_time;
+  bool initialized[3];
+  double rates[3];
+  {
+    std::lock_guard<std::mutex> lock {other.tick_mutex_};
+    count = other.self_.count_.load();
+    uncounted = other.self_.uncounted_.load();
+    start_time = other.start_time_;
+    const stats::EWMA* averages[] = {&other.m1_rate_, &other.m5_rate_, &other.m15_rate_};
+    for (int i = 0; i < 3; i++) {
+      initialized[i] = averages[i]->initialized();
+      rates[i] = averages[i]->getRate(std::chrono::nanoseconds(1));
+    }
+  }
+
   TickIfNecessary();
-  count_ += n;
-  m1_rate_.update(n);
-  m5_rate_.update(n);
-  m15_rate_.update(n);
+  std::lock_guard<std::mutex> lock {tick_mutex_};
+  self_.count_ += count;
+  self_.uncounted_ += uncounted;
+  start_time_ = std::min(start_time_, start_time);
+  stats::EWMA* averages[] = {&m1_rate_, &m5_rate_, &m15_rate_};
+  for (int i = 0; i < 3; i++) {
+    if (initialized[i]) {
+      averages[i]->restore(rates[i], Clock::duration::zero());
+    }
+  }
+}
+
+std::string Meter::Impl::SaveState() {
+  TickIfNecessary();
+  std::lock_guard<std::mutex> lock {tick_mutex_};
+  std::string out(kMagic, sizeof(kMagic));
+  encoding::PutU64(out, self_.count_.load());
+  encoding::PutU64(out, self_.uncounted_.load());
+  std::chrono::nanoseconds uptime = Clock::now() - start_time_;
+  encoding::PutI64(out, uptime.count());
+  for (auto rate : {&m1_rate_, &m5_rate_, &m15_rate_}) {
+    encoding::PutU32(out, rate->initialized());
+    encoding::PutDouble(out, rate->getRate(std::chrono::nanoseconds(1)));
+  }
+  return out;
+}
+
+void Meter::Impl::RestoreState(const std::string& state, Clock::duration idle) {
+  encoding::Reader in {state, "meter state"};
+  if (!in.Expect(kMagic, sizeof(kMagic))) {
+    throw std::invalid_argument("not a saved meter");
+  }
+  auto count = in.GetU64();
+  auto uncounted = in.GetU64();
+  auto uptime = std::chrono::nanoseconds(in.GetI64());
+  bool initialized[3];
+  double rates[3];
+  for (int i = 0; i < 3; i++) {
+    initialized[i] = in.GetU32() != 0;
+    rates[i] = in.GetDouble();
+  }
+  in.Finish();
+  if (uptime.count() < 0) {
+    in.Malformed();
+  }
+  idle = std::max(idle, Clock::duration::zero());
+
+  TickIfNecessary();
+  std::lock_guard<std::mutex> lock {tick_mutex_};
+  self_.count_ += count;
+  self_.uncounted_ += uncounted;
+  // The mean rate is over the time since the meter first started, down
+  // time included.
+  start_time_ = std::min(start_time_, Clock::now() - idle - uptime);
+  stats::EWMA* averages[] = {&m1_rate_, &m5_rate_, &m15_rate_};
+  for (int i = 0; i < 3; i++) {
+    if (initialized[i]) {
+      averages[i]->restore(rates[i], idle);
+    }
+  }
 }
 
 void Meter::Impl::Clear()
 {
-  count_ = 0;
+  std::lock_guard<std::mutex> lock {tick_mutex_};
+  self_.count_ = 0;
+  self_.uncounted_ = 0;
   start_time_ = Clock::now();
-  last_tick_ = std::chrono::duration_cast<std::chrono::nanoseconds>(start_time_.time_since_epoch()).count();
+  self_.last_tick_ = start_time_.time_since_epoch().count();
   m1_rate_.clear();
   m5_rate_.clear();
   m15_rate_.clear();
 }
 
 void Meter::Impl::Tick() {
+  // Events marked during a tick count towards the next one.
+  auto n = static_cast<std::int64_t>(self_.uncounted_.exchange(0));
+  m1_rate_.update(n);
+  m5_rate_.update(n);
+  m15_rate_.update(n);
   m1_rate_.tick();
   m5_rate_.tick();
   m15_rate_.tick();
@@ -185,11 +301,14 @@ void Meter::Impl::Tick() {
 
 
 void Meter::Impl::TickIfNecessary() {
-  auto old_tick = last_tick_.load();
-  auto new_tick = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+  // Marks only get here once a tick is due, so this lock is off the hot
+  // path; it keeps two threads from both ticking for the same interval.
+  std::lock_guard<std::mutex> lock {tick_mutex_};
+  auto old_tick = self_.last_tick_.load();
+  auto new_tick = Clock::now().time_since_epoch().count();
   auto age = new_tick - old_tick;
   if (age > kTickInterval) {
-    last_tick_ = new_tick;
+    self_.last_tick_ = new_tick;
     auto required_ticks = age / kTickInterval;
     for (auto i = 0; i < required_ticks; i ++) {
       Tick();
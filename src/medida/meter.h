@@ -5,18 +5,27 @@
 #ifndef MEDIDA_METER_H_
 #define MEDIDA_METER_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 
+#include "medida/disable.h"
 #include "medida/stats/ewma.h"
 #include "medida/metered_interface.h"
 #include "medida/metric_interface.h"
 #include "medida/metric_processor.h"
 #include "medida/stats/sample.h"
+#include "medida/types.h"
 
 namespace medida {
 
+#ifndef MEDIDA_DISABLE
+
+// Mark is inline: it adds to two atomics in the header and checks a coarse
+// clock, calling into the library only when a five-second tick is due to
+// fold the events it has counted into the moving averages.
 class Meter : public MetricInterface, MeteredInterface {
  public:
   Meter(std::string event_type, std::chrono::nanoseconds rate_unit = std::chrono::seconds(1));
@@ -28,14 +37,70 @@ class Meter : public MetricInterface, MeteredInterface {
   virtual double five_minute_rate();
   virtual double one_minute_rate();
   virtual double mean_rate();
-  void Mark(std::uint64_t n = 1);
+  void Mark(std::uint64_t n = 1) {
+    Touch();
+    auto now = CoarseClock::now().time_since_epoch().count();
+    if (now - last_tick_.load(std::memory_order_relaxed) > kTickInterval) {
+      TickIfNecessary();
+    }
+    count_.fetch_add(n, std::memory_order_relaxed);
+    uncounted_.fetch_add(n, std::memory_order_relaxed);
+  }
+  // Adds another meter's events and rates to this one's.
+  void MergeFrom(const Meter& other);
+  // For checkpoints (see MetricsRegistry::Checkpoint). SaveState encodes
+  // the count, the moving averages and how long the meter has been running.
+  // RestoreState adds such an encoding to this meter as MergeFrom would,
+  // with the averages decayed by ticks without events for `idle`, and
+  // throws std::invalid_argument for one it cannot read. Events saved
+  // before their tick count towards the next one.
+  std::string SaveState() const;
+  void RestoreState(const std::string& state, Clock::duration idle);
   void Clear();
   void Process(MetricProcessor& processor);
  private:
+  static constexpr Clock::rep kTickInterval =
+      std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(5)).count();
+  void TickIfNecessary();
+  std::atomic<std::uint64_t> count_;
+  // Events marked since the moving averages last took them in.
+  std::atomic<std::uint64_t> uncounted_;
+  // Clock time of the last tick, in Clock ticks.
+  std::atomic<Clock::rep> last_tick_;
   class Impl;
   std::unique_ptr<Impl> impl_;
 };
 
+#else
+
+MEDIDA_BEGIN_DISABLED
+
+class Meter : public MetricInterface, MeteredInterface {
+ public:
+  Meter(std::string event_type, std::chrono::nanoseconds rate_unit = std::chrono::seconds(1))
+      : event_type_ {std::move(event_type)}, rate_unit_ {rate_unit} {}
+  virtual std::chrono::nanoseconds rate_unit() const { return rate_unit_; }
+  virtual std::string event_type() const { return event_type_; }
+  virtual std::uint64_t count() const { return 0; }
+  virtual double fifteen_minute_rate() { return 0.0; }
+  virtual double five_minute_rate() { return 0.0; }
+  virtual double one_minute_rate() { return 0.0; }
+  virtual double mean_rate() { return 0.0; }
+  void Mark(std::uint64_t = 1) {}
+  void MergeFrom(const Meter&) {}
+  std::string SaveState() const { return std::string(); }
+  void RestoreState(const std::string&, Clock::duration) {}
+  void Clear() {}
+  void Process(MetricProcessor& processor) { processor.Process(*this); }
+ private:
+  std::string const event_type_;
+  std::chrono::nanoseconds const rate_unit_;
+};
+
+MEDIDA_END_DISABLED
+
+#endif // MEDIDA_DISABLE
+
 } // namespace medida
 
 #endif // MEDIDA_METER_H_
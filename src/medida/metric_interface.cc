@@ -0,0 +1,16 @@
+//
+// Copyright (c) 2012 Daniel Lundin
+//
+
+#include "medida/metric_interface.h"
+
+namespace medida {
+
+std::atomic<std::uint32_t> MetricInterface::epoch_ {0};
+
+
+std::uint32_t MetricInterface::AdvanceEpoch() {
+  return epoch_.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace medida
@@ -5,14 +5,44 @@
 #ifndef MEDIDA_METRIC_INTERFACE_H_
 #define MEDIDA_METRIC_INTERFACE_H_
 
+#include <atomic>
+#include <cstdint>
+
 #include "medida/metric_processor.h"
 
 namespace medida {
 
 class MetricInterface {
 public:
+  MetricInterface() : last_touched_ {epoch_.load(std::memory_order_relaxed)} {};
   virtual ~MetricInterface() {};
   virtual void Process(MetricProcessor& processor) = 0;
+
+  // The touch epoch in which this metric was last updated or cleared.
+  // Idle-metric sweepers compare it between passes to see whether the metric
+  // is in use, and reporters to see whether it has changed since the last
+  // report (see reporting::ChangeTracker).
+  std::uint32_t last_touched() const {
+    return last_touched_.load(std::memory_order_relaxed);
+  }
+
+  // Starts a new touch epoch and returns it. Only sweepers and reporters
+  // need to call this.
+  static std::uint32_t AdvanceEpoch();
+
+protected:
+  // Called on every update. It stores only on the first update in each
+  // epoch, so the steady-state cost is two relaxed loads.
+  void Touch() {
+    auto epoch = epoch_.load(std::memory_order_relaxed);
+    if (last_touched_.load(std::memory_order_relaxed) != epoch) {
+      last_touched_.store(epoch, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  static std::atomic<std::uint32_t> epoch_;
+  std::atomic<std::uint32_t> last_touched_;
 };
 
 } // namespace medida
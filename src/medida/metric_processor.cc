@@ -13,6 +13,10 @@ void MetricProcessor::Process(Counter& counter) {
 }
 
 
+void MetricProcessor::Process(Gauge& gauge) {
+}
+
+
 void MetricProcessor::Process(Histogram& histogram) {
 }
 
@@ -5,19 +5,25 @@
 #ifndef MEDIDA_METRIC_PROCESSOR_H_
 #define MEDIDA_METRIC_PROCESSOR_H_
 
+#include "medida/disable.h"
+
 namespace medida {
 
+MEDIDA_BEGIN_DISABLED
 class Counter;
 class Histogram;
 class Meter;
-class MetricInterface;
 class Timer;
+MEDIDA_END_DISABLED
+class Gauge;
+class MetricInterface;
 class Buckets;
 
 class MetricProcessor {
 public:
   virtual ~MetricProcessor();
   virtual void Process(Counter& counter);
+  virtual void Process(Gauge& gauge);
   virtual void Process(Histogram& histogram);
   virtual void Process(Meter& meter);
   virtual void Process(Timer& timer);
@@ -5,42 +5,209 @@
 #include "medida/metrics_registry.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
 #include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "medida/encoding.h"
 #include "medida/metric_name.h"
 
 namespace medida {
 
+namespace {
+
+// A checkpoint is a header and then a record per metric, encoded as in
+// medida/encoding.h:
+//   header: magic, version, record count, and the system time it was
+//           written at, in nanoseconds since the epoch
+//   record: state type; the name's domain, type, name and scope; how long
+//           before the file was written the state was taken, in
+//           nanoseconds; and the state itself.
+const char kCheckpointMagic[8] = {'M', 'E', 'D', 'I', 'D', 'A', 'C', 'K'};
+const std::uint32_t kCheckpointVersion = 1;
+// Where the record count sits in the header.
+const std::size_t kRecordCountOffset = sizeof(kCheckpointMagic) + 4;
+
+enum StateType : std::uint32_t {
+  kNotSaved = 0,
+  kCounterState = 1,
+  kMeterState = 2,
+  kHistogramState = 3,
+  kTimerState = 4,
+};
+
+std::runtime_error SystemError(const std::string& what, const std::string& path) {
+  std::stringstream ss;
+  ss << what << " " << path << " (" << errno << "): " << strerror(errno);
+  return std::runtime_error(ss.str());
+}
+
+std::int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      SystemClock::now().time_since_epoch()).count();
+}
+
+class StateSaver : public MetricProcessor {
+ public:
+  void Process(Counter& counter) {
+    type = kCounterState;
+    state.clear();
+    encoding::PutI64(state, counter.count());
+  }
+  void Process(Meter& meter) {
+    type = kMeterState;
+    state = meter.SaveState();
+  }
+  void Process(Histogram& histogram) {
+    type = kHistogramState;
+    state = histogram.SaveState();
+  }
+  void Process(Timer& timer) {
+    type = kTimerState;
+    state = timer.SaveState();
+  }
+  std::uint32_t type;
+  std::string state;
+};
+
+// Adds saved state to a metric of the type it was saved from, and ignores
+// any other. Throws std::invalid_argument for state it cannot read.
+class StateRestorer : public MetricProcessor {
+ public:
+  StateRestorer(std::uint32_t type, const std::string& state, Clock::duration idle)
+      : type_ {type}, state_ (state), idle_ {idle} {
+  }
+  void Process(Counter& counter) {
+    if (type_ == kCounterState) {
+      encoding::Reader in {state_, "counter state"};
+      auto count = in.GetI64();
+      in.Finish();
+      counter.inc(count);
+    }
+  }
+  void Process(Meter& meter) {
+    if (type_ == kMeterState) {
+      meter.RestoreState(state_, idle_);
+    }
+  }
+  void Process(Histogram& histogram) {
+    if (type_ == kHistogramState) {
+      histogram.RestoreState(state_, idle_);
+    }
+  }
+  void Process(Timer& timer) {
+    if (type_ == kTimerState) {
+      timer.RestoreState(state_, idle_);
+    }
+  }
+ private:
+  std::uint32_t const type_;
+  const std::string& state_;
+  Clock::duration const idle_;
+};
+
+} // namespace
+
 class MetricsRegistry::Impl {
  public:
-  Impl(std::chrono::seconds ckms_window_size = std::chrono::seconds(30));
+  Impl(std::chrono::seconds ckms_window_size, std::size_t ckms_windows,
+       bool ckms_background_compaction);
   ~Impl();
-  Counter& NewCounter(const MetricName &name, std::int64_t init_value = 0);
-  Histogram& NewHistogram(const MetricName &name,
-      SamplingInterface::SampleType sample_type = SamplingInterface::kCKMS);
-  Meter& NewMeter(const MetricName &name, std::string event_type, 
-      Clock::duration rate_unit = std::chrono::seconds(1));
-  Timer& NewTimer(const MetricName &name,
-      std::chrono::nanoseconds duration_unit = std::chrono::milliseconds(1),
-      std::chrono::nanoseconds rate_unit = std::chrono::seconds(1));
-  Buckets& NewBuckets(
+  // `pin` keeps the metric from RemoveIdle, for callers given a reference.
+  std::shared_ptr<Counter> NewCounter(const MetricName &name, std::int64_t init_value,
+      bool pin);
+  std::shared_ptr<Gauge> NewGauge(const MetricName &name, std::function<double()> callback,
+      bool pin);
+  std::shared_ptr<Gauge> NewGauge(const MetricName &name, double init_value, bool pin);
+  std::shared_ptr<Histogram> NewHistogram(const MetricName &name,
+      SamplingInterface::SampleType sample_type,
+      const std::vector<stats::CKMS::Quantile>& quantiles, bool pin);
+  std::shared_ptr<Meter> NewMeter(const MetricName &name, std::string event_type,
+      Clock::duration rate_unit, bool pin);
+  std::shared_ptr<Timer> NewTimer(const MetricName &name,
+      std::chrono::nanoseconds duration_unit,
+      std::chrono::nanoseconds rate_unit,
+      const std::vector<stats::CKMS::Quantile>& quantiles,
+      SamplingInterface::SampleType sample_type, bool pin);
+  std::shared_ptr<Buckets> NewBuckets(
       const MetricName& name, std::set<double> boundaries,
       std::chrono::nanoseconds duration_unit,
-      std::chrono::nanoseconds rate_unit);
+      std::chrono::nanoseconds rate_unit, bool pin);
 
   std::map<MetricName, std::shared_ptr<MetricInterface>> GetAllMetrics() const;
+  std::shared_ptr<const std::map<MetricName, std::shared_ptr<MetricInterface>>>
+      GetAllMetricsShared() const;
   void ProcessAll(MetricProcessor& processor);
+  bool Remove(const MetricName &name);
+  std::size_t RemoveIdle(Clock::duration ttl);
+  void StartSweeper(Clock::duration ttl, Clock::duration interval);
+  void StopSweeper();
+  void Checkpoint(const std::string& path) const;
+  std::size_t Restore(const std::string& path);
+  void StartCheckpointing(const std::string& path, Clock::duration interval);
+  void StopCheckpointing();
  private:
+  // What RemoveIdle last saw of a metric: its touch epoch, and when that
+  // epoch was first observed.
+  struct Activity {
+    std::uint32_t last_touched;
+    Clock::time_point since;
+  };
   std::map<MetricName, std::shared_ptr<MetricInterface>> metrics_;
+  // A copy of metrics_ for GetAllMetricsShared, dropped whenever a metric
+  // is added or removed.
+  mutable std::shared_ptr<const std::map<MetricName, std::shared_ptr<MetricInterface>>> shared_;
+  std::map<MetricName, Activity> activity_;
+  // Metrics that a reference has been handed out to.
+  std::set<MetricName> pinned_;
+  // State from Restore for metrics that have yet to be created.
+  struct SavedState {
+    std::uint32_t type;
+    std::string state;
+    // When it was taken, on this process's clock.
+    Clock::time_point taken;
+  };
+  std::map<MetricName, SavedState> restored_;
   std::chrono::seconds const ckms_window_size_;
+  std::size_t const ckms_windows_;
+  bool const ckms_background_compaction_;
   mutable std::mutex mutex_;
-  template<typename T, typename... Args> T& NewMetric(const MetricName& name, Args... args);
+  std::thread sweeper_;
+  std::mutex sweeper_mutex_;
+  std::condition_variable sweeper_cv_;
+  bool sweeper_stop_;
+  // Keeps two checkpoints from writing the same temporary file at once.
+  mutable std::mutex checkpoint_mutex_;
+  std::thread checkpointer_;
+  std::mutex checkpointer_mutex_;
+  std::condition_variable checkpointer_cv_;
+  bool checkpointer_stop_;
+  template<typename T, typename... Args>
+  std::shared_ptr<T> NewMetric(const MetricName& name, bool pin, Args... args);
+  // Adds `saved` to `metric`, dropping it if the metric cannot take it.
+  static void Apply(MetricInterface& metric, const SavedState& saved);
 };
 
 
-MetricsRegistry::MetricsRegistry(std::chrono::seconds ckms_window_size)
-    : impl_ {new MetricsRegistry::Impl(ckms_window_size)} {
+MetricsRegistry::MetricsRegistry(std::chrono::seconds ckms_window_size,
+                                 std::size_t ckms_windows,
+                                 bool ckms_background_compaction)
+    : impl_ {new MetricsRegistry::Impl(ckms_window_size, ckms_windows,
+                                       ckms_background_compaction)} {
 }
 
 
@@ -49,25 +216,38 @@ MetricsRegistry::~MetricsRegistry() {
 
 
 Counter& MetricsRegistry::NewCounter(const MetricName &name, std::int64_t init_value) {
-  return impl_->NewCounter(name, init_value);
+  return *impl_->NewCounter(name, init_value, true);
+}
+
+
+Gauge& MetricsRegistry::NewGauge(const MetricName &name, std::function<double()> callback) {
+  return *impl_->NewGauge(name, callback, true);
+}
+
+
+Gauge& MetricsRegistry::NewGauge(const MetricName &name, double init_value) {
+  return *impl_->NewGauge(name, init_value, true);
 }
 
 
 Histogram& MetricsRegistry::NewHistogram(const MetricName &name,
-    SamplingInterface::SampleType sample_type) {
-  return impl_->NewHistogram(name, sample_type);
+    SamplingInterface::SampleType sample_type,
+    const std::vector<stats::CKMS::Quantile>& quantiles) {
+  return *impl_->NewHistogram(name, sample_type, quantiles, true);
 }
 
 
 Meter& MetricsRegistry::NewMeter(const MetricName &name, std::string event_type,
     Clock::duration rate_unit) {
-  return impl_->NewMeter(name, event_type, rate_unit);
+  return *impl_->NewMeter(name, event_type, rate_unit, true);
 }
 
 
 Timer& MetricsRegistry::NewTimer(const MetricName &name, std::chrono::nanoseconds duration_unit,
-    std::chrono::nanoseconds rate_unit) {
-  return impl_->NewTimer(name, duration_unit, rate_unit);
+    std::chrono::nanoseconds rate_unit,
+    const std::vector<stats::CKMS::Quantile>& quantiles,
+    SamplingInterface::SampleType sample_type) {
+  return *impl_->NewTimer(name, duration_unit, rate_unit, quantiles, sample_type, true);
 }
 
 Buckets&
@@ -76,7 +256,54 @@ MetricsRegistry::NewBuckets(const MetricName& name,
                                   std::chrono::nanoseconds duration_unit,
                                   std::chrono::nanoseconds rate_unit)
 {
-    return impl_->NewBuckets(name, boundaries, duration_unit, rate_unit);
+    return *impl_->NewBuckets(name, boundaries, duration_unit, rate_unit, true);
+}
+
+
+std::shared_ptr<Counter> MetricsRegistry::NewCounterShared(const MetricName &name,
+    std::int64_t init_value) {
+  return impl_->NewCounter(name, init_value, false);
+}
+
+
+std::shared_ptr<Gauge> MetricsRegistry::NewGaugeShared(const MetricName &name,
+    std::function<double()> callback) {
+  return impl_->NewGauge(name, callback, false);
+}
+
+
+std::shared_ptr<Gauge> MetricsRegistry::NewGaugeShared(const MetricName &name, double init_value) {
+  return impl_->NewGauge(name, init_value, false);
+}
+
+
+std::shared_ptr<Histogram> MetricsRegistry::NewHistogramShared(const MetricName &name,
+    SamplingInterface::SampleType sample_type,
+    const std::vector<stats::CKMS::Quantile>& quantiles) {
+  return impl_->NewHistogram(name, sample_type, quantiles, false);
+}
+
+
+std::shared_ptr<Meter> MetricsRegistry::NewMeterShared(const MetricName &name,
+    std::string event_type, Clock::duration rate_unit) {
+  return impl_->NewMeter(name, event_type, rate_unit, false);
+}
+
+
+std::shared_ptr<Timer> MetricsRegistry::NewTimerShared(const MetricName &name,
+    std::chrono::nanoseconds duration_unit,
+    std::chrono::nanoseconds rate_unit,
+    const std::vector<stats::CKMS::Quantile>& quantiles,
+    SamplingInterface::SampleType sample_type) {
+  return impl_->NewTimer(name, duration_unit, rate_unit, quantiles, sample_type, false);
+}
+
+
+std::shared_ptr<Buckets> MetricsRegistry::NewBucketsShared(const MetricName& name,
+    std::set<double> boundaries,
+    std::chrono::nanoseconds duration_unit,
+    std::chrono::nanoseconds rate_unit) {
+  return impl_->NewBuckets(name, boundaries, duration_unit, rate_unit, false);
 }
 
 std::map<MetricName, std::shared_ptr<MetricInterface>> MetricsRegistry::GetAllMetrics() const {
@@ -84,63 +311,437 @@ std::map<MetricName, std::shared_ptr<MetricInterface>> MetricsRegistry::GetAllMe
 }
 
 
+std::shared_ptr<const std::map<MetricName, std::shared_ptr<MetricInterface>>>
+MetricsRegistry::GetAllMetricsShared() const {
+  return impl_->GetAllMetricsShared();
+}
+
+
+bool MetricsRegistry::Remove(const MetricName &name) {
+  return impl_->Remove(name);
+}
+
+
+std::size_t MetricsRegistry::RemoveIdle(Clock::duration ttl) {
+  return impl_->RemoveIdle(ttl);
+}
+
+
+void MetricsRegistry::StartSweeper(Clock::duration ttl, Clock::duration interval) {
+  impl_->StartSweeper(ttl, interval);
+}
+
+
+void MetricsRegistry::StopSweeper() {
+  impl_->StopSweeper();
+}
+
+
+void MetricsRegistry::Checkpoint(const std::string& path) const {
+  impl_->Checkpoint(path);
+}
+
+
+std::size_t MetricsRegistry::Restore(const std::string& path) {
+  return impl_->Restore(path);
+}
+
+
+void MetricsRegistry::StartCheckpointing(const std::string& path, Clock::duration interval) {
+  impl_->StartCheckpointing(path, interval);
+}
+
+
+void MetricsRegistry::StopCheckpointing() {
+  impl_->StopCheckpointing();
+}
+
+
 // === Implementation ===
 
 
-MetricsRegistry::Impl::Impl(std::chrono::seconds ckms_window_size)
-    : ckms_window_size_(ckms_window_size) {
+MetricsRegistry::Impl::Impl(std::chrono::seconds ckms_window_size,
+                            std::size_t ckms_windows,
+                            bool ckms_background_compaction)
+    : ckms_window_size_(ckms_window_size),
+      ckms_windows_(ckms_windows),
+      ckms_background_compaction_(ckms_background_compaction),
+      sweeper_stop_ {false},
+      checkpointer_stop_ {false} {
 }
 
 
 MetricsRegistry::Impl::~Impl() {
+  StopSweeper();
+  StopCheckpointing();
 }
 
 
-Counter& MetricsRegistry::Impl::NewCounter(const MetricName &name, std::int64_t init_value) {
-  return NewMetric<Counter>(name, init_value);
+std::shared_ptr<Counter> MetricsRegistry::Impl::NewCounter(const MetricName &name,
+    std::int64_t init_value, bool pin) {
+  return NewMetric<Counter>(name, pin, init_value);
 }
 
 
-Histogram& MetricsRegistry::Impl::NewHistogram(const MetricName &name,
-    SamplingInterface::SampleType sample_type) {
-  return NewMetric<Histogram>(name, sample_type, ckms_window_size_);
+std::shared_ptr<Gauge> MetricsRegistry::Impl::NewGauge(const MetricName &name,
+    std::function<double()> callback, bool pin) {
+  return NewMetric<Gauge>(name, pin, callback);
 }
 
 
-Meter& MetricsRegistry::Impl::NewMeter(const MetricName &name, std::string event_type,
-    Clock::duration rate_unit) {
-  return NewMetric<Meter>(name, event_type, rate_unit);
+std::shared_ptr<Gauge> MetricsRegistry::Impl::NewGauge(const MetricName &name, double init_value,
+    bool pin) {
+  return NewMetric<Gauge>(name, pin, init_value);
 }
 
 
-Timer& MetricsRegistry::Impl::NewTimer(const MetricName &name, std::chrono::nanoseconds duration_unit,
-    std::chrono::nanoseconds rate_unit) {
-  return NewMetric<Timer>(name, duration_unit, rate_unit, ckms_window_size_);
+std::shared_ptr<Histogram> MetricsRegistry::Impl::NewHistogram(const MetricName &name,
+    SamplingInterface::SampleType sample_type,
+    const std::vector<stats::CKMS::Quantile>& quantiles, bool pin) {
+  return NewMetric<Histogram>(name, pin, sample_type, ckms_window_size_, quantiles,
+                              ckms_windows_, ckms_background_compaction_);
 }
 
-Buckets& MetricsRegistry::Impl::NewBuckets(
+
+std::shared_ptr<Meter> MetricsRegistry::Impl::NewMeter(const MetricName &name,
+    std::string event_type, Clock::duration rate_unit, bool pin) {
+  return NewMetric<Meter>(name, pin, event_type, rate_unit);
+}
+
+
+std::shared_ptr<Timer> MetricsRegistry::Impl::NewTimer(const MetricName &name,
+    std::chrono::nanoseconds duration_unit,
+    std::chrono::nanoseconds rate_unit,
+    const std::vector<stats::CKMS::Quantile>& quantiles,
+    SamplingInterface::SampleType sample_type, bool pin) {
+  return NewMetric<Timer>(name, pin, duration_unit, rate_unit, ckms_window_size_, quantiles,
+                          ckms_windows_, ckms_background_compaction_, sample_type);
+}
+
+std::shared_ptr<Buckets> MetricsRegistry::Impl::NewBuckets(
     const MetricName& name, std::set<double> boundaries,
     std::chrono::nanoseconds duration_unit,
-    std::chrono::nanoseconds rate_unit)
+    std::chrono::nanoseconds rate_unit, bool pin)
 {
-    return NewMetric<Buckets>(name, boundaries, duration_unit, rate_unit);
+    return NewMetric<Buckets>(name, pin, boundaries, duration_unit, rate_unit);
 }
 
 
 template<typename MetricType, typename... Args>
-MetricType& MetricsRegistry::Impl::NewMetric(const MetricName& name, Args... args) {
+std::shared_ptr<MetricType> MetricsRegistry::Impl::NewMetric(const MetricName& name, bool pin,
+                                                             Args... args) {
   std::lock_guard<std::mutex> lock {mutex_};
-  if (metrics_.find(name) == std::end(metrics_)) {
+  if (pin) {
+    pinned_.insert(name);
+  }
+  auto it = metrics_.find(name);
+  if (it == std::end(metrics_)) {
     // GCC 4.6: Bug 44436 emplace* not implemented. Use ::reset instead.
     // metrics_[name].reset(new MetricType(args...));
-    metrics_[name] = std::make_shared<MetricType>(args...);
-  } else {
+    auto metric = std::make_shared<MetricType>(args...);
+    metrics_[name] = metric;
+    shared_.reset();
+    if (!restored_.empty()) {
+      auto saved = restored_.find(name);
+      if (saved != restored_.end()) {
+        Apply(*metric, saved->second);
+        restored_.erase(saved);
+      }
+    }
+    return metric;
+  }
+  auto metric = std::dynamic_pointer_cast<MetricType>(it->second);
+  if (!metric) {
+    throw std::bad_cast();
   }
-  return dynamic_cast<MetricType&>(*metrics_[name]);
+  return metric;
 }
 
 std::map<MetricName, std::shared_ptr<MetricInterface>> MetricsRegistry::Impl::GetAllMetrics() const {
- return {metrics_}; 
+  std::lock_guard<std::mutex> lock {mutex_};
+  return {metrics_};
+}
+
+
+std::shared_ptr<const std::map<MetricName, std::shared_ptr<MetricInterface>>>
+MetricsRegistry::Impl::GetAllMetricsShared() const {
+  std::lock_guard<std::mutex> lock {mutex_};
+  if (!shared_) {
+    shared_ = std::make_shared<const std::map<MetricName, std::shared_ptr<MetricInterface>>>(metrics_);
+  }
+  return shared_;
+}
+
+
+void MetricsRegistry::Impl::Apply(MetricInterface& metric, const SavedState& saved) {
+  StateRestorer restorer {saved.type, saved.state, Clock::now() - saved.taken};
+  try {
+    metric.Process(restorer);
+  } catch (const std::invalid_argument&) {
+    // Saved by an incompatible version of the metric.
+  }
+}
+
+
+bool MetricsRegistry::Impl::Remove(const MetricName &name) {
+  std::lock_guard<std::mutex> lock {mutex_};
+  activity_.erase(name);
+  pinned_.erase(name);
+  if (metrics_.erase(name) == 0) {
+    return false;
+  }
+  shared_.reset();
+  return true;
+}
+
+
+std::size_t MetricsRegistry::Impl::RemoveIdle(Clock::duration ttl) {
+  // Updates made from here on land in the new epoch, so any metric whose
+  // epoch has not moved by the next call was not updated in between.
+  auto epoch = MetricInterface::AdvanceEpoch();
+  auto now = Clock::now();
+  std::size_t removed = 0;
+  std::lock_guard<std::mutex> lock {mutex_};
+  // Every metric has a reference from metrics_ and, while it is kept, from
+  // the GetAllMetricsShared copy too. Keeping our own reference to that
+  // copy holds the count steady while metrics are erased.
+  auto shared = shared_;
+  long const owned = shared ? 2 : 1;
+  for (auto it = metrics_.begin(); it != metrics_.end(); ) {
+    auto last_touched = it->second->last_touched();
+    // A metric already touched in the new epoch (or a later one a reporter
+    // started) can be updated again before the next call without its epoch
+    // moving. Record it as touched in the epoch before, so that the next
+    // call sees it move and restarts its clock then.
+    bool active = static_cast<std::int32_t>(last_touched - epoch) >= 0;
+    if (active) {
+      last_touched = epoch - 1;
+    }
+    auto seen = activity_.find(it->first);
+    if (seen == activity_.end()) {
+      // First pass over this metric: start its clock now.
+      activity_[it->first] = {last_touched, now};
+      ++it;
+    } else if (active || last_touched != seen->second.last_touched) {
+      seen->second = {last_touched, now};
+      ++it;
+    } else if (now - seen->second.since >= ttl && it->second.use_count() == owned &&
+               pinned_.count(it->first) == 0) {
+      activity_.erase(it->first);
+      it = metrics_.erase(it);
+      shared_.reset();
+      ++removed;
+    } else {
+      ++it;
+    }
+  }
+  return removed;
+}
+
+
+void MetricsRegistry::Impl::StartSweeper(Clock::duration ttl, Clock::duration interval) {
+  StopSweeper();
+  sweeper_stop_ = false;
+  sweeper_ = std::thread([this, ttl, interval] {
+    std::unique_lock<std::mutex> lock {sweeper_mutex_};
+    while (!sweeper_cv_.wait_for(lock, interval, [this] { return sweeper_stop_; })) {
+      RemoveIdle(ttl);
+    }
+  });
+}
+
+
+void MetricsRegistry::Impl::StopSweeper() {
+  {
+    std::lock_guard<std::mutex> lock {sweeper_mutex_};
+    sweeper_stop_ = true;
+  }
+  sweeper_cv_.notify_all();
+  if (sweeper_.joinable()) {
+    sweeper_.join();
+  }
+}
+
+
+void MetricsRegistry::Impl::Checkpoint(const std::string& path) const {
+  std::unique_lock<std::mutex> metrics_lock {mutex_};
+  std::vector<std::pair<MetricName, std::shared_ptr<MetricInterface>>> metrics {
+      metrics_.begin(), metrics_.end()};
+  std::vector<std::pair<MetricName, SavedState>> unclaimed {restored_.begin(), restored_.end()};
+  metrics_lock.unlock();
+
+  std::string out(kCheckpointMagic, sizeof(kCheckpointMagic));
+  encoding::PutU32(out, kCheckpointVersion);
+  encoding::PutU32(out, 0);
+  encoding::PutI64(out, NowNanos());
+  std::uint32_t records = 0;
+  auto put_record = [&out, &records](const MetricName& name, std::uint32_t type,
+                                     Clock::duration age, const std::string& state) {
+    encoding::PutU32(out, type);
+    encoding::PutBytes(out, name.domain());
+    encoding::PutBytes(out, name.type());
+    encoding::PutBytes(out, name.name());
+    encoding::PutBytes(out, name.scope());
+    encoding::PutI64(out, std::chrono::duration_cast<std::chrono::nanoseconds>(age).count());
+    encoding::PutBytes(out, state);
+    records++;
+  };
+  StateSaver saver;
+  for (auto& kv : metrics) {
+    saver.type = kNotSaved;
+    kv.second->Process(saver);
+    if (saver.type != kNotSaved && !saver.state.empty()) {
+      put_record(kv.first, saver.type, Clock::duration::zero(), saver.state);
+    }
+  }
+  auto now = Clock::now();
+  for (auto& kv : unclaimed) {
+    put_record(kv.first, kv.second.type, now - kv.second.taken, kv.second.state);
+  }
+  std::string count;
+  encoding::PutU32(count, records);
+  out.replace(kRecordCountOffset, count.size(), count);
+
+  std::lock_guard<std::mutex> lock {checkpoint_mutex_};
+  auto temp = path + ".tmp." + std::to_string(getpid());
+  auto fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    throw SystemError("Cannot create", temp);
+  }
+  for (std::size_t written = 0; written < out.size(); ) {
+    auto n = write(fd, out.data() + written, out.size() - written);
+    if (n == -1 && errno == EINTR) {
+      continue;
+    }
+    if (n == -1) {
+      auto error = SystemError("Cannot write", temp);
+      close(fd);
+      unlink(temp.c_str());
+      throw error;
+    }
+    written += n;
+  }
+  // The file must be complete on disk before it replaces the last one.
+  if (fsync(fd) != 0) {
+    auto error = SystemError("Cannot sync", temp);
+    close(fd);
+    unlink(temp.c_str());
+    throw error;
+  }
+  close(fd);
+  if (rename(temp.c_str(), path.c_str()) != 0) {
+    auto error = SystemError("Cannot replace", path);
+    unlink(temp.c_str());
+    throw error;
+  }
+}
+
+
+std::size_t MetricsRegistry::Impl::Restore(const std::string& path) {
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    if (errno == ENOENT) {
+      return 0;
+    }
+    throw SystemError("Cannot open", path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    auto error = SystemError("Cannot stat", path);
+    close(fd);
+    throw error;
+  }
+  if (st.st_size == 0) {
+    close(fd);
+    throw std::runtime_error(path + " is not a metrics checkpoint");
+  }
+  auto base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    throw SystemError("Cannot map", path);
+  }
+
+  // Everything is read before anything is applied, so that a bad file
+  // restores nothing. Checkpoints list metrics in name order, so most
+  // records go in at the end of the map.
+  std::map<MetricName, SavedState> records;
+  try {
+    encoding::Reader in {static_cast<const char*>(base), static_cast<std::size_t>(st.st_size),
+                         "metrics checkpoint"};
+    if (!in.Expect(kCheckpointMagic, sizeof(kCheckpointMagic)) ||
+        in.GetU32() != kCheckpointVersion) {
+      in.Malformed();
+    }
+    auto count = in.GetU32();
+    auto written = in.GetI64();
+    // Time that has passed since, as far as the system clock can tell.
+    auto since = std::chrono::nanoseconds(std::max<std::int64_t>(NowNanos() - written, 0));
+    auto now = Clock::now();
+    for (std::uint32_t i = 0; i < count; i++) {
+      auto type = in.GetU32();
+      auto domain = in.GetBytes();
+      auto metric_type = in.GetBytes();
+      auto name = in.GetBytes();
+      auto scope = in.GetBytes();
+      auto age = std::chrono::nanoseconds(std::max<std::int64_t>(in.GetI64(), 0));
+      records.emplace_hint(records.end(), std::piecewise_construct,
+                           std::forward_as_tuple(domain, metric_type, name, scope),
+                           std::forward_as_tuple(SavedState {type, in.GetBytes(),
+                                                             now - since - age}));
+    }
+    in.Finish();
+  } catch (const std::invalid_argument& e) {
+    munmap(base, st.st_size);
+    throw std::runtime_error(path + " is not a metrics checkpoint: " + e.what());
+  }
+  munmap(base, st.st_size);
+  auto count = records.size();
+
+  std::lock_guard<std::mutex> lock {mutex_};
+  for (auto& kv : metrics_) {
+    auto saved = records.find(kv.first);
+    if (saved != records.end()) {
+      Apply(*kv.second, saved->second);
+      records.erase(saved);
+    }
+  }
+  if (restored_.empty()) {
+    restored_.swap(records);
+  } else {
+    for (auto& kv : records) {
+      restored_[kv.first] = std::move(kv.second);
+    }
+  }
+  return count;
+}
+
+
+void MetricsRegistry::Impl::StartCheckpointing(const std::string& path, Clock::duration interval) {
+  StopCheckpointing();
+  checkpointer_stop_ = false;
+  checkpointer_ = std::thread([this, path, interval] {
+    std::unique_lock<std::mutex> lock {checkpointer_mutex_};
+    for (bool stop = false; !stop; ) {
+      stop = checkpointer_cv_.wait_for(lock, interval, [this] { return checkpointer_stop_; });
+      try {
+        Checkpoint(path);
+      } catch (const std::exception&) {
+        // Left for the next checkpoint to retry.
+      }
+    }
+  });
+}
+
+
+void MetricsRegistry::Impl::StopCheckpointing() {
+  {
+    std::lock_guard<std::mutex> lock {checkpointer_mutex_};
+    checkpointer_stop_ = true;
+  }
+  checkpointer_cv_.notify_all();
+  if (checkpointer_.joinable()) {
+    checkpointer_.join();
+  }
 }
 
 
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "medida/counter.h"
+#include "medida/gauge.h"
 #include "medida/histogram.h"
 #include "medida/meter.h"
 #include "medida/metric_interface.h"
@@ -23,23 +24,118 @@ namespace medida {
 
 class MetricsRegistry {
  public:
-  MetricsRegistry(std::chrono::seconds ckms_window_size = std::chrono::seconds(30));
+  // Histograms and timers created here use CKMS windows of
+  // `ckms_window_size`, keep `ckms_windows` completed windows, and compress
+  // them in the background if `ckms_background_compaction` is set.
+  MetricsRegistry(std::chrono::seconds ckms_window_size = std::chrono::seconds(30),
+                  std::size_t ckms_windows = 1,
+                  bool ckms_background_compaction = false);
   ~MetricsRegistry();
   Counter& NewCounter(const MetricName &name, std::int64_t init_value = 0);
+  // If a gauge with this name already exists it is returned unchanged; the
+  // callback or initial value passed here is then ignored.
+  Gauge& NewGauge(const MetricName &name, std::function<double()> callback);
+  Gauge& NewGauge(const MetricName &name, double init_value = 0.0);
+  // See Histogram for `quantiles`.
   Histogram& NewHistogram(const MetricName &name,
-      SamplingInterface::SampleType sample_type = SamplingInterface::kCKMS);
+      SamplingInterface::SampleType sample_type = SamplingInterface::kCKMS,
+      const std::vector<stats::CKMS::Quantile>& quantiles = {});
   Meter& NewMeter(const MetricName &name, std::string event_type, 
       Clock::duration rate_unit = std::chrono::seconds(1));
   Timer& NewTimer(const MetricName &name,
       std::chrono::nanoseconds duration_unit = std::chrono::milliseconds(1),
-      std::chrono::nanoseconds rate_unit = std::chrono::seconds(1));
+      std::chrono::nanoseconds rate_unit = std::chrono::seconds(1),
+      const std::vector<stats::CKMS::Quantile>& quantiles = {},
+      SamplingInterface::SampleType sample_type = SamplingInterface::kCKMS);
   Buckets& NewBuckets(
       const MetricName& name,
       std::set<double> boundaries,
       std::chrono::nanoseconds duration_unit = std::chrono::milliseconds(1),
       std::chrono::nanoseconds rate_unit = std::chrono::seconds(1));
 
+  // The same as the New* methods above, but sharing ownership of the metric
+  // with the caller. A metric that has only ever been handed out this way
+  // may be removed by RemoveIdle once no shared_ptr to it remains outside
+  // the registry; one that a New* method above has returned a reference to
+  // never is, as that reference could not tell.
+  std::shared_ptr<Counter> NewCounterShared(const MetricName &name,
+      std::int64_t init_value = 0);
+  std::shared_ptr<Gauge> NewGaugeShared(const MetricName &name,
+      std::function<double()> callback);
+  std::shared_ptr<Gauge> NewGaugeShared(const MetricName &name, double init_value = 0.0);
+  std::shared_ptr<Histogram> NewHistogramShared(const MetricName &name,
+      SamplingInterface::SampleType sample_type = SamplingInterface::kCKMS,
+      const std::vector<stats::CKMS::Quantile>& quantiles = {});
+  std::shared_ptr<Meter> NewMeterShared(const MetricName &name, std::string event_type,
+      Clock::duration rate_unit = std::chrono::seconds(1));
+  std::shared_ptr<Timer> NewTimerShared(const MetricName &name,
+      std::chrono::nanoseconds duration_unit = std::chrono::milliseconds(1),
+      std::chrono::nanoseconds rate_unit = std::chrono::seconds(1),
+      const std::vector<stats::CKMS::Quantile>& quantiles = {},
+      SamplingInterface::SampleType sample_type = SamplingInterface::kCKMS);
+  std::shared_ptr<Buckets> NewBucketsShared(
+      const MetricName& name,
+      std::set<double> boundaries,
+      std::chrono::nanoseconds duration_unit = std::chrono::milliseconds(1),
+      std::chrono::nanoseconds rate_unit = std::chrono::seconds(1));
+
   std::map<MetricName, std::shared_ptr<MetricInterface>> GetAllMetrics() const;
+  // The same, as an immutable map that is built on first use and shared by
+  // every caller until a metric is added or removed. Reporters that run
+  // every period use it to avoid copying the whole registry each time.
+  std::shared_ptr<const std::map<MetricName, std::shared_ptr<MetricInterface>>>
+      GetAllMetricsShared() const;
+
+  // Removes a metric from the registry and returns whether it was present.
+  // Holders of a shared_ptr from GetAllMetrics() (such as a reporter in the
+  // middle of a pass) keep the metric alive. A reference returned by one of
+  // the New* methods becomes invalid once no shared_ptr remains, so callers
+  // must drop it before removing the metric. A later New* call with the same
+  // name creates a fresh metric.
+  bool Remove(const MetricName &name);
+
+  // Removes every metric that successive calls have seen go without an
+  // update for at least `ttl`, and returns the number removed. Reads do not
+  // count as updates; clearing a metric does. Only metrics from the *Shared
+  // methods that nothing outside the registry holds are removed (see
+  // NewCounterShared); the rest are tracked but kept. Idleness is detected
+  // by comparing each metric's touch epoch between calls, so a metric is
+  // never removed by the first call that sees it. Otherwise, with calls
+  // made every interval, it is removed no sooner than `ttl` after its last
+  // update and by `ttl` plus two intervals after it.
+  std::size_t RemoveIdle(Clock::duration ttl);
+
+  // Runs RemoveIdle(ttl) every `interval` on a background thread until
+  // StopSweeper() is called or the registry is destroyed. Calling it again
+  // replaces the running sweeper.
+  void StartSweeper(Clock::duration ttl,
+      Clock::duration interval = std::chrono::seconds(60));
+  void StopSweeper();
+
+  // Writes the state of every counter, meter, histogram and timer to a
+  // compact binary file at `path`, replacing any file there atomically.
+  // Gauges and buckets are not saved. Throws std::runtime_error if the file
+  // cannot be written.
+  void Checkpoint(const std::string& path) const;
+
+  // Reads a checkpoint for a warm restart and returns the number of metrics
+  // in it, or 0 if there is no file at `path`. Each saved state is added to
+  // the metric of that name as MergeFrom would add another metric's (see
+  // Meter::RestoreState and Histogram::RestoreState), with moving averages
+  // and windows aged by the time since it was saved. Metrics that do not
+  // exist yet get their state when a New* call creates them; until then,
+  // later checkpoints carry it over. State saved for another type of
+  // metric is dropped. Throws std::runtime_error, and restores nothing, if
+  // the file cannot be read or is not a checkpoint.
+  std::size_t Restore(const std::string& path);
+
+  // Runs Checkpoint(path) every `interval` on a background thread, and once
+  // more when StopCheckpointing() is called or the registry is destroyed.
+  // Calling it again replaces the running checkpointer. A checkpoint that
+  // fails is left for the next one to retry.
+  void StartCheckpointing(const std::string& path,
+      Clock::duration interval = std::chrono::seconds(60));
+  void StopCheckpointing();
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -48,10 +48,12 @@ namespace reporting {
 
 class CollectdReporter::Impl {
  public:
-  Impl(CollectdReporter& self, MetricsRegistry &registry, const std::string& hostname = "127.0.0.1", std::uint16_t port = 25826);
+  Impl(CollectdReporter& self, MetricsRegistry &registry, const std::string& hostname, std::uint16_t port,
+       Temporality temporality);
   ~Impl();
   void Run();
   void Process(Counter& counter);
+  void Process(Gauge& gauge);
   void Process(Meter& meter);
   void Process(Histogram& histogram);
   void Process(Timer& timer);
@@ -88,6 +90,7 @@ class CollectdReporter::Impl {
   char msgbuf_[kMaxSize];
   char* msgbuf_ptr_;
   std::string current_instance_;
+  ChangeTracker tracker_;
   void AddPart(PartType type, std::uint64_t number);
   void AddPart(PartType type, const std::string& text);
   void AddValues(std::initializer_list<Value> values);
@@ -99,9 +102,10 @@ class CollectdReporter::Impl {
 };
 
 
-CollectdReporter::CollectdReporter(MetricsRegistry &registry, const std::string& hostname, std::uint16_t port)
+CollectdReporter::CollectdReporter(MetricsRegistry &registry, const std::string& hostname, std::uint16_t port,
+                                   Temporality temporality)
     : AbstractPollingReporter(),
-      impl_ {new CollectdReporter::Impl {*this, registry, hostname, port}} {
+      impl_ {new CollectdReporter::Impl {*this, registry, hostname, port, temporality}} {
 }
 
 
@@ -119,6 +123,11 @@ void CollectdReporter::Process(Counter& counter) {
 }
 
 
+void CollectdReporter::Process(Gauge& gauge) {
+  impl_->Process(gauge);
+}
+
+
 void CollectdReporter::Process(Meter& meter) {
   impl_->Process(meter);
 }
@@ -138,9 +147,10 @@ void CollectdReporter::Process(Timer& timer) {
 
 
 CollectdReporter::Impl::Impl(CollectdReporter& self, MetricsRegistry &registry, const std::string& hostname,
-    std::uint16_t port)
+    std::uint16_t port, Temporality temporality)
     : self_     (self),
-      registry_ (registry) {
+      registry_ (registry),
+      tracker_  (temporality) {
   utsname name;
   uname_ = uname(&name) ? "localhost" : name.nodename;
   auto port_str = std::to_string(port);
@@ -164,9 +174,14 @@ CollectdReporter::Impl::~Impl() {
 
 void CollectdReporter::Impl::Run() {
   std::lock_guard<std::mutex> lock {mutex_};
-  for (auto& kv : registry_.GetAllMetrics()) {
-    auto name = kv.first;
-    auto metric = kv.second;
+  tracker_.Begin();
+  auto metrics = registry_.GetAllMetricsShared();
+  for (auto& kv : *metrics) {
+    auto& name = kv.first;
+    auto& metric = kv.second;
+    if (!tracker_.Visit(name, *metric)) {
+      continue;
+    }
     auto scope = name.scope();
     current_instance_ = name.name() + (scope.empty() ? "" : "." + scope);
 
@@ -183,21 +198,29 @@ void CollectdReporter::Impl::Run() {
     auto msg_size = msgbuf_ptr_ - msgbuf_;
     sendto(socket_, msgbuf_, msg_size, 0, addrinfo_->ai_addr, addrinfo_->ai_addrlen);
   }
+  tracker_.End();
 }
 
 
 void CollectdReporter::Impl::Process(Counter& counter) {
-  double count = counter.count();
+  double count = tracker_.Count(counter.count());
   AddPart(kType, "medida_counter");
   AddPart(kTypeInstance, current_instance_ + ".count");
   AddValues({{kGauge, count}});
 }
 
 
+void CollectdReporter::Impl::Process(Gauge& gauge) {
+  AddPart(kType, "medida_gauge");
+  AddPart(kTypeInstance, current_instance_ + ".value");
+  AddValues({{kGauge, gauge.value()}});
+}
+
+
 void CollectdReporter::Impl::Process(Meter& meter) {
   auto event_type = meter.event_type();
   auto unit = FormatRateUnit(meter.rate_unit());
-  double count = meter.count();
+  double count = tracker_.Count(meter.count());
   AddPart(kType, "medida_meter");
   AddPart(kTypeInstance, current_instance_ + "." + event_type +"_per_" + unit);
   AddValues({
@@ -212,14 +235,15 @@ void CollectdReporter::Impl::Process(Meter& meter) {
 
 void CollectdReporter::Impl::Process(Histogram& histogram) {
   auto snapshot = histogram.GetSnapshot();
-  double count = histogram.count();
+  auto summary = Summarize(histogram, snapshot);
+  double count = tracker_.Count(histogram.count());
   AddPart(kType, "medida_histogram");
   AddPart(kTypeInstance, current_instance_);
   AddValues({
-    {kGauge, histogram.min()},
-    {kGauge, histogram.max()},
-    {kGauge, histogram.mean()},
-    {kGauge, histogram.std_dev()},
+    {kGauge, summary.min},
+    {kGauge, summary.max},
+    {kGauge, summary.mean},
+    {kGauge, summary.std_dev},
     {kGauge, snapshot.getMedian()},
     {kGauge, snapshot.get75thPercentile()},
     {kGauge, snapshot.get95thPercentile()},
@@ -237,14 +261,15 @@ void CollectdReporter::Impl::Process(Histogram& histogram) {
 
 void CollectdReporter::Impl::Process(Timer& timer) {
   auto snapshot = timer.GetSnapshot();
-  double count = timer.count();
+  auto summary = Summarize(timer, snapshot);
+  double count = tracker_.Count(timer.count());
   AddPart(kType, "medida_timer");
   AddPart(kTypeInstance, current_instance_ + "." + FormatRateUnit(timer.duration_unit()));
   AddValues({
-    {kGauge, timer.min()},
-    {kGauge, timer.max()},
-    {kGauge, timer.mean()},
-    {kGauge, timer.std_dev()},
+    {kGauge, summary.min},
+    {kGauge, summary.max},
+    {kGauge, summary.mean},
+    {kGauge, summary.std_dev},
     {kGauge, snapshot.getMedian()},
     {kGauge, snapshot.get75thPercentile()},
     {kGauge, snapshot.get95thPercentile()},
@@ -12,17 +12,23 @@
 #include "medida/metrics_registry.h"
 #include "medida/metric_processor.h"
 #include "medida/reporting/abstract_polling_reporter.h"
+#include "medida/reporting/temporality.h"
 
 namespace medida {
 namespace reporting {
 
 
+// Sends each metric to collectd's network plugin as one datagram. With a
+// Temporality other than kCumulative, metrics that have not been updated
+// since the last Run() are not sent.
 class CollectdReporter : public AbstractPollingReporter, MetricProcessor {
  public:
-  CollectdReporter(MetricsRegistry &registry, const std::string& hostname = "127.0.0.1", std::uint16_t port = 25826);
+  CollectdReporter(MetricsRegistry &registry, const std::string& hostname = "127.0.0.1", std::uint16_t port = 25826,
+                   Temporality temporality = Temporality::kCumulative);
   virtual ~CollectdReporter();
   virtual void Run();
   virtual void Process(Counter& counter);
+  virtual void Process(Gauge& gauge);
   virtual void Process(Meter& meter);
   virtual void Process(Histogram& histogram);
   virtual void Process(Timer& timer);
@@ -10,15 +10,19 @@
 #include <sstream>
 #include <string>
 
+#include "medida/reporting/util.h"
+
 namespace medida {
 namespace reporting {
 
 class ConsoleReporter::Impl {
  public:
-  Impl(ConsoleReporter& self, MetricsRegistry &registry, std::ostream& out = std::cerr);
+  Impl(ConsoleReporter& self, MetricsRegistry &registry, std::ostream& out,
+       Temporality temporality);
   ~Impl();
   void Run();
   void Process(Counter& counter);
+  void Process(Gauge& gauge);
   void Process(Meter& meter);
   void Process(Histogram& histogram);
   void Process(Timer& timer);
@@ -26,13 +30,15 @@ class ConsoleReporter::Impl {
   ConsoleReporter& self_;
   medida::MetricsRegistry& registry_;
   std::ostream& out_;
+  ChangeTracker tracker_;
   std::string FormatRateUnit(const std::chrono::nanoseconds& rate_unit) const;
 };
 
 
-ConsoleReporter::ConsoleReporter(MetricsRegistry &registry, std::ostream& out)
+ConsoleReporter::ConsoleReporter(MetricsRegistry &registry, std::ostream& out,
+                                 Temporality temporality)
     : AbstractPollingReporter(),
-      impl_ {new ConsoleReporter::Impl {*this, registry, out}} {
+      impl_ {new ConsoleReporter::Impl {*this, registry, out, temporality}} {
 }
 
 
@@ -50,6 +56,11 @@ void ConsoleReporter::Process(Counter& counter) {
 }
 
 
+void ConsoleReporter::Process(Gauge& gauge) {
+  impl_->Process(gauge);
+}
+
+
 void ConsoleReporter::Process(Meter& meter) {
   impl_->Process(meter);
 }
@@ -68,10 +79,12 @@ void ConsoleReporter::Process(Timer& timer) {
 // === Implementation ===
 
 
-ConsoleReporter::Impl::Impl(ConsoleReporter& self, MetricsRegistry &registry, std::ostream& out)
+ConsoleReporter::Impl::Impl(ConsoleReporter& self, MetricsRegistry &registry, std::ostream& out,
+                            Temporality temporality)
     : self_     (self),
       registry_ (registry),
-      out_      (out) {
+      out_      (out),
+      tracker_  (temporality) {
 }
 
 
@@ -80,25 +93,36 @@ ConsoleReporter::Impl::~Impl() {
 
 
 void ConsoleReporter::Impl::Run() {
-  for (auto& kv : registry_.GetAllMetrics()) {
-    auto name = kv.first;
-    auto metric = kv.second;
+  tracker_.Begin();
+  auto metrics = registry_.GetAllMetricsShared();
+  for (auto& kv : *metrics) {
+    auto& name = kv.first;
+    auto& metric = kv.second;
+    if (!tracker_.Visit(name, *metric)) {
+      continue;
+    }
     out_ << name.ToString() << ":" << std::endl;
     metric->Process(self_);
   }
+  tracker_.End();
   out_ << std::endl;
 }
 
 
 void ConsoleReporter::Impl::Process(Counter& counter) {
-  out_ << "  count = " << counter.count() << std::endl;
+  out_ << "  count = " << tracker_.Count(counter.count()) << std::endl;
+}
+
+
+void ConsoleReporter::Impl::Process(Gauge& gauge) {
+  out_ << "  value = " << gauge.value() << std::endl;
 }
 
 
 void ConsoleReporter::Impl::Process(Meter& meter) {
   auto event_type = meter.event_type();
   auto unit = FormatRateUnit(meter.rate_unit());
-  out_ << "           count = " << meter.count() << std::endl
+  out_ << "           count = " << tracker_.Count(meter.count()) << std::endl
        << "       mean rate = " << meter.mean_rate() << " " << event_type << "/" << unit << std::endl
        << "   1-minute rate = " << meter.one_minute_rate() << " " << event_type << "/" << unit << std::endl
        << "   5-minute rate = " << meter.five_minute_rate() << " " << event_type << "/" << unit << std::endl
@@ -108,44 +132,40 @@ void ConsoleReporter::Impl::Process(Meter& meter) {
 
 void ConsoleReporter::Impl::Process(Histogram& histogram) {
   auto snapshot = histogram.GetSnapshot();
-  out_ << "           count = " << histogram.count() << std::endl
-       << "             min = " << histogram.min() << std::endl
-       << "             max = " << histogram.max() << std::endl
-       << "            mean = " << histogram.mean() << std::endl
-       << "          stddev = " << histogram.std_dev() << std::endl
-       << "             sum = " << histogram.sum() << std::endl
-       << "          median = " << snapshot.getMedian() << std::endl
-       << "             75% = " << snapshot.get75thPercentile() << std::endl
-       << "             95% = " << snapshot.get95thPercentile() << std::endl
-       << "             98% = " << snapshot.get98thPercentile() << std::endl
-       << "             99% = " << snapshot.get99thPercentile() << std::endl
-       << "           99.9% = " << snapshot.get999thPercentile() << std::endl
-       << "            100% = " << snapshot.max() << std::endl;
+  auto summary = Summarize(histogram, snapshot);
+  out_ << "           count = " << tracker_.Count(histogram.count()) << std::endl
+       << "             min = " << summary.min << std::endl
+       << "             max = " << summary.max << std::endl
+       << "            mean = " << summary.mean << std::endl
+       << "          stddev = " << summary.std_dev << std::endl
+       << "             sum = " << histogram.sum() << std::endl;
+  for (auto q : histogram.quantiles()) {
+    out_ << std::setw(16) << FormatQuantile(q) << " = " << snapshot.getValue(q) << std::endl;
+  }
+  out_ << "            100% = " << snapshot.max() << std::endl;
 }
 
 
 void ConsoleReporter::Impl::Process(Timer& timer) {
   auto snapshot = timer.GetSnapshot();
+  auto summary = Summarize(timer, snapshot);
   auto event_type = timer.event_type();
   auto rate_unit = FormatRateUnit(timer.rate_unit());
   auto unit = FormatRateUnit(timer.duration_unit());
-  out_ << "           count = " << timer.count() << std::endl
+  out_ << "           count = " << tracker_.Count(timer.count()) << std::endl
        << "       mean rate = " << timer.mean_rate() << " " << event_type << "/" << rate_unit << std::endl
        << "   1-minute rate = " << timer.one_minute_rate() << " " << event_type << "/" << rate_unit << std::endl
        << "   5-minute rate = " << timer.five_minute_rate() << " " << event_type << "/" << rate_unit << std::endl
        << "  15-minute rate = " << timer.fifteen_minute_rate() << " " << event_type << "/" << rate_unit << std::endl
-       << "             min = " << timer.min() << unit << std::endl
-       << "             max = " << timer.max() << unit << std::endl
-       << "            mean = " << timer.mean() << unit << std::endl
-       << "          stddev = " << timer.std_dev() << unit << std::endl
-       << "             sum = " << timer.sum() << unit << std::endl
-       << "          median = " << snapshot.getMedian() << unit << std::endl
-       << "             75% = " << snapshot.get75thPercentile() << unit << std::endl
-       << "             95% = " << snapshot.get95thPercentile() << unit << std::endl
-       << "             98% = " << snapshot.get98thPercentile() << unit << std::endl
-       << "             99% = " << snapshot.get99thPercentile() << unit << std::endl
-       << "           99.9% = " << snapshot.get999thPercentile() << unit << std::endl
-       << "            100% = " << snapshot.max() << unit << std::endl;
+       << "             min = " << summary.min << unit << std::endl
+       << "             max = " << summary.max << unit << std::endl
+       << "            mean = " << summary.mean << unit << std::endl
+       << "          stddev = " << summary.std_dev << unit << std::endl
+       << "             sum = " << timer.sum() << unit << std::endl;
+  for (auto q : timer.quantiles()) {
+    out_ << std::setw(16) << FormatQuantile(q) << " = " << snapshot.getValue(q) << unit << std::endl;
+  }
+  out_ << "            100% = " << snapshot.max() << unit << std::endl;
 }
 
 
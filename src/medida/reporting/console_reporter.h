@@ -10,16 +10,21 @@
 #include "medida/metric_processor.h"
 #include "medida/metrics_registry.h"
 #include "medida/reporting/abstract_polling_reporter.h"
+#include "medida/reporting/temporality.h"
 
 namespace medida {
 namespace reporting {
 
+// Prints every metric to `out`. With a Temporality other than kCumulative,
+// metrics that have not been updated since the last Run() are left out.
 class ConsoleReporter : public AbstractPollingReporter, public MetricProcessor {
  public:
-  ConsoleReporter(MetricsRegistry &registry, std::ostream& out = std::cerr);
+  ConsoleReporter(MetricsRegistry &registry, std::ostream& out = std::cerr,
+                  Temporality temporality = Temporality::kCumulative);
   virtual ~ConsoleReporter();
   virtual void Run();
   virtual void Process(Counter& counter);
+  virtual void Process(Gauge& gauge);
   virtual void Process(Meter& meter);
   virtual void Process(Histogram& histogram);
   virtual void Process(Timer& timer);
@@ -0,0 +1,463 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/graphite_reporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef __FreeBSD__
+#include <netinet/in.h>
+#endif
+
+#include "medida/reporting/util.h"
+#include "medida/stats/snapshot.h"
+
+namespace medida {
+namespace reporting {
+
+class GraphiteReporter::Impl {
+ public:
+  Impl(GraphiteReporter& self, MetricsRegistry &registry, const std::string& hostname,
+       std::uint16_t port, const std::string& prefix, Clock::duration max_backoff);
+  ~Impl();
+  void Run();
+  void Process(Counter& counter);
+  void Process(Gauge& gauge);
+  void Process(Meter& meter);
+  void Process(Histogram& histogram);
+  void Process(Timer& timer);
+  bool connected() const;
+ private:
+  GraphiteReporter& self_;
+  MetricsRegistry& registry_;
+  const std::string prefix_;
+  const Clock::duration max_backoff_;
+  std::mutex mutex_;
+  struct addrinfo *addrinfo_;
+  int socket_;
+  std::atomic<bool> connected_;
+  Clock::duration backoff_;
+  Clock::time_point next_attempt_;
+  // Each metric's path, and each quantile's last path component.
+  std::map<MetricName, std::string> paths_;
+  std::map<double, std::string> quantile_keys_;
+  const std::string* current_path_;
+  // " <seconds since the epoch>\n", which ends every line of a run.
+  std::string line_end_;
+  // This run's lines, and what is left of the last failed run's.
+  std::string buffer_;
+  std::string pending_;
+  void AddCount(const char* field, std::int64_t count);
+  void AddValue(const char* field, double value);
+  void AddLine(const char* field, const char* value);
+  void AddRates(double mean, double m1, double m5, double m15);
+  void AddSummary(const Summary& summary, double sum, const stats::Snapshot& snapshot,
+                  const std::vector<double>& quantiles);
+  void Send();
+  std::size_t Write();
+  void Keep(std::size_t sent);
+  bool Connect();
+  bool Alive();
+  void Disconnect();
+  void Failed();
+};
+
+
+GraphiteReporter::GraphiteReporter(MetricsRegistry &registry, const std::string& hostname,
+                                   std::uint16_t port, const std::string& prefix,
+                                   Clock::duration max_backoff)
+    : AbstractPollingReporter(),
+      impl_ {new GraphiteReporter::Impl {*this, registry, hostname, port, prefix, max_backoff}} {
+}
+
+
+GraphiteReporter::~GraphiteReporter() {
+  // Stop the polling thread before the socket goes away under it.
+  Shutdown();
+}
+
+
+void GraphiteReporter::Run() {
+  impl_->Run();
+}
+
+
+void GraphiteReporter::Process(Counter& counter) {
+  impl_->Process(counter);
+}
+
+
+void GraphiteReporter::Process(Gauge& gauge) {
+  impl_->Process(gauge);
+}
+
+
+void GraphiteReporter::Process(Meter& meter) {
+  impl_->Process(meter);
+}
+
+
+void GraphiteReporter::Process(Histogram& histogram) {
+  impl_->Process(histogram);
+}
+
+
+void GraphiteReporter::Process(Timer& timer) {
+  impl_->Process(timer);
+}
+
+
+bool GraphiteReporter::connected() const {
+  return impl_->connected();
+}
+
+
+// === Implementation ===
+
+
+namespace {
+
+// How long a connect or a write may block the reporting thread.
+const int kTimeoutMillis = 5000;
+
+#ifdef MSG_NOSIGNAL
+const int kSendFlags = MSG_NOSIGNAL;
+#else
+const int kSendFlags = 0;
+#endif
+
+// Graphite splits lines on whitespace.
+std::string Path(const std::string& prefix, const MetricName& name) {
+  auto path = prefix.empty() ? name.ToString() : prefix + "." + name.ToString();
+  for (auto& c : path) {
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      c = '_';
+    }
+  }
+  return path;
+}
+
+} // namespace
+
+
+GraphiteReporter::Impl::Impl(GraphiteReporter& self, MetricsRegistry &registry,
+                             const std::string& hostname, std::uint16_t port,
+                             const std::string& prefix, Clock::duration max_backoff)
+    : self_         (self),
+      registry_     (registry),
+      prefix_       (prefix),
+      max_backoff_  (max_backoff),
+      socket_       (-1),
+      connected_    {false},
+      backoff_      (Clock::duration::zero()),
+      next_attempt_ (Clock::time_point::min()),
+      current_path_ (nullptr) {
+  struct addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  auto port_str = std::to_string(port);
+  auto err = getaddrinfo(hostname.c_str(), port_str.c_str(), &hints, &addrinfo_);
+  if (err != 0) {
+    throw std::invalid_argument("getaddrinfo error: " + std::string(gai_strerror(err)));
+  }
+}
+
+
+GraphiteReporter::Impl::~Impl() {
+  Disconnect();
+  freeaddrinfo(addrinfo_);
+}
+
+
+bool GraphiteReporter::Impl::connected() const {
+  return connected_.load(std::memory_order_relaxed);
+}
+
+
+void GraphiteReporter::Impl::Run() {
+  std::lock_guard<std::mutex> lock {mutex_};
+  auto now = std::chrono::duration_cast<std::chrono::seconds>(
+      SystemClock::now().time_since_epoch()).count();
+  line_end_ = " " + std::to_string(now) + "\n";
+  buffer_.clear();
+
+  // Both maps are in name order, so walk them together, dropping the paths
+  // of metrics that have gone and building them for new ones.
+  auto path = paths_.begin();
+  auto metrics = registry_.GetAllMetricsShared();
+  for (auto& kv : *metrics) {
+    auto& name = kv.first;
+    while (path != paths_.end() && path->first < name) {
+      path = paths_.erase(path);
+    }
+    if (path == paths_.end() || path->first != name) {
+      path = paths_.emplace_hint(path, name, Path(prefix_, name));
+    }
+    current_path_ = &path->second;
+    kv.second->Process(self_);
+    ++path;
+  }
+  paths_.erase(path, paths_.end());
+  current_path_ = nullptr;
+  Send();
+}
+
+
+void GraphiteReporter::Impl::Process(Counter& counter) {
+  AddCount("count", counter.count());
+}
+
+
+void GraphiteReporter::Impl::Process(Gauge& gauge) {
+  AddValue("value", gauge.value());
+}
+
+
+void GraphiteReporter::Impl::Process(Meter& meter) {
+  AddCount("count", meter.count());
+  AddRates(meter.mean_rate(), meter.one_minute_rate(), meter.five_minute_rate(),
+           meter.fifteen_minute_rate());
+}
+
+
+void GraphiteReporter::Impl::Process(Histogram& histogram) {
+  AddCount("count", histogram.count());
+  auto snapshot = histogram.GetSnapshot();
+  AddSummary(Summarize(histogram, snapshot), histogram.sum(), snapshot, histogram.quantiles());
+}
+
+
+void GraphiteReporter::Impl::Process(Timer& timer) {
+  AddCount("count", timer.count());
+  AddRates(timer.mean_rate(), timer.one_minute_rate(), timer.five_minute_rate(),
+           timer.fifteen_minute_rate());
+  auto snapshot = timer.GetSnapshot();
+  AddSummary(Summarize(timer, snapshot), timer.sum(), snapshot, timer.quantiles());
+}
+
+
+void GraphiteReporter::Impl::AddCount(const char* field, std::int64_t count) {
+  char digits[32];
+  std::snprintf(digits, sizeof(digits), "%" PRId64, count);
+  AddLine(field, digits);
+}
+
+
+void GraphiteReporter::Impl::AddValue(const char* field, double value) {
+  // Graphite has no representation for these.
+  if (!std::isfinite(value)) {
+    return;
+  }
+  char digits[32];
+  std::snprintf(digits, sizeof(digits), "%.15g", value);
+  AddLine(field, digits);
+}
+
+
+void GraphiteReporter::Impl::AddLine(const char* field, const char* value) {
+  buffer_.append(*current_path_);
+  buffer_ += '.';
+  buffer_.append(field);
+  buffer_ += ' ';
+  buffer_.append(value);
+  buffer_.append(line_end_);
+}
+
+
+void GraphiteReporter::Impl::AddRates(double mean, double m1, double m5, double m15) {
+  AddValue("mean_rate", mean);
+  AddValue("m1_rate", m1);
+  AddValue("m5_rate", m5);
+  AddValue("m15_rate", m15);
+}
+
+
+void GraphiteReporter::Impl::AddSummary(const Summary& summary, double sum,
+                                        const stats::Snapshot& snapshot,
+                                        const std::vector<double>& quantiles) {
+  AddValue("min", summary.min);
+  AddValue("max", summary.max);
+  AddValue("mean", summary.mean);
+  AddValue("std_dev", summary.std_dev);
+  AddValue("sum", sum);
+  for (auto q : quantiles) {
+    auto key = quantile_keys_.find(q);
+    if (key == quantile_keys_.end()) {
+      key = quantile_keys_.emplace(q, FormatQuantileKey(q)).first;
+    }
+    AddValue(key->second.c_str(), snapshot.getValue(q));
+  }
+}
+
+
+void GraphiteReporter::Impl::Send() {
+  // The server never writes, so a readable socket means it has gone.
+  if (socket_ != -1 && !Alive()) {
+    Disconnect();
+  }
+  if (socket_ == -1) {
+    if (Clock::now() < next_attempt_) {
+      Keep(0);
+      connected_.store(false, std::memory_order_relaxed);
+      return;
+    }
+    if (!Connect()) {
+      Failed();
+      Keep(0);
+      connected_.store(false, std::memory_order_relaxed);
+      return;
+    }
+  }
+  auto sent = Write();
+  if (sent == pending_.size() + buffer_.size()) {
+    pending_.clear();
+    backoff_ = Clock::duration::zero();
+    connected_.store(true, std::memory_order_relaxed);
+    return;
+  }
+  Disconnect();
+  Failed();
+  Keep(sent);
+  connected_.store(false, std::memory_order_relaxed);
+}
+
+
+// Writes pending_ then buffer_, returning how many bytes of the two went
+// out before an error.
+std::size_t GraphiteReporter::Impl::Write() {
+  const std::string* parts[] = {&pending_, &buffer_};
+  auto total = pending_.size() + buffer_.size();
+  std::size_t sent = 0;
+  while (sent < total) {
+    iovec iov[2];
+    int count = 0;
+    auto skip = sent;
+    for (auto part : parts) {
+      if (skip >= part->size()) {
+        skip -= part->size();
+        continue;
+      }
+      iov[count].iov_base = const_cast<char*>(part->data()) + skip;
+      iov[count].iov_len = part->size() - skip;
+      count++;
+      skip = 0;
+    }
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    auto n = sendmsg(socket_, &msg, kSendFlags);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    sent += n;
+  }
+  return sent;
+}
+
+
+// Keeps this run's lines that did not go out in full, dropping any older
+// ones, so that at most one run's output waits for the server.
+void GraphiteReporter::Impl::Keep(std::size_t sent) {
+  if (sent <= pending_.size()) {
+    pending_.swap(buffer_);
+    return;
+  }
+  auto offset = sent - pending_.size();
+  // A line cut short went out on a connection that is now closed, so the
+  // server drops it; send it again whole.
+  auto start = buffer_.rfind('\n', offset - 1);
+  start = start == std::string::npos ? 0 : start + 1;
+  pending_.assign(buffer_, start, std::string::npos);
+}
+
+
+bool GraphiteReporter::Impl::Connect() {
+  auto fd = socket(addrinfo_->ai_family, addrinfo_->ai_socktype, addrinfo_->ai_protocol);
+  if (fd == -1) {
+    return false;
+  }
+  // Connect without blocking, so that an unreachable host costs no more
+  // than the timeout.
+  auto flags = fcntl(fd, F_GETFL);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  auto ok = connect(fd, addrinfo_->ai_addr, addrinfo_->ai_addrlen) == 0;
+  if (!ok && errno == EINPROGRESS) {
+    pollfd p;
+    p.fd = fd;
+    p.events = POLLOUT;
+    int error = 0;
+    socklen_t size = sizeof(error);
+    ok = poll(&p, 1, kTimeoutMillis) == 1 &&
+         getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size) == 0 && error == 0;
+  }
+  if (!ok) {
+    close(fd);
+    return false;
+  }
+  fcntl(fd, F_SETFL, flags);
+  timeval timeout {kTimeoutMillis / 1000, (kTimeoutMillis % 1000) * 1000};
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+  socket_ = fd;
+  return true;
+}
+
+
+bool GraphiteReporter::Impl::Alive() {
+  pollfd p;
+  p.fd = socket_;
+  p.events = POLLIN;
+  if (poll(&p, 1, 0) == 0) {
+    return true;
+  }
+  char byte;
+  auto n = recv(socket_, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+  return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+}
+
+
+void GraphiteReporter::Impl::Disconnect() {
+  if (socket_ != -1) {
+    close(socket_);
+    socket_ = -1;
+  }
+}
+
+
+// Puts off the next connection attempt, for twice as long each time.
+void GraphiteReporter::Impl::Failed() {
+  backoff_ = backoff_ == Clock::duration::zero() ? std::chrono::seconds(1) : backoff_ * 2;
+  backoff_ = std::min(backoff_, max_backoff_);
+  next_attempt_ = Clock::now() + backoff_;
+}
+
+
+} // namespace reporting
+} // namespace medida
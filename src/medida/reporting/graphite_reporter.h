@@ -0,0 +1,71 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_REPORTING_GRAPHITE_REPORTER_H_
+#define MEDIDA_REPORTING_GRAPHITE_REPORTER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "medida/metric_processor.h"
+#include "medida/metrics_registry.h"
+#include "medida/reporting/abstract_polling_reporter.h"
+#include "medida/types.h"
+
+namespace medida {
+namespace reporting {
+
+// Sends every metric to Graphite in its plaintext protocol, one
+// "<path> <value> <timestamp>" line per value, over a TCP connection that
+// is kept open between runs. Each Run() formats all of its lines into one
+// buffer and hands them to the kernel in a single gathered write.
+//
+// A metric's path is `prefix`, if any, then MetricName::ToString(), with
+// whitespace replaced by '_'; it is built when the metric first appears.
+// The values under it are:
+//   counter:   .count
+//   gauge:     .value
+//   meter:     .count, .mean_rate, .m1_rate, .m5_rate, .m15_rate
+//   histogram: .count, .min, .max, .mean, .std_dev, .sum, and one
+//              .p<quantile> (p50, p99, p99_9, ...) per reported quantile
+//   timer:     all of the above, durations in the timer's duration unit
+// For a windowed histogram or timer (see SamplingInterface::windowed),
+// .min, .max, .mean and .std_dev cover the same windows as the quantiles;
+// otherwise they cover every value, as .count and .sum always do.
+//
+// When the connection fails, or the far end closes it, Run() keeps that
+// period's output, dropping any it kept before, and tries to reconnect at
+// the next Run() whose time has come: after 1s, then 2s, 4s and so on up
+// to `max_backoff`. The kept output goes out ahead of the current one once
+// connected again.
+//
+// The constructor throws std::invalid_argument if the host cannot be
+// resolved; it does not connect.
+class GraphiteReporter : public AbstractPollingReporter, public MetricProcessor {
+ public:
+  GraphiteReporter(MetricsRegistry &registry,
+                   const std::string& hostname = "127.0.0.1",
+                   std::uint16_t port = 2003,
+                   const std::string& prefix = "",
+                   Clock::duration max_backoff = std::chrono::minutes(1));
+  virtual ~GraphiteReporter();
+  virtual void Run();
+  virtual void Process(Counter& counter);
+  virtual void Process(Gauge& gauge);
+  virtual void Process(Meter& meter);
+  virtual void Process(Histogram& histogram);
+  virtual void Process(Timer& timer);
+  // Whether the last Run() left its output with the server.
+  bool connected() const;
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+
+} // namespace reporting
+} // namespace medida
+
+#endif // MEDIDA_REPORTING_GRAPHITE_REPORTER_H_
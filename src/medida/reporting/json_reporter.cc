@@ -5,6 +5,7 @@
 #include "medida/reporting/json_reporter.h"
 
 #include <chrono>
+#include <cmath>
 #include <ctime>
 #include <mutex>
 #include <sstream>
@@ -21,11 +22,13 @@ namespace reporting {
 
 class JsonReporter::Impl {
  public:
-  Impl(JsonReporter& self, MetricsRegistry &registry);
-  Impl(JsonReporter& self, std::map<MetricName, std::shared_ptr<MetricInterface>> const& metrics);
+  Impl(JsonReporter& self, MetricsRegistry &registry, Temporality temporality);
+  Impl(JsonReporter& self, std::map<MetricName, std::shared_ptr<MetricInterface>> const& metrics,
+       Temporality temporality);
 
   ~Impl();
   void Process(Counter& counter);
+  void Process(Gauge& gauge);
   void Process(Meter& meter);
   void Process(Histogram& histogram);
   void Process(Timer& timer);
@@ -37,15 +40,17 @@ class JsonReporter::Impl {
   mutable std::mutex mutex_;
   std::stringstream out_;
   std::string uname_;
+  ChangeTracker tracker_;
   void setName();
 };
 
 
-JsonReporter::JsonReporter(MetricsRegistry &registry)
-    : impl_ {new JsonReporter::Impl {*this, registry}} {
+JsonReporter::JsonReporter(MetricsRegistry &registry, Temporality temporality)
+    : impl_ {new JsonReporter::Impl {*this, registry, temporality}} {
 }
 
-JsonReporter::JsonReporter(std::map<MetricName, std::shared_ptr<MetricInterface>> const& metricsToReport): impl_ {new JsonReporter::Impl {*this, metricsToReport}}
+JsonReporter::JsonReporter(std::map<MetricName, std::shared_ptr<MetricInterface>> const& metricsToReport,
+                           Temporality temporality): impl_ {new JsonReporter::Impl {*this, metricsToReport, temporality}}
 {
 }
 
@@ -64,6 +69,11 @@ void JsonReporter::Process(Counter& counter) {
 }
 
 
+void JsonReporter::Process(Gauge& gauge) {
+  impl_->Process(gauge);
+}
+
+
 void JsonReporter::Process(Meter& meter) {
   impl_->Process(meter);
 }
@@ -106,15 +116,18 @@ JsonReporter::Impl::setName()
 #endif
 }
 
-JsonReporter::Impl::Impl(JsonReporter& self, MetricsRegistry &registry)
+JsonReporter::Impl::Impl(JsonReporter& self, MetricsRegistry &registry, Temporality temporality)
     : self_     (self),
-      metrics_ (registry.GetAllMetrics()) {
+      metrics_ (registry.GetAllMetrics()),
+      tracker_ (temporality) {
   setName();
 }
 
-JsonReporter::Impl::Impl(JsonReporter& self, std::map<MetricName, std::shared_ptr<MetricInterface>> const& metrics)
+JsonReporter::Impl::Impl(JsonReporter& self, std::map<MetricName, std::shared_ptr<MetricInterface>> const& metrics,
+                         Temporality temporality)
     : self_     (self),
-      metrics_ (metrics) {
+      metrics_ (metrics),
+      tracker_ (temporality) {
   setName();
 }
 
@@ -146,9 +159,13 @@ std::string JsonReporter::Impl::Report() {
        << "\"uname\":\"" << uname_ << "\"," << std::endl
        << "\"metrics\":{" << std::endl;
   auto first = true;
+  tracker_.Begin();
   for (auto& kv : metrics_) {
-    auto name = kv.first;
-    auto metric = kv.second;
+    auto& name = kv.first;
+    auto& metric = kv.second;
+    if (!tracker_.Visit(name, *metric)) {
+      continue;
+    }
     if (first) {
       first = false;
     } else {
@@ -158,6 +175,7 @@ std::string JsonReporter::Impl::Report() {
     metric->Process(self_);
     out_ << "}" << std::endl;
   }
+  tracker_.End();
   out_ << "}"    // metrics
        << "}";  // top
   return out_.str();
@@ -166,7 +184,19 @@ std::string JsonReporter::Impl::Report() {
 
 void JsonReporter::Impl::Process(Counter& counter) {
   out_ << "\"type\":\"counter\"," << std::endl;
-  out_ << "\"count\":" << counter.count() << std::endl;
+  out_ << "\"count\":" << tracker_.Count(counter.count()) << std::endl;
+}
+
+
+void JsonReporter::Impl::Process(Gauge& gauge) {
+  out_ << "\"type\":\"gauge\"," << std::endl;
+  auto value = gauge.value();
+  // JSON has no representation for these.
+  if (std::isfinite(value)) {
+    out_ << "\"value\":" << value << std::endl;
+  } else {
+    out_ << "\"value\":null" << std::endl;
+  }
 }
 
 
@@ -174,7 +204,7 @@ void JsonReporter::Impl::Process(Meter& meter) {
   auto event_type = meter.event_type();
   auto unit = FormatRateUnit(meter.rate_unit());
   out_ << "\"type\":\"meter\"," << std::endl
-       << "\"count\":" << meter.count() << "," << std::endl
+       << "\"count\":" << tracker_.Count(meter.count()) << "," << std::endl
        << "\"event_type\":\"" << event_type << "\"," << std::endl
        << "\"rate_unit\":\"" << unit << "\"," << std::endl
        << "\"mean_rate\":" << meter.mean_rate() << "," << std::endl
@@ -186,33 +216,32 @@ void JsonReporter::Impl::Process(Meter& meter) {
 
 void JsonReporter::Impl::Process(Histogram& histogram) {
   auto snapshot = histogram.GetSnapshot();
+  auto summary = Summarize(histogram, snapshot);
 #ifdef _WIN32
 #undef min
 #undef max
 #endif
   out_ << "\"type\":\"histogram\"," << std::endl
-       << "\"count\":" << histogram.count() << "," << std::endl
-       << "\"min\":" << histogram.min() << "," << std::endl
-       << "\"max\":" << histogram.max() << "," << std::endl
-       << "\"mean\":" << histogram.mean() << "," << std::endl
-       << "\"stddev\":" << histogram.std_dev() << "," << std::endl
-       << "\"sum\":" << histogram.sum() << "," << std::endl
-       << "\"median\":" << snapshot.getMedian() << "," << std::endl
-       << "\"75%\":" << snapshot.get75thPercentile() << "," << std::endl
-       << "\"95%\":" << snapshot.get95thPercentile() << "," << std::endl
-       << "\"98%\":" << snapshot.get98thPercentile() << "," << std::endl
-       << "\"99%\":" << snapshot.get99thPercentile() << "," << std::endl
-       << "\"99.9%\":" << snapshot.get999thPercentile() << "," << std::endl
-       << "\"100%\":" << snapshot.max() << std::endl;
+       << "\"count\":" << tracker_.Count(histogram.count()) << "," << std::endl
+       << "\"min\":" << summary.min << "," << std::endl
+       << "\"max\":" << summary.max << "," << std::endl
+       << "\"mean\":" << summary.mean << "," << std::endl
+       << "\"stddev\":" << summary.std_dev << "," << std::endl
+       << "\"sum\":" << histogram.sum() << "," << std::endl;
+  for (auto q : histogram.quantiles()) {
+    out_ << "\"" << FormatQuantile(q) << "\":" << snapshot.getValue(q) << "," << std::endl;
+  }
+  out_ << "\"100%\":" << snapshot.max() << std::endl;
 }
 
 
 void JsonReporter::Impl::Process(Timer& timer) {
   auto snapshot = timer.GetSnapshot();
+  auto summary = Summarize(timer, snapshot);
   auto rate_unit = FormatRateUnit(timer.rate_unit());
   auto duration_unit = FormatRateUnit(timer.duration_unit());
   out_ << "\"type\":\"timer\"," << std::endl
-       << "\"count\":" << timer.count() << "," << std::endl
+       << "\"count\":" << tracker_.Count(timer.count()) << "," << std::endl
        << "\"event_type\":\"" << timer.event_type() << "\"," << std::endl
        << "\"rate_unit\":\"" << rate_unit << "\"," << std::endl
        << "\"mean_rate\":" << timer.mean_rate() << "," << std::endl
@@ -220,18 +249,15 @@ void JsonReporter::Impl::Process(Timer& timer) {
        << "\"5_min_rate\":" << timer.five_minute_rate() << "," << std::endl
        << "\"15_min_rate\":" << timer.fifteen_minute_rate() << "," << std::endl
        << "\"duration_unit\":\"" << duration_unit << "\"," << std::endl
-       << "\"min\":" << timer.min() << "," << std::endl
-       << "\"max\":" << timer.max() << "," << std::endl
-       << "\"mean\":" << timer.mean() << "," << std::endl
-       << "\"stddev\":" << timer.std_dev() << "," << std::endl
-       << "\"sum\":" << timer.sum() << "," << std::endl
-       << "\"median\":" << snapshot.getMedian() << "," << std::endl
-       << "\"75%\":" << snapshot.get75thPercentile() << "," << std::endl
-       << "\"95%\":" << snapshot.get95thPercentile() << "," << std::endl
-       << "\"98%\":" << snapshot.get98thPercentile() << "," << std::endl
-       << "\"99%\":" << snapshot.get99thPercentile() << "," << std::endl
-       << "\"99.9%\":" << snapshot.get999thPercentile() << "," << std::endl
-       << "\"100%\":" << snapshot.max() << std::endl;
+       << "\"min\":" << summary.min << "," << std::endl
+       << "\"max\":" << summary.max << "," << std::endl
+       << "\"mean\":" << summary.mean << "," << std::endl
+       << "\"stddev\":" << summary.std_dev << "," << std::endl
+       << "\"sum\":" << timer.sum() << "," << std::endl;
+  for (auto q : timer.quantiles()) {
+    out_ << "\"" << FormatQuantile(q) << "\":" << snapshot.getValue(q) << "," << std::endl;
+  }
+  out_ << "\"100%\":" << snapshot.max() << std::endl;
 }
 
 void
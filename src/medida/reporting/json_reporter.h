@@ -10,16 +10,22 @@
 
 #include "medida/metric_processor.h"
 #include "medida/metrics_registry.h"
+#include "medida/reporting/temporality.h"
 
 namespace medida {
 namespace reporting {
 
+// Reports the registry's metrics, or the given ones, as a JSON document.
+// With a Temporality other than kCumulative, metrics that have not been
+// updated since the last Report() are left out.
 class JsonReporter : public MetricProcessor {
  public:
-  JsonReporter(MetricsRegistry &registry);
-  JsonReporter(std::map<MetricName, std::shared_ptr<MetricInterface>> const& metricsToReport);
+  JsonReporter(MetricsRegistry &registry, Temporality temporality = Temporality::kCumulative);
+  JsonReporter(std::map<MetricName, std::shared_ptr<MetricInterface>> const& metricsToReport,
+               Temporality temporality = Temporality::kCumulative);
   virtual ~JsonReporter();
   virtual void Process(Counter& counter);
+  virtual void Process(Gauge& gauge);
   virtual void Process(Meter& meter);
   virtual void Process(Histogram& histogram);
   virtual void Process(Timer& timer);
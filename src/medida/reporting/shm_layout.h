@@ -0,0 +1,99 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_REPORTING_SHM_LAYOUT_H_
+#define MEDIDA_REPORTING_SHM_LAYOUT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace medida {
+namespace reporting {
+namespace shm {
+
+// The binary layout ShmReporter publishes and ShmReader decodes. It is
+// shared only between processes on one host, so fields are in native byte
+// order. Any change to it must bump kVersion.
+//
+// A segment is a Header, then `capacity` DirectoryEntry records, then
+// `capacity` ValueEntry records; entry i of each describes the same metric.
+// The sizes recorded in the header locate both tables.
+//
+// The directory only grows: an entry, and its values, are fully written
+// before `count` is raised past it, and after that only its `type` may
+// change, to kRemoved and back. Values are guarded by a seqlock each. The
+// writer makes the sequence odd, stores the values, then makes it even
+// again; a reader copies the values between two reads of an even sequence
+// and retries if they differ.
+
+const char kMagic[8] = {'M', 'E', 'D', 'I', 'D', 'A', 'S', 'H'};
+const std::uint32_t kVersion = 1;
+
+const std::size_t kMaxValues = 16;
+const std::size_t kMaxNameLength = 232;
+
+enum MetricType : std::uint32_t {
+  kRemoved = 0,
+  kCounter = 1,
+  kGauge = 2,
+  kMeter = 3,
+  kHistogram = 4,
+  kTimer = 5,
+};
+
+// Values each type publishes, in order. Rates are per the entry's rate
+// unit and durations in its duration unit.
+//   counter:   count
+//   gauge:     value
+//   meter:     count, mean_rate, 1m_rate, 5m_rate, 15m_rate
+//   histogram: count, min, max, mean, std_dev, sum,
+//              p50, p75, p95, p98, p99, p999
+//   timer:     count, mean_rate, 1m_rate, 5m_rate, 15m_rate,
+//              min, max, mean, std_dev, sum, p50, p75, p95, p98, p99, p999
+// min, max, mean and std_dev are those of the snapshot the quantiles come
+// from for a windowed histogram or timer (see SamplingInterface::windowed).
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t header_size;
+  std::uint32_t directory_entry_size;
+  std::uint32_t value_entry_size;
+  std::uint32_t capacity;
+  // Directory entries published so far.
+  std::atomic<std::uint32_t> count;
+  // Metrics left out for want of room.
+  std::atomic<std::uint32_t> dropped;
+  // Set once the writer has moved on to a new segment at the same path.
+  std::atomic<std::uint32_t> superseded;
+  std::uint64_t pid;
+  // System clock times, in nanoseconds since the epoch.
+  std::uint64_t created;
+  std::atomic<std::uint64_t> last_published;
+};
+
+struct DirectoryEntry {
+  std::atomic<std::uint32_t> type;
+  std::uint32_t name_length;
+  std::int64_t duration_unit_ns;
+  std::int64_t rate_unit_ns;
+  // MetricName::ToString(), not NUL-terminated.
+  char name[kMaxNameLength];
+};
+
+struct ValueEntry {
+  std::atomic<std::uint64_t> sequence;
+  std::atomic<double> values[kMaxValues];
+};
+
+static_assert(sizeof(Header) == 64, "the shm header layout is fixed");
+static_assert(sizeof(DirectoryEntry) == 256, "the shm directory layout is fixed");
+static_assert(sizeof(ValueEntry) == 136, "the shm value layout is fixed");
+
+} // namespace shm
+} // namespace reporting
+} // namespace medida
+
+#endif // MEDIDA_REPORTING_SHM_LAYOUT_H_
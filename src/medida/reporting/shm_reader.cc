@@ -0,0 +1,223 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/shm_reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace medida {
+namespace reporting {
+
+namespace {
+
+// A writer that died mid-update leaves its sequence odd for good; give up
+// on the metric after this many tries rather than spin forever.
+const int kMaxReadAttempts = 1000;
+
+} // namespace
+
+
+class ShmReader::Impl {
+ public:
+  Impl(const std::string& path);
+  ~Impl();
+  std::vector<Metric> Read() const;
+  const shm::Header& header() const;
+ private:
+  void* base_;
+  std::size_t size_;
+  const shm::Header* header_;
+  const char* directory_;
+  const char* values_;
+  bool ReadValues(std::uint32_t index, std::size_t n, std::vector<double>& out) const;
+};
+
+
+ShmReader::ShmReader(const std::string& path)
+    : impl_ {new ShmReader::Impl {path}} {
+}
+
+
+ShmReader::~ShmReader() {
+}
+
+
+std::vector<ShmReader::Metric> ShmReader::Read() const {
+  return impl_->Read();
+}
+
+
+std::uint64_t ShmReader::pid() const {
+  return impl_->header().pid;
+}
+
+
+SystemClock::time_point ShmReader::last_published() const {
+  auto nanos = impl_->header().last_published.load(std::memory_order_acquire);
+  return SystemClock::time_point(std::chrono::duration_cast<SystemClock::duration>(
+      std::chrono::nanoseconds(nanos)));
+}
+
+
+std::uint32_t ShmReader::dropped() const {
+  return impl_->header().dropped.load(std::memory_order_relaxed);
+}
+
+
+bool ShmReader::superseded() const {
+  return impl_->header().superseded.load(std::memory_order_acquire) != 0;
+}
+
+
+const std::vector<std::string>& ShmReader::FieldNames(shm::MetricType type) {
+  static const std::vector<std::string> none;
+  static const std::vector<std::string> counter {"count"};
+  static const std::vector<std::string> gauge {"value"};
+  static const std::vector<std::string> meter {
+    "count", "mean_rate", "1m_rate", "5m_rate", "15m_rate",
+  };
+  static const std::vector<std::string> histogram {
+    "count", "min", "max", "mean", "std_dev", "sum",
+    "p50", "p75", "p95", "p98", "p99", "p999",
+  };
+  static const std::vector<std::string> timer {
+    "count", "mean_rate", "1m_rate", "5m_rate", "15m_rate",
+    "min", "max", "mean", "std_dev", "sum",
+    "p50", "p75", "p95", "p98", "p99", "p999",
+  };
+  switch (type) {
+    case shm::kCounter: return counter;
+    case shm::kGauge: return gauge;
+    case shm::kMeter: return meter;
+    case shm::kHistogram: return histogram;
+    case shm::kTimer: return timer;
+    default: return none;
+  }
+}
+
+
+std::string ShmReader::TypeName(shm::MetricType type) {
+  switch (type) {
+    case shm::kRemoved: return "removed";
+    case shm::kCounter: return "counter";
+    case shm::kGauge: return "gauge";
+    case shm::kMeter: return "meter";
+    case shm::kHistogram: return "histogram";
+    case shm::kTimer: return "timer";
+    default: return "unknown";
+  }
+}
+
+
+// === Implementation ===
+
+
+ShmReader::Impl::Impl(const std::string& path) {
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    std::stringstream ss;
+    ss << "Cannot open " << path << " (" << errno << "): " << strerror(errno);
+    throw std::runtime_error(ss.str());
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(shm::Header)) {
+    close(fd);
+    throw std::invalid_argument(path + " is not a medida shm segment");
+  }
+  size_ = st.st_size;
+  base_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base_ == MAP_FAILED) {
+    std::stringstream ss;
+    ss << "Cannot map " << path << " (" << errno << "): " << strerror(errno);
+    throw std::runtime_error(ss.str());
+  }
+
+  header_ = static_cast<const shm::Header*>(base_);
+  auto& h = *header_;
+  auto tables = std::uint64_t {h.capacity} * (std::uint64_t {h.directory_entry_size} + h.value_entry_size);
+  if (std::memcmp(h.magic, shm::kMagic, sizeof(shm::kMagic)) != 0 ||
+      h.version != shm::kVersion ||
+      h.header_size < sizeof(shm::Header) ||
+      h.directory_entry_size < sizeof(shm::DirectoryEntry) ||
+      h.value_entry_size < sizeof(shm::ValueEntry) ||
+      h.header_size + tables > size_) {
+    munmap(base_, size_);
+    throw std::invalid_argument(path + " is not a medida shm segment of version " +
+                                std::to_string(shm::kVersion));
+  }
+  directory_ = static_cast<const char*>(base_) + h.header_size;
+  values_ = directory_ + std::size_t {h.capacity} * h.directory_entry_size;
+}
+
+
+ShmReader::Impl::~Impl() {
+  munmap(base_, size_);
+}
+
+
+const shm::Header& ShmReader::Impl::header() const {
+  return *header_;
+}
+
+
+std::vector<ShmReader::Metric> ShmReader::Impl::Read() const {
+  std::vector<Metric> metrics;
+  auto count = std::min(header_->count.load(std::memory_order_acquire), header_->capacity);
+  metrics.reserve(count);
+  for (std::uint32_t i = 0; i < count; i++) {
+    auto& entry = *reinterpret_cast<const shm::DirectoryEntry*>(
+        directory_ + std::size_t {i} * header_->directory_entry_size);
+    auto type = static_cast<shm::MetricType>(entry.type.load(std::memory_order_acquire));
+    auto& fields = ShmReader::FieldNames(type);
+    if (fields.empty()) {
+      continue;
+    }
+    Metric m;
+    m.name.assign(entry.name, std::min<std::size_t>(entry.name_length, shm::kMaxNameLength));
+    m.type = type;
+    m.duration_unit = std::chrono::nanoseconds(entry.duration_unit_ns);
+    m.rate_unit = std::chrono::nanoseconds(entry.rate_unit_ns);
+    if (ReadValues(i, fields.size(), m.values)) {
+      metrics.push_back(std::move(m));
+    }
+  }
+  return metrics;
+}
+
+
+bool ShmReader::Impl::ReadValues(std::uint32_t index, std::size_t n,
+                                 std::vector<double>& out) const {
+  auto& entry = *reinterpret_cast<const shm::ValueEntry*>(
+      values_ + std::size_t {index} * header_->value_entry_size);
+  out.resize(n);
+  for (int attempt = 0; attempt < kMaxReadAttempts; attempt++) {
+    auto before = entry.sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+      out[i] = entry.values[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.sequence.load(std::memory_order_relaxed) == before) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+} // namespace reporting
+} // namespace medida
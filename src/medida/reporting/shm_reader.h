@@ -0,0 +1,59 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_REPORTING_SHM_READER_H_
+#define MEDIDA_REPORTING_SHM_READER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "medida/reporting/shm_layout.h"
+#include "medida/types.h"
+
+namespace medida {
+namespace reporting {
+
+// Reads the segment a ShmReporter publishes, from any process on the host.
+// It maps the file read-only and never blocks the writer; a metric caught
+// mid-update is read again. It is built into its own small library,
+// medida_shm_reader, so that agents need not link the rest of medida.
+//
+// The constructor throws std::runtime_error if the file cannot be opened
+// and std::invalid_argument if it is not a segment of a known version.
+class ShmReader {
+ public:
+  struct Metric {
+    std::string name;
+    shm::MetricType type;
+    std::chrono::nanoseconds duration_unit;
+    std::chrono::nanoseconds rate_unit;
+    // As listed in shm_layout.h for the type, and named by FieldNames.
+    std::vector<double> values;
+  };
+
+  explicit ShmReader(const std::string& path);
+  ~ShmReader();
+  // Every metric published and not removed.
+  std::vector<Metric> Read() const;
+  std::uint64_t pid() const;
+  SystemClock::time_point last_published() const;
+  std::uint32_t dropped() const;
+  // Whether the writer has since replaced this segment with a new one at
+  // the same path, which a new reader would see.
+  bool superseded() const;
+
+  static const std::vector<std::string>& FieldNames(shm::MetricType type);
+  static std::string TypeName(shm::MetricType type);
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace reporting
+} // namespace medida
+
+#endif // MEDIDA_REPORTING_SHM_READER_H_
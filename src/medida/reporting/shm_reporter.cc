@@ -0,0 +1,349 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/shm_reporter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "medida/reporting/shm_layout.h"
+#include "medida/reporting/util.h"
+
+namespace medida {
+namespace reporting {
+
+class ShmReporter::Impl {
+ public:
+  Impl(ShmReporter& self, MetricsRegistry &registry, const std::string& path,
+       std::uint32_t capacity);
+  ~Impl();
+  void Run();
+  void Process(Counter& counter);
+  void Process(Gauge& gauge);
+  void Process(Meter& meter);
+  void Process(Histogram& histogram);
+  void Process(Timer& timer);
+ private:
+  ShmReporter& self_;
+  MetricsRegistry& registry_;
+  const std::string path_;
+  const std::uint32_t capacity_;
+  std::mutex mutex_;
+  void* base_;
+  std::size_t size_;
+  ino_t inode_;
+  shm::Header* header_;
+  shm::DirectoryEntry* directory_;
+  shm::ValueEntry* values_;
+  // Directory index of every metric name in the segment.
+  std::map<std::string, std::uint32_t> slots_;
+  std::vector<bool> seen_;
+  std::uint32_t removed_;
+  std::uint32_t dropped_;
+  std::string current_name_;
+  void CreateSegment();
+  void ReleaseSegment();
+  void Publish(shm::MetricType type, std::chrono::nanoseconds duration_unit,
+               std::chrono::nanoseconds rate_unit, std::initializer_list<double> values);
+};
+
+
+ShmReporter::ShmReporter(MetricsRegistry &registry, const std::string& path,
+                         std::uint32_t capacity)
+    : AbstractPollingReporter(),
+      impl_ {new ShmReporter::Impl {*this, registry, path, capacity}} {
+}
+
+
+ShmReporter::~ShmReporter() {
+  // Stop the polling thread before the segment goes away under it.
+  Shutdown();
+}
+
+
+void ShmReporter::Run() {
+  impl_->Run();
+}
+
+
+void ShmReporter::Process(Counter& counter) {
+  impl_->Process(counter);
+}
+
+
+void ShmReporter::Process(Gauge& gauge) {
+  impl_->Process(gauge);
+}
+
+
+void ShmReporter::Process(Meter& meter) {
+  impl_->Process(meter);
+}
+
+
+void ShmReporter::Process(Histogram& histogram) {
+  impl_->Process(histogram);
+}
+
+
+void ShmReporter::Process(Timer& timer) {
+  impl_->Process(timer);
+}
+
+
+// === Implementation ===
+
+
+namespace {
+
+std::uint64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      SystemClock::now().time_since_epoch()).count();
+}
+
+std::runtime_error SystemError(const std::string& what, const std::string& path) {
+  std::stringstream ss;
+  ss << what << " " << path << " (" << errno << "): " << strerror(errno);
+  return std::runtime_error(ss.str());
+}
+
+} // namespace
+
+
+ShmReporter::Impl::Impl(ShmReporter& self, MetricsRegistry &registry, const std::string& path,
+                        std::uint32_t capacity)
+    : self_     (self),
+      registry_ (registry),
+      path_     (path),
+      capacity_ (capacity),
+      base_     (nullptr) {
+  if (capacity == 0) {
+    throw std::invalid_argument("a shm segment needs room for at least one metric");
+  }
+  CreateSegment();
+}
+
+
+ShmReporter::Impl::~Impl() {
+  // Remove the file only if it is still the one this reporter made.
+  struct stat st;
+  if (stat(path_.c_str(), &st) == 0 && st.st_ino == inode_) {
+    unlink(path_.c_str());
+  }
+  munmap(base_, size_);
+}
+
+
+void ShmReporter::Impl::CreateSegment() {
+  auto temp = path_ + ".tmp." + std::to_string(getpid());
+  auto fd = open(temp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    throw SystemError("Cannot create", temp);
+  }
+  auto size = sizeof(shm::Header) +
+      std::size_t {capacity_} * (sizeof(shm::DirectoryEntry) + sizeof(shm::ValueEntry));
+  struct stat st;
+  if (ftruncate(fd, size) != 0 || fstat(fd, &st) != 0) {
+    auto error = SystemError("Cannot size", temp);
+    close(fd);
+    unlink(temp.c_str());
+    throw error;
+  }
+  // The file starts out zeroed, which is a valid empty segment apart from
+  // the header fields set below.
+  auto base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    unlink(temp.c_str());
+    throw SystemError("Cannot map", temp);
+  }
+
+  auto header = static_cast<shm::Header*>(base);
+  header->version = shm::kVersion;
+  header->header_size = sizeof(shm::Header);
+  header->directory_entry_size = sizeof(shm::DirectoryEntry);
+  header->value_entry_size = sizeof(shm::ValueEntry);
+  header->capacity = capacity_;
+  header->pid = getpid();
+  header->created = NowNanos();
+  std::memcpy(header->magic, shm::kMagic, sizeof(shm::kMagic));
+  if (rename(temp.c_str(), path_.c_str()) != 0) {
+    auto error = SystemError("Cannot publish", path_);
+    munmap(base, size);
+    unlink(temp.c_str());
+    throw error;
+  }
+
+  if (base_) {
+    ReleaseSegment();
+  }
+  base_ = base;
+  size_ = size;
+  inode_ = st.st_ino;
+  header_ = header;
+  directory_ = reinterpret_cast<shm::DirectoryEntry*>(static_cast<char*>(base) + sizeof(shm::Header));
+  values_ = reinterpret_cast<shm::ValueEntry*>(directory_ + capacity_);
+  slots_.clear();
+  seen_.assign(capacity_, false);
+  removed_ = 0;
+}
+
+
+void ShmReporter::Impl::ReleaseSegment() {
+  header_->superseded.store(1, std::memory_order_release);
+  munmap(base_, size_);
+}
+
+
+void ShmReporter::Impl::Run() {
+  std::lock_guard<std::mutex> lock {mutex_};
+  if (removed_ > 0 && slots_.size() == capacity_) {
+    CreateSegment();
+  }
+  std::fill(seen_.begin(), seen_.end(), false);
+  dropped_ = 0;
+  auto metrics = registry_.GetAllMetricsShared();
+  for (auto& kv : *metrics) {
+    current_name_ = kv.first.ToString();
+    kv.second->Process(self_);
+  }
+  for (auto& kv : slots_) {
+    auto& type = directory_[kv.second].type;
+    if (!seen_[kv.second] && type.load(std::memory_order_relaxed) != shm::kRemoved) {
+      type.store(shm::kRemoved, std::memory_order_release);
+      removed_++;
+    }
+  }
+  header_->dropped.store(dropped_, std::memory_order_relaxed);
+  header_->last_published.store(NowNanos(), std::memory_order_release);
+}
+
+
+void ShmReporter::Impl::Publish(shm::MetricType type, std::chrono::nanoseconds duration_unit,
+                                std::chrono::nanoseconds rate_unit,
+                                std::initializer_list<double> values) {
+  std::uint32_t index;
+  auto slot = slots_.find(current_name_);
+  auto fresh = slot == slots_.end();
+  if (fresh) {
+    if (slots_.size() == capacity_ || current_name_.size() > shm::kMaxNameLength) {
+      dropped_++;
+      return;
+    }
+    index = slots_.size();
+    auto& entry = directory_[index];
+    entry.type.store(type, std::memory_order_relaxed);
+    entry.name_length = current_name_.size();
+    entry.duration_unit_ns = duration_unit.count();
+    entry.rate_unit_ns = rate_unit.count();
+    std::memcpy(entry.name, current_name_.data(), current_name_.size());
+  } else {
+    index = slot->second;
+    auto& entry_type = directory_[index].type;
+    auto old_type = entry_type.load(std::memory_order_relaxed);
+    if (old_type != type) {
+      if (old_type == shm::kRemoved) {
+        removed_--;
+      }
+      entry_type.store(type, std::memory_order_release);
+    }
+  }
+  seen_[index] = true;
+
+  auto& entry = values_[index];
+  auto sequence = entry.sequence.load(std::memory_order_relaxed);
+  entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::size_t i = 0;
+  for (auto v : values) {
+    entry.values[i++].store(v, std::memory_order_relaxed);
+  }
+  entry.sequence.store(sequence + 2, std::memory_order_release);
+
+  if (fresh) {
+    slots_.emplace(current_name_, index);
+    header_->count.store(index + 1, std::memory_order_release);
+  }
+}
+
+
+void ShmReporter::Impl::Process(Counter& counter) {
+  Publish(shm::kCounter, std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero(),
+          {static_cast<double>(counter.count())});
+}
+
+
+void ShmReporter::Impl::Process(Gauge& gauge) {
+  Publish(shm::kGauge, std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero(),
+          {gauge.value()});
+}
+
+
+void ShmReporter::Impl::Process(Meter& meter) {
+  Publish(shm::kMeter, std::chrono::nanoseconds::zero(), meter.rate_unit(), {
+    static_cast<double>(meter.count()),
+    meter.mean_rate(),
+    meter.one_minute_rate(),
+    meter.five_minute_rate(),
+    meter.fifteen_minute_rate(),
+  });
+}
+
+
+void ShmReporter::Impl::Process(Histogram& histogram) {
+  auto snapshot = histogram.GetSnapshot();
+  auto summary = Summarize(histogram, snapshot);
+  Publish(shm::kHistogram, std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero(), {
+    static_cast<double>(histogram.count()),
+    summary.min,
+    summary.max,
+    summary.mean,
+    summary.std_dev,
+    histogram.sum(),
+    snapshot.getMedian(),
+    snapshot.get75thPercentile(),
+    snapshot.get95thPercentile(),
+    snapshot.get98thPercentile(),
+    snapshot.get99thPercentile(),
+    snapshot.get999thPercentile(),
+  });
+}
+
+
+void ShmReporter::Impl::Process(Timer& timer) {
+  auto snapshot = timer.GetSnapshot();
+  auto summary = Summarize(timer, snapshot);
+  Publish(shm::kTimer, timer.duration_unit(), timer.rate_unit(), {
+    static_cast<double>(timer.count()),
+    timer.mean_rate(),
+    timer.one_minute_rate(),
+    timer.five_minute_rate(),
+    timer.fifteen_minute_rate(),
+    summary.min,
+    summary.max,
+    summary.mean,
+    summary.std_dev,
+    timer.sum(),
+    snapshot.getMedian(),
+    snapshot.get75thPercentile(),
+    snapshot.get95thPercentile(),
+    snapshot.get98thPercentile(),
+    snapshot.get99thPercentile(),
+    snapshot.get999thPercentile(),
+  });
+}
+
+
+} // namespace reporting
+} // namespace medida
@@ -0,0 +1,55 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_REPORTING_SHM_REPORTER_H_
+#define MEDIDA_REPORTING_SHM_REPORTER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "medida/metric_processor.h"
+#include "medida/metrics_registry.h"
+#include "medida/reporting/abstract_polling_reporter.h"
+
+namespace medida {
+namespace reporting {
+
+// Publishes counter, gauge, meter, histogram and timer summaries as raw
+// doubles into a memory-mapped file, laid out as in shm_layout.h, for an
+// out-of-process agent to read with ShmReader. Each Run() only stores
+// numbers; all formatting is left to the reader.
+//
+// The file is built under a temporary name and renamed into place, so a
+// reader never sees a partial header. Room is reserved up front for
+// `capacity` metrics. Metrics removed from the registry are marked so in
+// the directory; when the directory is full and some of its entries are
+// removed, the next Run() starts a fresh segment at the same path and
+// flags the old one as superseded. Metrics that find no room, or whose
+// names are longer than shm::kMaxNameLength, are counted as dropped.
+//
+// The constructor throws std::runtime_error if the file cannot be created,
+// and the destructor removes it.
+class ShmReporter : public AbstractPollingReporter, public MetricProcessor {
+ public:
+  ShmReporter(MetricsRegistry &registry,
+              const std::string& path = "/dev/shm/medida",
+              std::uint32_t capacity = 32768);
+  virtual ~ShmReporter();
+  virtual void Run();
+  virtual void Process(Counter& counter);
+  virtual void Process(Gauge& gauge);
+  virtual void Process(Meter& meter);
+  virtual void Process(Histogram& histogram);
+  virtual void Process(Timer& timer);
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+
+} // namespace reporting
+} // namespace medida
+
+#endif // MEDIDA_REPORTING_SHM_REPORTER_H_
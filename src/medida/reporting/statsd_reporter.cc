@@ -0,0 +1,340 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/statsd_reporter.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __FreeBSD__
+#include <netinet/in.h>
+#endif
+
+#include "medida/reporting/util.h"
+#include "medida/stats/snapshot.h"
+
+namespace medida {
+namespace reporting {
+
+class StatsdReporter::Impl {
+ public:
+  Impl(StatsdReporter& self, MetricsRegistry &registry, const std::string& hostname,
+       std::uint16_t port, std::size_t max_datagram_size, bool tagged);
+  ~Impl();
+  void Run();
+  void Process(Counter& counter);
+  void Process(Gauge& gauge);
+  void Process(Meter& meter);
+  void Process(Histogram& histogram);
+  void Process(Timer& timer);
+ private:
+  // What is kept per metric between runs.
+  struct State {
+    std::string name;
+    // "|#scope:..." or empty.
+    std::string tags;
+    // Count as of the last run, which the next delta is taken from.
+    std::int64_t count;
+  };
+  StatsdReporter& self_;
+  MetricsRegistry& registry_;
+  const bool tagged_;
+  std::mutex mutex_;
+  struct addrinfo *addrinfo_;
+  int socket_;
+  // The datagram being filled; its first `used_` bytes are pending.
+  std::vector<char> buffer_;
+  std::size_t used_;
+  std::string line_;
+  std::map<MetricName, State> states_;
+  State* current_;
+  void AddCount(const char* suffix, std::int64_t count);
+  void AddGauge(const char* suffix, double value);
+  void AddGauge(const std::string& suffix, double value);
+  void AddRates(double mean, double m1, double m5, double m15);
+  void AddSummary(const Summary& summary, double sum, const stats::Snapshot& snapshot,
+                  const std::vector<double>& quantiles);
+  void AddLine(const char* suffix, std::size_t suffix_size, const char* value, char type);
+  void Send(const char* data, std::size_t size);
+  void Flush();
+};
+
+
+StatsdReporter::StatsdReporter(MetricsRegistry &registry, const std::string& hostname,
+                               std::uint16_t port, std::size_t max_datagram_size, bool tagged)
+    : AbstractPollingReporter(),
+      impl_ {new StatsdReporter::Impl {*this, registry, hostname, port, max_datagram_size, tagged}} {
+}
+
+
+StatsdReporter::~StatsdReporter() {
+  // Stop the polling thread before the socket goes away under it.
+  Shutdown();
+}
+
+
+void StatsdReporter::Run() {
+  impl_->Run();
+}
+
+
+void StatsdReporter::Process(Counter& counter) {
+  impl_->Process(counter);
+}
+
+
+void StatsdReporter::Process(Gauge& gauge) {
+  impl_->Process(gauge);
+}
+
+
+void StatsdReporter::Process(Meter& meter) {
+  impl_->Process(meter);
+}
+
+
+void StatsdReporter::Process(Histogram& histogram) {
+  impl_->Process(histogram);
+}
+
+
+void StatsdReporter::Process(Timer& timer) {
+  impl_->Process(timer);
+}
+
+
+// === Implementation ===
+
+
+namespace {
+
+// ':', '|' and '@' delimit the fields of a line and '#' starts the tags;
+// ',' separates tags.
+std::string Sanitize(const std::string& text) {
+  auto clean = text;
+  for (auto& c : clean) {
+    if (c == ':' || c == '|' || c == '@' || c == '#' || c == ',' || c == '\n') {
+      c = '_';
+    }
+  }
+  return clean;
+}
+
+} // namespace
+
+
+StatsdReporter::Impl::Impl(StatsdReporter& self, MetricsRegistry &registry,
+                           const std::string& hostname, std::uint16_t port,
+                           std::size_t max_datagram_size, bool tagged)
+    : self_     (self),
+      registry_ (registry),
+      tagged_   (tagged),
+      buffer_   (max_datagram_size),
+      used_     (0),
+      current_  (nullptr) {
+  if (max_datagram_size == 0) {
+    throw std::invalid_argument("a statsd datagram must have room for at least one byte");
+  }
+  struct addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  auto port_str = std::to_string(port);
+  auto err = getaddrinfo(hostname.c_str(), port_str.c_str(), &hints, &addrinfo_);
+  if (err != 0) {
+    throw std::invalid_argument("getaddrinfo error: " + std::string(gai_strerror(err)));
+  }
+  socket_ = socket(addrinfo_->ai_family, addrinfo_->ai_socktype, addrinfo_->ai_protocol);
+  if (socket_ == -1) {
+    std::stringstream ss;
+    ss << "Socket error (" << errno << "): " << strerror(errno);
+    freeaddrinfo(addrinfo_);
+    throw std::runtime_error(ss.str());
+  }
+}
+
+
+StatsdReporter::Impl::~Impl() {
+  close(socket_);
+  freeaddrinfo(addrinfo_);
+}
+
+
+void StatsdReporter::Impl::Run() {
+  std::lock_guard<std::mutex> lock {mutex_};
+  // Both maps are in name order, so walk them together, dropping the
+  // state of metrics that have gone and adding it for new ones.
+  auto state = states_.begin();
+  auto metrics = registry_.GetAllMetricsShared();
+  for (auto& kv : *metrics) {
+    auto& name = kv.first;
+    while (state != states_.end() && state->first < name) {
+      state = states_.erase(state);
+    }
+    if (state == states_.end() || state->first != name) {
+      State fresh;
+      fresh.count = 0;
+      if (tagged_) {
+        fresh.name = Sanitize(name.domain() + "." + name.type() + "." + name.name());
+        if (name.has_scope()) {
+          fresh.tags = "|#scope:" + Sanitize(name.scope());
+        }
+      } else {
+        fresh.name = Sanitize(name.ToString());
+      }
+      state = states_.emplace_hint(state, name, std::move(fresh));
+    }
+    current_ = &state->second;
+    kv.second->Process(self_);
+    ++state;
+  }
+  states_.erase(state, states_.end());
+  current_ = nullptr;
+  Flush();
+}
+
+
+void StatsdReporter::Impl::Process(Counter& counter) {
+  AddCount("", counter.count());
+}
+
+
+void StatsdReporter::Impl::Process(Gauge& gauge) {
+  AddGauge("", gauge.value());
+}
+
+
+void StatsdReporter::Impl::Process(Meter& meter) {
+  AddCount(".count", meter.count());
+  AddRates(meter.mean_rate(), meter.one_minute_rate(), meter.five_minute_rate(),
+           meter.fifteen_minute_rate());
+}
+
+
+void StatsdReporter::Impl::Process(Histogram& histogram) {
+  AddCount(".count", histogram.count());
+  auto snapshot = histogram.GetSnapshot();
+  AddSummary(Summarize(histogram, snapshot), histogram.sum(), snapshot, histogram.quantiles());
+}
+
+
+void StatsdReporter::Impl::Process(Timer& timer) {
+  AddCount(".count", timer.count());
+  AddRates(timer.mean_rate(), timer.one_minute_rate(), timer.five_minute_rate(),
+           timer.fifteen_minute_rate());
+  auto snapshot = timer.GetSnapshot();
+  AddSummary(Summarize(timer, snapshot), timer.sum(), snapshot, timer.quantiles());
+}
+
+
+void StatsdReporter::Impl::AddCount(const char* suffix, std::int64_t count) {
+  auto delta = count - current_->count;
+  current_->count = count;
+  if (delta == 0) {
+    return;
+  }
+  char value[32];
+  std::snprintf(value, sizeof(value), "%" PRId64, delta);
+  AddLine(suffix, std::strlen(suffix), value, 'c');
+}
+
+
+void StatsdReporter::Impl::AddGauge(const char* suffix, double value) {
+  // StatsD has no representation for these.
+  if (!std::isfinite(value)) {
+    return;
+  }
+  auto suffix_size = std::strlen(suffix);
+  // A signed gauge value is taken as a change to the last one, so a
+  // negative value has to follow a zero.
+  if (value < 0) {
+    AddLine(suffix, suffix_size, "0", 'g');
+  }
+  char digits[32];
+  std::snprintf(digits, sizeof(digits), "%.15g", value);
+  AddLine(suffix, suffix_size, digits, 'g');
+}
+
+
+void StatsdReporter::Impl::AddGauge(const std::string& suffix, double value) {
+  AddGauge(suffix.c_str(), value);
+}
+
+
+void StatsdReporter::Impl::AddRates(double mean, double m1, double m5, double m15) {
+  AddGauge(".mean_rate", mean);
+  AddGauge(".m1_rate", m1);
+  AddGauge(".m5_rate", m5);
+  AddGauge(".m15_rate", m15);
+}
+
+
+void StatsdReporter::Impl::AddSummary(const Summary& summary, double sum,
+                                      const stats::Snapshot& snapshot,
+                                      const std::vector<double>& quantiles) {
+  AddGauge(".min", summary.min);
+  AddGauge(".max", summary.max);
+  AddGauge(".mean", summary.mean);
+  AddGauge(".std_dev", summary.std_dev);
+  AddGauge(".sum", sum);
+  for (auto q : quantiles) {
+    AddGauge("." + FormatQuantileKey(q), snapshot.getValue(q));
+  }
+}
+
+
+void StatsdReporter::Impl::AddLine(const char* suffix, std::size_t suffix_size,
+                                   const char* value, char type) {
+  line_.assign(current_->name);
+  line_.append(suffix, suffix_size);
+  line_ += ':';
+  line_.append(value);
+  line_ += '|';
+  line_ += type;
+  line_.append(current_->tags);
+
+  // Lines are newline-separated within a datagram, and never split across
+  // two. One too long for any datagram goes out on its own.
+  auto needed = line_.size() + (used_ > 0 ? 1 : 0);
+  if (used_ + needed > buffer_.size()) {
+    Flush();
+    if (line_.size() > buffer_.size()) {
+      Send(line_.data(), line_.size());
+      return;
+    }
+  }
+  if (used_ > 0) {
+    buffer_[used_++] = '\n';
+  }
+  std::memcpy(&buffer_[used_], line_.data(), line_.size());
+  used_ += line_.size();
+}
+
+
+void StatsdReporter::Impl::Send(const char* data, std::size_t size) {
+  sendto(socket_, data, size, 0, addrinfo_->ai_addr, addrinfo_->ai_addrlen);
+}
+
+
+void StatsdReporter::Impl::Flush() {
+  if (used_ > 0) {
+    Send(buffer_.data(), used_);
+    used_ = 0;
+  }
+}
+
+
+} // namespace reporting
+} // namespace medida
@@ -0,0 +1,66 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_REPORTING_STATSD_REPORTER_H_
+#define MEDIDA_REPORTING_STATSD_REPORTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "medida/metric_processor.h"
+#include "medida/metrics_registry.h"
+#include "medida/reporting/abstract_polling_reporter.h"
+
+namespace medida {
+namespace reporting {
+
+// Sends every metric to a StatsD agent over UDP, as plaintext lines packed
+// into datagrams of at most `max_datagram_size` bytes.
+//
+// StatsD aggregates counters itself, so counts go out as the change since
+// the previous Run() ("|c"); everything else is sent as gauges ("|g"):
+//   counter:   <name>:<delta>|c
+//   gauge:     <name>:<value>|g
+//   meter:     <name>.count|c, then <name>.mean_rate, .m1_rate, .m5_rate
+//              and .m15_rate as gauges, per the meter's rate unit
+//   histogram: <name>.count|c, then .min, .max, .mean, .std_dev, .sum and
+//              one .p<quantile> (p50, p99, p99_9, ...) per reported quantile
+//   timer:     all of the above, durations in the timer's duration unit
+// Counts that have not moved are left out. For a windowed histogram or
+// timer (see SamplingInterface::windowed), .min, .max, .mean and .std_dev
+// cover the same windows as the quantiles, and otherwise every value.
+//
+// <name> is MetricName::ToString(). With `tagged`, as DogStatsD expects,
+// the scope is left out of it and sent as a "|#scope:<scope>" tag instead.
+// Characters StatsD gives meaning to are replaced by '_'.
+//
+// The constructor throws std::invalid_argument if the host cannot be
+// resolved and std::runtime_error if no socket can be made. Send errors
+// are ignored, as is usual for StatsD.
+class StatsdReporter : public AbstractPollingReporter, public MetricProcessor {
+ public:
+  StatsdReporter(MetricsRegistry &registry,
+                 const std::string& hostname = "127.0.0.1",
+                 std::uint16_t port = 8125,
+                 std::size_t max_datagram_size = 1432,
+                 bool tagged = false);
+  virtual ~StatsdReporter();
+  virtual void Run();
+  virtual void Process(Counter& counter);
+  virtual void Process(Gauge& gauge);
+  virtual void Process(Meter& meter);
+  virtual void Process(Histogram& histogram);
+  virtual void Process(Timer& timer);
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+
+} // namespace reporting
+} // namespace medida
+
+#endif // MEDIDA_REPORTING_STATSD_REPORTER_H_
@@ -0,0 +1,89 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/temporality.h"
+
+namespace medida {
+namespace reporting {
+
+ChangeTracker::ChangeTracker(Temporality temporality)
+    : temporality_ {temporality},
+      first_ {true},
+      since_ {0},
+      epoch_ {0},
+      next_ {counts_.end()},
+      current_ {counts_.end()},
+      part_ {0} {
+}
+
+
+Temporality ChangeTracker::temporality() const {
+  return temporality_;
+}
+
+
+void ChangeTracker::Begin() {
+  if (temporality_ == Temporality::kCumulative) {
+    return;
+  }
+  since_ = epoch_;
+  epoch_ = MetricInterface::AdvanceEpoch();
+  next_ = counts_.begin();
+  current_ = counts_.end();
+}
+
+
+bool ChangeTracker::Visit(const MetricName& name, const MetricInterface& metric) {
+  if (temporality_ == Temporality::kCumulative) {
+    return true;
+  }
+  if (temporality_ == Temporality::kDelta) {
+    // Both are in name order, so the entries passed over are for metrics
+    // that have gone.
+    while (next_ != counts_.end() && next_->first < name) {
+      next_ = counts_.erase(next_);
+    }
+    if (next_ == counts_.end() || next_->first != name) {
+      next_ = counts_.emplace_hint(next_, name, std::vector<std::int64_t>());
+    }
+    current_ = next_++;
+    part_ = 0;
+  }
+  if (first_) {
+    return true;
+  }
+  // Epochs wrap, so compare their distance.
+  return static_cast<std::int32_t>(metric.last_touched() - since_) >= 0;
+}
+
+
+std::int64_t ChangeTracker::Count(std::int64_t total) {
+  if (temporality_ != Temporality::kDelta) {
+    return total;
+  }
+  auto& counts = current_->second;
+  if (part_ == counts.size()) {
+    counts.push_back(0);
+  }
+  auto delta = total - counts[part_];
+  counts[part_++] = total;
+  return delta;
+}
+
+
+void ChangeTracker::End() {
+  if (temporality_ == Temporality::kCumulative) {
+    return;
+  }
+  if (temporality_ == Temporality::kDelta) {
+    counts_.erase(next_, counts_.end());
+    next_ = counts_.end();
+    current_ = counts_.end();
+  }
+  first_ = false;
+}
+
+
+} // namespace reporting
+} // namespace medida
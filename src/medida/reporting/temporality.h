@@ -0,0 +1,74 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_REPORTING_TEMPORALITY_H_
+#define MEDIDA_REPORTING_TEMPORALITY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "medida/metric_interface.h"
+#include "medida/metric_name.h"
+
+namespace medida {
+namespace reporting {
+
+// What a report covers, relative to the report before it.
+enum class Temporality {
+  // Every metric, with counts since it was created.
+  kCumulative,
+  // Only metrics updated since the last report, with counts since created.
+  kChangedOnly,
+  // Only metrics updated since the last report, with counts since then.
+  kDelta,
+};
+
+
+// The bookkeeping behind a reporter's Temporality.
+//
+// Whether a metric has changed comes from its touch epoch (see
+// MetricInterface::last_touched). Begin() starts a new epoch, and a metric
+// counts as changed if it was touched in the epoch the previous report
+// began in or any later one; a metric updated while that report read it
+// is reported again rather than missed. Reading a callback gauge touches
+// it, so once reported those are in every report. Clear() counts as an
+// update, and shows up in kDelta counts as a drop.
+//
+// Metrics must be visited in name order, as GetAllMetrics lists them;
+// kDelta keeps each one's last count until a report passes it by.
+class ChangeTracker {
+ public:
+  explicit ChangeTracker(Temporality temporality = Temporality::kCumulative);
+  Temporality temporality() const;
+  // Starts a report.
+  void Begin();
+  // Whether `metric` belongs in this report. It becomes the metric that
+  // Count() refers to.
+  bool Visit(const MetricName& name, const MetricInterface& metric);
+  // The count to report for the metric last visited, given its `total`.
+  // A metric made of parts, such as Buckets, calls it once per part, in
+  // the same order every report.
+  std::int64_t Count(std::int64_t total);
+  // Ends a report, forgetting metrics it did not visit.
+  void End();
+ private:
+  const Temporality temporality_;
+  bool first_;
+  // The epoch the previous report began in, and this one.
+  std::uint32_t since_;
+  std::uint32_t epoch_;
+  // Last counts, by metric and part.
+  std::map<MetricName, std::vector<std::int64_t>> counts_;
+  std::map<MetricName, std::vector<std::int64_t>>::iterator next_;
+  std::map<MetricName, std::vector<std::int64_t>>::iterator current_;
+  std::size_t part_;
+};
+
+
+} // namespace reporting
+} // namespace medida
+
+#endif // MEDIDA_REPORTING_TEMPORALITY_H_
@@ -5,6 +5,7 @@
 #include "medida/reporting/util.h"
 
 #include <cstdint>
+#include <sstream>
 
 namespace medida {
 namespace reporting {
@@ -37,5 +38,30 @@ std::string FormatRateUnit(const std::chrono::nanoseconds& rate_unit) {
 }
 
 
+std::string FormatQuantile(double quantile) {
+  if (quantile == 0.5) {
+    return "median";
+  }
+  std::ostringstream ss;
+  ss.precision(6);
+  ss << quantile * 100 << "%";
+  return ss.str();
+}
+
+
+std::string FormatQuantileKey(double quantile) {
+  std::ostringstream ss;
+  ss.precision(6);
+  ss << "p" << quantile * 100;
+  auto key = ss.str();
+  for (auto& c : key) {
+    if (c == '.') {
+      c = '_';
+    }
+  }
+  return key;
+}
+
+
 } // namespace reporting
 } // namespace medida
@@ -8,11 +8,37 @@
 #include <chrono>
 #include <string>
 
+#include "medida/stats/snapshot.h"
+
 namespace medida {
 namespace reporting {
 
 std::string FormatRateUnit(const std::chrono::nanoseconds& rate_unit);
 
+// "median" for 0.5, otherwise the quantile as a percentage such as "99.9%".
+std::string FormatQuantile(double quantile);
+
+// The quantile as a metric path component: "p50", "p99", "p99_9", ...
+std::string FormatQuantileKey(double quantile);
+
+// The min, max, mean and std dev to report next to a snapshot's quantiles:
+// the snapshot's own for a windowed histogram or timer, so that all of
+// them cover the same windows, and lifetime values otherwise.
+struct Summary {
+  double min;
+  double max;
+  double mean;
+  double std_dev;
+};
+
+template <typename Metric>
+Summary Summarize(const Metric& metric, const stats::Snapshot& snapshot) {
+  if (metric.windowed()) {
+    return {snapshot.min(), snapshot.max(), snapshot.mean(), snapshot.std_dev()};
+  }
+  return {metric.min(), metric.max(), metric.mean(), metric.std_dev()};
+}
+
 } // namespace reporting
 } // namespace medida
 
@@ -5,15 +5,25 @@
 #ifndef MEDIDA_SAMPLING_INTERFACE_H_
 #define MEDIDA_SAMPLING_INTERFACE_H_
 
+#include <vector>
+
 #include "medida/stats/snapshot.h"
 
 namespace medida {
 
 class SamplingInterface {
 public:
-  enum SampleType { kUniform, kBiased, kSliding, kCKMS };
+  enum SampleType { kUniform, kBiased, kSliding, kCKMS, kDDSketch, kTDigest };
   virtual ~SamplingInterface() {};
   virtual stats::Snapshot GetSnapshot() const = 0;
+  // The quantiles reporters emit for this metric, in ascending order,
+  // before the max.
+  virtual std::vector<double> quantiles() const = 0;
+  // Whether snapshots cover recent windows, as CKMS, DDSketch and t-digest
+  // samples' do, rather than a reservoir drawn from every value. Reporters
+  // then take the min, max, mean and std dev from the snapshot too, so
+  // they describe the same values as the quantiles.
+  virtual bool windowed() const = 0;
 };
 
 } // namespace medida
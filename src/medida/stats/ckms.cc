@@ -17,22 +17,47 @@
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <stdexcept>
+
+#include "medida/encoding.h"
 
 namespace medida {
 namespace stats {
 
+static const char kMagic[] = {'C', 'K', 'M', '2'};
+
 // The default quantiles request the error be less than 0.1% (=0.001) for P99 and P50.
-std::vector<CKMS::Quantile> const kDefaultQuantiles = {{0.99, 0.001}, {0.5, 0.001}};
+static std::shared_ptr<const std::vector<CKMS::Quantile>> DefaultQuantiles() {
+  static auto const quantiles = std::make_shared<const std::vector<CKMS::Quantile>>(
+      std::vector<CKMS::Quantile> {{0.99, 0.001}, {0.5, 0.001}});
+  return quantiles;
+}
 
-CKMS::CKMS() : CKMS(kDefaultQuantiles) {
+CKMS::CKMS() : CKMS(DefaultQuantiles()) {
 }
 
 std::size_t CKMS::count() const {
-    return count_ + buffer_count_;
+    return count_ + buffer_.size();
+}
+
+double CKMS::min() const {
+    return moments_.min();
 }
 
 double CKMS::max() const {
-    return max_;
+    return moments_.max();
+}
+
+double CKMS::sum() const {
+    return moments_.sum();
+}
+
+double CKMS::mean() const {
+    return moments_.mean();
+}
+
+double CKMS::variance() const {
+    return moments_.variance();
 }
 
 CKMS::Quantile::Quantile(double quantile, double error)
@@ -46,42 +71,83 @@ CKMS::Item::Item(double value, int lower_delta, int delta)
 
 
 CKMS::CKMS(const std::vector<Quantile>& quantiles)
-    : quantiles_(quantiles), count_(0), buffer_{}, buffer_count_(0), size_when_last_sorted_(0) {}
+    : CKMS(std::make_shared<const std::vector<Quantile>>(quantiles)) {}
+
+CKMS::CKMS(std::shared_ptr<const std::vector<Quantile>> quantiles)
+    : quantiles_(quantiles), count_(0), size_when_last_sorted_(0) {}
 
 void CKMS::insert(double value) {
-  if (count() == 0) {
-      max_ = value;
-  } else {
-      max_ = std::max(max_, value);
-  }
+  moments_.insert(value);
+  append(value);
+}
 
-  buffer_[buffer_count_] = value;
-  ++buffer_count_;
+void CKMS::append(double value) {
+  buffer_.push_back(value);
 
-  if (buffer_count_ == buffer_.size()) {
+  if (buffer_.size() == kBufferSize) {
     insertBatch();
     compress();
   }
 }
 
+void CKMS::merge(const CKMS& other) {
+  if (other.count() == 0) {
+    return;
+  }
+  moments_.merge(other.moments_);
+
+  if (!other.sample_.empty()) {
+    if (sample_.empty()) {
+      sample_ = other.sample_;
+    } else {
+      std::vector<Item> merged;
+      merged.reserve(sample_.size() + other.sample_.size());
+      auto a = sample_.cbegin(), a_end = sample_.cend();
+      auto b = other.sample_.cbegin(), b_end = other.sample_.cend();
+      while (a != a_end || b != b_end) {
+        // Take the smaller head. While the other list still has items,
+        // the taken item's rank is only known to within the next of them.
+        if (b == b_end || (a != a_end && a->value <= b->value)) {
+          merged.push_back(*a++);
+          if (b != b_end) {
+            merged.back().delta += b->g + b->delta - 1;
+          }
+        } else {
+          merged.push_back(*b++);
+          if (a != a_end) {
+            merged.back().delta += a->g + a->delta - 1;
+          }
+        }
+      }
+      sample_.swap(merged);
+    }
+    count_ += other.count_;
+    compress();
+  }
+
+  for (auto v : other.buffer_) {
+    append(v);
+  }
+}
+
 double CKMS::get(double q) {
-  if (count() < buffer_.size()) {
-      // in this block, count() == buffer_count_ as we've accumulated less
-      // than buffer_.size() samples
-      if (buffer_count_ == 0)
+  if (count() < kBufferSize) {
+      // in this block, count() == buffer_.size() as we've accumulated less
+      // than kBufferSize samples
+      if (buffer_.empty())
       {
           return 0.0;
       }
       // The sample size is still very small.
       // We will calculate the exact value.
-      if (size_when_last_sorted_ < buffer_count_) {
+      if (size_when_last_sorted_ < buffer_.size()) {
           // We've added more elements since we last sorted.
           // We need to sort again.
-          // This means, in total, we may sort this array buffer_count_ times.
+          // This means, in total, we may sort this array buffer_.size() times.
           // Therefore, in the worst case scenario,
-          // sorting will cost us O(buffer_count_ * buffer_count_ * log(buffer_count_)) operations.
-          std::sort(buffer_.begin(), buffer_.begin() + buffer_count_);
-          size_when_last_sorted_ = buffer_count_;
+          // sorting will cost us O(n * n * log(n)) operations.
+          std::sort(buffer_.begin(), buffer_.end());
+          size_when_last_sorted_ = buffer_.size();
       }
       if (q <= 0 || 1.0 < q) {
           // Invalid q.
@@ -90,12 +156,12 @@ double CKMS::get(double q) {
           // We want to find x such that
           // x is the smallest number in the given sample set such that
           // at least q% of all samples are <= x.
-          // In other words, we want ceil(buffer_count_ * q) elements
-          // to be <= x.
-          // Then we want ceil(buffer_count_ * q)-th element,
-          // whose index is ceil(buffer_count_ * q) - 1 since
+          // In other words, we want ceil(n * q) elements
+          // to be <= x, where n = buffer_.size().
+          // Then we want ceil(n * q)-th element,
+          // whose index is ceil(n * q) - 1 since
           // the index starts at 0.
-          return buffer_[int(ceil(buffer_count_ * q)) - 1];
+          return buffer_[int(ceil(buffer_.size() * q)) - 1];
       }
   }
 
@@ -129,18 +195,78 @@ double CKMS::get(double q) {
 }
 
 void CKMS::reset() {
+  if (count() == 0) {
+    // Nothing was recorded since the last reset, so this window belongs to
+    // an idle metric. Give its storage back rather than holding on to it.
+    std::vector<Item>().swap(sample_);
+    std::vector<double>().swap(buffer_);
+  }
   count_ = 0;
   sample_.clear();
-  buffer_count_ = 0;
-  max_ = 0;
+  buffer_.clear();
+  moments_.reset();
   size_when_last_sorted_ = 0;
 }
 
+std::string CKMS::serialize() const {
+  std::string out(kMagic, sizeof(kMagic));
+  encoding::PutU64(out, count_);
+  moments_.serialize(out);
+  encoding::PutU32(out, static_cast<std::uint32_t>(sample_.size()));
+  for (const auto& item : sample_) {
+    encoding::PutDouble(out, item.value);
+    encoding::PutU32(out, static_cast<std::uint32_t>(item.g));
+    encoding::PutU32(out, static_cast<std::uint32_t>(item.delta));
+  }
+  encoding::PutU32(out, static_cast<std::uint32_t>(buffer_.size()));
+  for (auto v : buffer_) {
+    encoding::PutDouble(out, v);
+  }
+  return out;
+}
+
+CKMS CKMS::deserialize(const std::string& bytes,
+                       std::shared_ptr<const std::vector<Quantile>> quantiles) {
+  encoding::Reader in {bytes, "CKMS summary"};
+  if (!in.Expect(kMagic, sizeof(kMagic))) {
+    throw std::invalid_argument("not a serialized CKMS summary");
+  }
+  CKMS ckms = quantiles ? CKMS(quantiles) : CKMS();
+  ckms.count_ = in.GetU64();
+  ckms.moments_ = Moments::deserialize(in);
+  auto items = in.GetU32();
+  if (items > in.remaining() / 16) {
+    in.Malformed();
+  }
+  ckms.sample_.reserve(items);
+  std::uint64_t total = 0;
+  for (std::uint32_t i = 0; i < items; i++) {
+    auto value = in.GetDouble();
+    auto g = static_cast<std::int32_t>(in.GetU32());
+    auto delta = static_cast<std::int32_t>(in.GetU32());
+    // Items are kept in order, and each stands for at least one value.
+    if (g < 1 || delta < 0 || (!ckms.sample_.empty() && value < ckms.sample_.back().value)) {
+      in.Malformed();
+    }
+    ckms.sample_.emplace_back(value, g, delta);
+    total += g;
+  }
+  auto buffered = in.GetU32();
+  if (total != ckms.count_ || buffered >= kBufferSize || buffered * 8 != in.remaining() ||
+      ckms.moments_.count() != total + buffered) {
+    in.Malformed();
+  }
+  for (std::uint32_t i = 0; i < buffered; i++) {
+    ckms.buffer_.push_back(in.GetDouble());
+  }
+  return ckms;
+}
+
 double CKMS::allowableError(int rank) {
   auto size = sample_.size();
   double minError = size + 1;
 
-  for (const auto& q : quantiles_.get()) {
+  for (const auto& q : *quantiles_) {
     double error;
     if (rank <= q.quantile * size) {
       error = q.u * (size - rank);
@@ -156,11 +282,11 @@ double CKMS::allowableError(int rank) {
 }
 
 bool CKMS::insertBatch() {
-  if (buffer_count_ == 0) {
+  if (buffer_.empty()) {
     return false;
   }
 
-  std::sort(buffer_.begin(), buffer_.begin() + buffer_count_);
+  std::sort(buffer_.begin(), buffer_.end());
 
   std::size_t start = 0;
   if (sample_.empty()) {
@@ -172,7 +298,7 @@ bool CKMS::insertBatch() {
   std::size_t idx = 0;
   std::size_t item = idx++;
 
-  for (std::size_t i = start; i < buffer_count_; ++i) {
+  for (std::size_t i = start; i < buffer_.size(); ++i) {
     double v = buffer_[i];
     while (idx < sample_.size() && sample_[item].value < v) {
       item = idx++;
@@ -194,7 +320,7 @@ bool CKMS::insertBatch() {
     item = idx++;
   }
 
-  buffer_count_ = 0;
+  buffer_.clear();
   return true;
 }
 
@@ -10,11 +10,16 @@
 // Licensed under MIT license.
 // https://opensource.org/licenses/MIT
 
-#include <array>
+#ifndef MEDIDA_CKMS_H_
+#define MEDIDA_CKMS_H_
+
 #include <cstddef>
-#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "medida/stats/moments.h"
+
 namespace medida {
 namespace stats {
 
@@ -39,31 +44,61 @@ class CKMS {
   };
 
  public:
+  // Targets {0.5, 0.001} and {0.99, 0.001}.
   CKMS();
   explicit CKMS(const std::vector<Quantile>& quantiles);
+  // Shares a target list, so that the many windows of one metric do not
+  // each hold a copy.
+  explicit CKMS(std::shared_ptr<const std::vector<Quantile>> quantiles);
 
   void insert(double value);
+  // Folds another summary into this one. Each item's rank uncertainty grows
+  // by that of the other summary at the same point, so the result keeps
+  // this summary's error targets over the combined stream.
+  void merge(const CKMS& other);
   double get(double q);
   void reset();
   std::size_t count() const;
+  // Exact summary statistics of the values inserted or merged in; all 0
+  // while empty. variance is the sample variance.
+  double min() const;
   double max() const;
+  double sum() const;
+  double mean() const;
+  double variance() const;
+
+  // A compact, byte-order independent encoding of the summary. The error
+  // targets are not part of it: deserialize gives the summary `quantiles`,
+  // or the defaults if that is null, and throws std::invalid_argument for
+  // anything serialize could not have produced.
+  std::string serialize() const;
+  static CKMS deserialize(const std::string& bytes,
+                          std::shared_ptr<const std::vector<Quantile>> quantiles = nullptr);
 
  private:
+  // Stages a value without counting it in moments_.
+  void append(double value);
   double allowableError(int rank);
   bool insertBatch();
   void compress();
 
  private:
-  const std::reference_wrapper<const std::vector<Quantile>> quantiles_;
+  // Values are staged in buffer_ and merged into sample_ in batches of
+  // kBufferSize. The buffer grows on demand, so a window that sees little
+  // or no traffic does not pay for a full batch.
+  static const std::size_t kBufferSize = 500;
+
+  std::shared_ptr<const std::vector<Quantile>> quantiles_;
 
   std::size_t count_;
   std::vector<Item> sample_;
-  std::array<double, 500> buffer_;
-  std::size_t buffer_count_;
+  std::vector<double> buffer_;
   std::size_t size_when_last_sorted_;
 
-  double max_;
+  Moments moments_;
 };
 
 } // namespace stats
 } // namespace medida
+
+#endif // MEDIDA_CKMS_H_
@@ -8,38 +8,178 @@
 #include <atomic>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <map>
 #include <mutex>
 #include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "medida/encoding.h"
 
 namespace medida {
 namespace stats {
 
-class CKMSSample::Impl {
+namespace {
+
+// Values staged per hand-off in background mode; matches the batches CKMS
+// itself compresses in.
+const std::size_t kBatchSize = 500;
+
+// Emptied batch buffers kept for reuse, so that writers swap buffers
+// instead of allocating them.
+const std::size_t kSpareBatches = 4;
+
+// Batches a sample may have waiting on the compactor. A writer that finds
+// more than this folds them in itself, so a compactor that cannot keep up
+// slows writers down instead of letting the backlog grow without bound.
+const std::size_t kMaxQueuedBatches = 64;
+
+const char kMagic[] = {'C', 'K', 'M', 'W'};
+
+class Compactable {
  public:
-  Impl(std::chrono::seconds = std::chrono::seconds(30));
+  virtual ~Compactable() {}
+  virtual void Compact() = 0;
+};
+
+// One thread, shared by every sample in background mode, that folds staged
+// batches into their summaries.
+class Compactor {
+ public:
+  // Never destroyed: samples may outlive static destruction.
+  static Compactor& Instance() {
+    static Compactor* instance = new Compactor;
+    return *instance;
+  }
+
+  void Schedule(Compactable* sample) {
+    {
+      std::lock_guard<std::mutex> lock {mutex_};
+      queue_.push_back(sample);
+    }
+    ready_.notify_one();
+  }
+
+  // Forgets `sample`, waiting out a compaction of it that is under way.
+  void Cancel(Compactable* sample) {
+    std::unique_lock<std::mutex> lock {mutex_};
+    queue_.erase(std::remove(queue_.begin(), queue_.end(), sample), queue_.end());
+    done_.wait(lock, [this, sample] { return running_ != sample; });
+  }
+
+ private:
+  Compactor() : running_ {nullptr} {
+    std::thread([this] { Run(); }).detach();
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock {mutex_};
+    for (;;) {
+      ready_.wait(lock, [this] { return !queue_.empty(); });
+      auto sample = queue_.front();
+      queue_.pop_front();
+      running_ = sample;
+      lock.unlock();
+      sample->Compact();
+      lock.lock();
+      running_ = nullptr;
+      done_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable done_;
+  std::deque<Compactable*> queue_;
+  Compactable* running_;
+};
+
+} // namespace
+
+class CKMSSample::Impl : public Compactable {
+ public:
+  Impl(std::chrono::seconds window_size, const std::vector<CKMS::Quantile>& quantiles,
+       std::size_t completed_windows, bool background_compaction);
   ~Impl();
   void Clear();
   std::uint64_t size();
-  std::uint64_t size(SystemClock::time_point timestamp);
+  std::uint64_t size(Clock::time_point timestamp);
   void Update(std::int64_t value);
-  void Update(std::int64_t value, SystemClock::time_point timestamp);
-  Snapshot MakeSnapshot(uint64_t divisor = 1);
-  Snapshot MakeSnapshot(SystemClock::time_point timestamp, uint64_t divisor = 1);
+  void Update(std::int64_t value, Clock::time_point timestamp);
+  Snapshot MakeSnapshot(std::chrono::seconds horizon, Clock::time_point timestamp,
+                        uint64_t divisor = 1);
+  void Merge(Impl& other);
+  std::string SaveState(Clock::time_point timestamp);
+  void RestoreState(const std::string& state, Clock::duration idle,
+                    Clock::time_point timestamp);
+  virtual void Compact();
  private:
+  // Values for one window, staged by writers in background mode.
+  struct Batch {
+    Clock::time_point window_begin;
+    std::vector<double> values;
+  };
+
+  // Guards the writers' window below and, unless background_, everything
+  // else too.
   std::mutex mutex_;
-  std::shared_ptr<CKMS> prev_window_, cur_window_;
-  SystemClock::time_point cur_window_begin_;
+  // The window updates go to.
+  Clock::time_point cur_window_begin_;
+  // cur_window_begin_ + window_size_, kept so that an update in the current
+  // window costs two comparisons.
+  Clock::time_point cur_window_end_;
   std::chrono::seconds window_size_;
-  SystemClock::time_point CalculateCurrentWindowStartingPoint(SystemClock::time_point time) const;
-  bool IsInCurrentWindow(SystemClock::time_point const& timestamp) const;
-  bool IsInPreviousWindow(SystemClock::time_point const& timestamp) const;
-  bool IsInNextWindow(SystemClock::time_point const& timestamp) const;
-  bool AdvanceWindows(SystemClock::time_point timestamp);
+
+  // In background mode, writers append to pending_ and hand full buffers
+  // to the compactor through queued_, all under mutex_; the summaries below
+  // are guarded by summary_mutex_ instead, which writers never take.
+  bool const background_;
+  std::vector<double> pending_;
+  std::vector<Batch> queued_;
+  std::vector<std::vector<double>> spare_;
+  bool scheduled_;
+  std::mutex summary_mutex_;
+
+  // Shared by every window; null for the CKMS defaults.
+  std::shared_ptr<const std::vector<CKMS::Quantile>> quantiles_;
+  // windows_[current_] is the window beginning at summary_begin_. Going
+  // backwards round the ring from there are the completed windows, most
+  // recent first. Without background_, summary_begin_ is always
+  // cur_window_begin_; with it, the summaries catch up on compaction.
+  std::vector<CKMS> windows_;
+  std::size_t current_;
+  Clock::time_point summary_begin_;
+  // Summaries of the last M completed windows, by M, for M > 1. They are
+  // dropped whenever the windows rotate or change.
+  std::map<std::size_t, CKMS> merged_;
+
+  Clock::time_point CalculateCurrentWindowStartingPoint(Clock::time_point time) const;
+  bool IsInCurrentWindow(Clock::time_point const& timestamp) const;
+  bool IsInPreviousWindow(Clock::time_point const& timestamp) const;
+  bool AdvanceWindows(Clock::time_point timestamp);
+  void RotateSummaries(Clock::time_point begin);
+  // Background mode: queues pending_ for the compactor, if it holds any.
+  void HandOff();
+  // Background mode: folds every queued batch, and pending_ too if asked,
+  // into the summaries and brings them up to the writers' window. With a
+  // timestamp, the writers' window is first moved to it as an update would.
+  // Returns false if the timestamp lies in the previous window.
+  bool Drain(const Clock::time_point* timestamp, bool include_pending);
+  std::mutex& SummaryMutex();
+  CKMS NewWindow() const;
+  // The window `age` periods before the current one.
+  CKMS& Window(std::size_t age);
 };
 
-CKMSSample::CKMSSample(std::chrono::seconds window_size) : impl_ {new CKMSSample::Impl {window_size}} {
+CKMSSample::CKMSSample(std::chrono::seconds window_size,
+                       const std::vector<CKMS::Quantile>& quantiles,
+                       std::size_t completed_windows,
+                       bool background_compaction)
+    : impl_ {new CKMSSample::Impl {window_size, quantiles, completed_windows,
+                                   background_compaction}} {
 }
 
 
@@ -54,7 +194,7 @@ std::uint64_t CKMSSample::size() const {
   return impl_->size();
 }
 
-std::uint64_t CKMSSample::size(SystemClock::time_point timestamp) const {
+std::uint64_t CKMSSample::size(Clock::time_point timestamp) const {
   return impl_->size(timestamp);
 }
 
@@ -62,113 +202,397 @@ void CKMSSample::Update(std::int64_t value) {
   impl_->Update(value);
 }
 
-void CKMSSample::Update(std::int64_t value, SystemClock::time_point timestamp) {
+void CKMSSample::Update(std::int64_t value, Clock::time_point timestamp) {
   impl_->Update(value, timestamp);
 }
 
 Snapshot CKMSSample::MakeSnapshot(uint64_t divisor) const {
-  return impl_->MakeSnapshot(divisor);
+  return MakeSnapshot(CoarseClock::now(), divisor);
 }
 
-Snapshot CKMSSample::MakeSnapshot(SystemClock::time_point timestamp, uint64_t divisor) const {
-  return impl_->MakeSnapshot(timestamp, divisor);
+Snapshot CKMSSample::MakeSnapshot(Clock::time_point timestamp, uint64_t divisor) const {
+  return impl_->MakeSnapshot(std::chrono::seconds(0), timestamp, divisor);
+}
+
+Snapshot CKMSSample::MakeSnapshot(std::chrono::seconds horizon, uint64_t divisor) const {
+  return MakeSnapshot(horizon, CoarseClock::now(), divisor);
+}
+
+Snapshot CKMSSample::MakeSnapshot(std::chrono::seconds horizon,
+                                  Clock::time_point timestamp,
+                                  uint64_t divisor) const {
+  return impl_->MakeSnapshot(horizon, timestamp, divisor);
+}
+
+void CKMSSample::Merge(const Sample& other) {
+  auto ckms = dynamic_cast<const CKMSSample*>(&other);
+  if (!ckms) {
+    throw std::invalid_argument("can only merge a CKMSSample");
+  }
+  impl_->Merge(*ckms->impl_);
+}
+
+std::string CKMSSample::SaveState() const {
+  return impl_->SaveState(CoarseClock::now());
+}
+
+std::string CKMSSample::SaveState(Clock::time_point timestamp) const {
+  return impl_->SaveState(timestamp);
+}
+
+void CKMSSample::RestoreState(const std::string& state, Clock::duration idle) {
+  impl_->RestoreState(state, idle, CoarseClock::now());
+}
+
+void CKMSSample::RestoreState(const std::string& state, Clock::duration idle,
+                              Clock::time_point timestamp) {
+  impl_->RestoreState(state, idle, timestamp);
 }
 
 // === Implementation ===
 
-SystemClock::time_point CKMSSample::Impl::CalculateCurrentWindowStartingPoint(SystemClock::time_point time) const {
+Clock::time_point CKMSSample::Impl::CalculateCurrentWindowStartingPoint(Clock::time_point time) const {
     return time - (std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()) % window_size_);
 }
 
-bool CKMSSample::Impl::IsInCurrentWindow(SystemClock::time_point const& timestamp) const {
-    return cur_window_begin_ <= timestamp && timestamp < cur_window_begin_ + window_size_;
+bool CKMSSample::Impl::IsInCurrentWindow(Clock::time_point const& timestamp) const {
+    return cur_window_begin_ <= timestamp && timestamp < cur_window_end_;
 }
 
-bool CKMSSample::Impl::IsInPreviousWindow(SystemClock::time_point const& timestamp) const {
+bool CKMSSample::Impl::IsInPreviousWindow(Clock::time_point const& timestamp) const {
     return timestamp < cur_window_begin_ && timestamp + window_size_ >= cur_window_begin_;
 }
 
-bool CKMSSample::Impl::IsInNextWindow(SystemClock::time_point const& timestamp) const {
-    return cur_window_begin_ + window_size_ <= timestamp && timestamp < cur_window_begin_ + 2 * window_size_;
+bool CKMSSample::Impl::AdvanceWindows(Clock::time_point timestamp) {
+    if (IsInCurrentWindow(timestamp)) {
+        return true;
+    }
+    if (IsInPreviousWindow(timestamp))
+    {
+        // A race occured recording samples (see mutex above), or a
+        // caller mixed timestamps from Clock with coarser ones
+        // in either case drop events as we want to keep the previous window
+        // immutable
+        return false;
+    }
+
+    auto begin = CalculateCurrentWindowStartingPoint(timestamp);
+    if (background_) {
+        // What was staged belongs to the window that just ended.
+        HandOff();
+    } else {
+        RotateSummaries(begin);
+    }
+    cur_window_begin_ = begin;
+    cur_window_end_ = begin + window_size_;
+    return true;
+}
+
+void CKMSSample::Impl::RotateSummaries(Clock::time_point begin) {
+    if (begin == summary_begin_) {
+        return;
+    }
+    // Move round the ring one slot per elapsed window, emptying each slot
+    // as it becomes current. If we haven't had any input for longer than
+    // the ring covers, or a timestamp went backwards by a lot, every
+    // window ends up empty.
+    std::size_t steps = windows_.size();
+    if (summary_begin_ < begin) {
+        auto elapsed = (begin - summary_begin_) / window_size_;
+        steps = std::min<std::size_t>(steps, elapsed);
+    }
+    for (std::size_t i = 0; i < steps; i++) {
+        current_ = (current_ + 1) % windows_.size();
+        windows_[current_].reset();
+    }
+    summary_begin_ = begin;
+    merged_.clear();
+}
+
+void CKMSSample::Impl::HandOff() {
+    if (pending_.empty()) {
+        return;
+    }
+    queued_.push_back({cur_window_begin_, std::move(pending_)});
+    if (spare_.empty()) {
+        pending_ = std::vector<double>();
+        pending_.reserve(kBatchSize);
+    } else {
+        pending_ = std::move(spare_.back());
+        spare_.pop_back();
+    }
 }
 
-bool CKMSSample::Impl::AdvanceWindows(SystemClock::time_point timestamp) {
-    if (!IsInCurrentWindow(timestamp)) {
-        if (IsInPreviousWindow(timestamp))
-        {
-            // A minor backward system clock adjustment occured
-            // or a race occured recording samples (see mutex above)
-            // in either case drop events as we want to keep the previous window
-            // immutable
-            return false;
+bool CKMSSample::Impl::Drain(const Clock::time_point* timestamp, bool include_pending) {
+    std::vector<Batch> batches;
+    Clock::time_point begin;
+    bool current = true;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (timestamp) {
+            current = AdvanceWindows(*timestamp);
+        }
+        if (include_pending) {
+            HandOff();
+        }
+        batches.swap(queued_);
+        begin = cur_window_begin_;
+    }
+
+    for (auto& batch : batches) {
+        if (summary_begin_ < batch.window_begin) {
+            RotateSummaries(batch.window_begin);
+        }
+        auto age = static_cast<std::size_t>((summary_begin_ - batch.window_begin) / window_size_);
+        if (age < windows_.size()) {
+            auto& window = Window(age);
+            for (auto v : batch.values) {
+                window.insert(v);
+            }
+            if (age > 0) {
+                merged_.clear();
+            }
         }
+    }
+    RotateSummaries(begin);
 
-        if (IsInNextWindow(timestamp)) {
-            // Enough time has passed, and the current window is no longer current.
-            // We need to shift it.
-            // The current window becomes the previous one.
-            prev_window_.swap(cur_window_);
-            cur_window_->reset();
-            cur_window_begin_ += window_size_;
-        } else {
-            // Either we haven't had any input for a long time
-            // or the system clock moved backwards by a lot
-            // in either case prev_window_ and cur_window_ should be empty.
-            prev_window_->reset();
-            cur_window_->reset();
-            cur_window_begin_ = CalculateCurrentWindowStartingPoint(timestamp);
+    if (!batches.empty()) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        for (auto& batch : batches) {
+            if (spare_.size() == kSpareBatches) {
+                break;
+            }
+            batch.values.clear();
+            spare_.push_back(std::move(batch.values));
         }
     }
-    return true;
+    return current;
 }
 
-CKMSSample::Impl::Impl(std::chrono::seconds window_size) :
-    prev_window_(std::make_shared<CKMS>(CKMS())),
-    cur_window_(std::make_shared<CKMS>(CKMS())),
+void CKMSSample::Impl::Compact() {
+    std::lock_guard<std::mutex> lock{summary_mutex_};
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        scheduled_ = false;
+    }
+    Drain(nullptr, false);
+}
+
+std::mutex& CKMSSample::Impl::SummaryMutex() {
+    return background_ ? summary_mutex_ : mutex_;
+}
+
+CKMS CKMSSample::Impl::NewWindow() const {
+    return quantiles_ ? CKMS(quantiles_) : CKMS();
+}
+
+CKMS& CKMSSample::Impl::Window(std::size_t age) {
+    return windows_[(current_ + windows_.size() - age) % windows_.size()];
+}
+
+CKMSSample::Impl::Impl(std::chrono::seconds window_size,
+                       const std::vector<CKMS::Quantile>& quantiles,
+                       std::size_t completed_windows,
+                       bool background_compaction) :
     cur_window_begin_(),
-    window_size_(window_size) {
+    cur_window_end_(cur_window_begin_ + window_size),
+    window_size_(window_size),
+    background_(background_compaction),
+    scheduled_(false),
+    quantiles_(quantiles.empty() ? nullptr
+               : std::make_shared<const std::vector<CKMS::Quantile>>(quantiles)),
+    windows_(std::max<std::size_t>(completed_windows, 1) + 1, NewWindow()),
+    current_(0),
+    summary_begin_() {
+    if (background_) {
+        pending_.reserve(kBatchSize);
+    }
 }
 
 CKMSSample::Impl::~Impl() {
+    if (background_) {
+        Compactor::Instance().Cancel(this);
+    }
 }
 
 void CKMSSample::Impl::Clear() {
-    std::lock_guard<std::mutex> lock{mutex_};
-    prev_window_->reset();
-    cur_window_->reset();
-    cur_window_begin_ = std::chrono::time_point<SystemClock>();
+    std::lock_guard<std::mutex> summary_lock{SummaryMutex()};
+    std::unique_lock<std::mutex> lock{mutex_, std::defer_lock};
+    if (background_) {
+        lock.lock();
+        pending_.clear();
+        queued_.clear();
+    }
+    for (auto& window : windows_) {
+        window.reset();
+    }
+    merged_.clear();
+    cur_window_begin_ = Clock::time_point();
+    cur_window_end_ = cur_window_begin_ + window_size_;
+    summary_begin_ = cur_window_begin_;
 }
 
-std::uint64_t CKMSSample::Impl::size(SystemClock::time_point timestamp) {
-    return MakeSnapshot(timestamp).size();
+std::uint64_t CKMSSample::Impl::size(Clock::time_point timestamp) {
+    return MakeSnapshot(std::chrono::seconds(0), timestamp).size();
 }
 
 std::uint64_t CKMSSample::Impl::size() {
-    return size(SystemClock::now());
+    return size(CoarseClock::now());
 }
 
 void CKMSSample::Impl::Update(std::int64_t value) {
-  Update(value, SystemClock::now());
+  Update(value, CoarseClock::now());
 }
 
-void CKMSSample::Impl::Update(std::int64_t value, SystemClock::time_point timestamp) {
-    std::lock_guard<std::mutex> lock{mutex_};
-    if (AdvanceWindows(timestamp)) {
-        cur_window_->insert(value);
+void CKMSSample::Impl::Update(std::int64_t value, Clock::time_point timestamp) {
+    if (!background_) {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (AdvanceWindows(timestamp)) {
+            windows_[current_].insert(value);
+        }
+        return;
+    }
+
+    bool schedule = false;
+    bool backlogged = false;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (!AdvanceWindows(timestamp)) {
+            return;
+        }
+        pending_.push_back(value);
+        if (pending_.size() >= kBatchSize) {
+            HandOff();
+        }
+        if (!queued_.empty() && !scheduled_) {
+            schedule = scheduled_ = true;
+        }
+        backlogged = queued_.size() > kMaxQueuedBatches;
+    }
+    if (schedule) {
+        Compactor::Instance().Schedule(this);
+    }
+    if (backlogged) {
+        std::lock_guard<std::mutex> lock{summary_mutex_};
+        Drain(nullptr, false);
     }
 }
 
-Snapshot CKMSSample::Impl::MakeSnapshot(SystemClock::time_point timestamp, uint64_t divisor) {
-    std::lock_guard<std::mutex> lock{mutex_};
-    if (AdvanceWindows(timestamp)) {
-        return {*prev_window_, divisor};
+void CKMSSample::Impl::Merge(Impl& other) {
+    if (window_size_ != other.window_size_) {
+        throw std::invalid_argument("can only merge samples with the same window size");
+    }
+    std::vector<CKMS> theirs;
+    Clock::time_point their_begin;
+    {
+        std::lock_guard<std::mutex> lock{other.SummaryMutex()};
+        if (other.background_) {
+            other.Drain(nullptr, true);
+        }
+        for (std::size_t age = 0; age < other.windows_.size(); age++) {
+            theirs.push_back(other.Window(age));
+        }
+        their_begin = other.summary_begin_;
+    }
+
+    std::lock_guard<std::mutex> lock{SummaryMutex()};
+    if (background_) {
+        Drain(nullptr, true);
+    }
+    if (summary_begin_ < their_begin) {
+        if (background_) {
+            Drain(&their_begin, false);
+        } else {
+            AdvanceWindows(their_begin);
+        }
+    }
+    // Their window of a given age lines up with ours of age `offset` more.
+    auto offset = static_cast<std::size_t>((summary_begin_ - their_begin) / window_size_);
+    for (std::size_t age = 0; age < theirs.size(); age++) {
+        if (offset + age < windows_.size()) {
+            Window(offset + age).merge(theirs[age]);
+        }
+    }
+    merged_.clear();
+}
+
+std::string CKMSSample::Impl::SaveState(Clock::time_point timestamp) {
+    std::lock_guard<std::mutex> lock{SummaryMutex()};
+    if (background_) {
+        Drain(&timestamp, true);
+    } else {
+        AdvanceWindows(timestamp);
+    }
+    std::string out(kMagic, sizeof(kMagic));
+    encoding::PutU64(out, window_size_.count());
+    // How far into the current window the state was taken.
+    auto position = std::max(timestamp, summary_begin_) - summary_begin_;
+    encoding::PutI64(out, std::chrono::duration_cast<std::chrono::nanoseconds>(position).count());
+    encoding::PutU32(out, static_cast<std::uint32_t>(windows_.size()));
+    for (std::size_t age = 0; age < windows_.size(); age++) {
+        encoding::PutBytes(out, Window(age).serialize());
+    }
+    return out;
+}
+
+void CKMSSample::Impl::RestoreState(const std::string& state, Clock::duration idle,
+                                    Clock::time_point timestamp) {
+    encoding::Reader in{state, "CKMSSample state"};
+    if (!in.Expect(kMagic, sizeof(kMagic))) {
+        throw IncompatibleState("not a saved CKMSSample");
+    }
+    if (in.GetU64() != static_cast<std::uint64_t>(window_size_.count())) {
+        throw IncompatibleState("can only restore a sample with the same window size");
+    }
+    auto position = std::chrono::nanoseconds(in.GetI64());
+    if (position.count() < 0 || position >= window_size_) {
+        in.Malformed();
+    }
+    std::vector<CKMS> saved;
+    for (auto n = in.GetU32(); n > 0; n--) {
+        saved.push_back(CKMS::deserialize(in.GetBytes(), quantiles_));
+    }
+    in.Finish();
+
+    // Their window of a given age lines up with ours of age `passed` more.
+    auto passed = static_cast<std::size_t>(
+        (position + std::max(idle, Clock::duration::zero())) / window_size_);
+    std::lock_guard<std::mutex> lock{SummaryMutex()};
+    if (background_) {
+        Drain(&timestamp, true);
     } else {
-        return {CKMS()};
+        AdvanceWindows(timestamp);
+    }
+    for (std::size_t age = 0; age < saved.size(); age++) {
+        if (passed + age < windows_.size()) {
+            Window(passed + age).merge(saved[age]);
+        }
     }
+    merged_.clear();
 }
 
-Snapshot CKMSSample::Impl::MakeSnapshot(uint64_t divisor) {
-    return MakeSnapshot(SystemClock::now(), divisor);
+Snapshot CKMSSample::Impl::MakeSnapshot(std::chrono::seconds horizon,
+                                        Clock::time_point timestamp,
+                                        uint64_t divisor) {
+    std::lock_guard<std::mutex> lock{SummaryMutex()};
+    auto current = background_ ? Drain(&timestamp, false) : AdvanceWindows(timestamp);
+    if (!current) {
+        return {NewWindow()};
+    }
+    std::size_t count = (horizon + window_size_ - std::chrono::seconds(1)) / window_size_;
+    count = std::max<std::size_t>(1, std::min(count, windows_.size() - 1));
+    if (count == 1) {
+        return {Window(1), divisor};
+    }
+    auto it = merged_.find(count);
+    if (it == merged_.end()) {
+        auto merged = NewWindow();
+        for (std::size_t age = 1; age <= count; age++) {
+            merged.merge(Window(age));
+        }
+        it = merged_.emplace(count, std::move(merged)).first;
+    }
+    return {it->second, divisor};
 }
 
 } // namespace stats
@@ -7,21 +7,30 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "medida/types.h"
+#include "medida/stats/ckms.h"
 #include "medida/stats/sample.h"
 #include "medida/stats/snapshot.h"
 
 namespace medida {
 namespace stats {
 
-// CKMSSample maintains two N-second windows: one for the current window, and
-// another for the previous window. It adds new data to the current one, and
-// it reports the previous one.
+// CKMSSample maintains a ring of N-second windows: the current window, and
+// the K most recently completed ones (K = 1 unless configured otherwise). It
+// adds new data to the current one, and by default it reports the previous
+// one.
 //
 // For instance, if N = 30 and it's 1:00:45,
 // - it adds new data points to the current window [1:00:30, 1:01:00], and
 // - it reports the previous window [1:00:00, 1:00:30].
+//
+// A snapshot over a longer horizon merges the last M completed windows,
+// M = horizon / N rounded up and capped at K. The merged summary is kept
+// until the windows next rotate, so repeated reports cost one merge per
+// window period and updates pay nothing extra.
 
 
 // Each of size, Update, and MakeSnapshot has two versions, and
@@ -37,21 +46,61 @@ namespace stats {
 // that you can't go back in time. After you use a timestamp T, you are not allowed
 // to call another method with a timestamp S if S < T.
 //
+// Time is monotonic, not wall-clock, so windows are not disturbed by NTP
+// adjustments. The versions without a timestamp read CoarseClock, and an
+// update only compares that against the cached end of the current window;
+// rotating the windows is left to the first call past it.
+//
 // Note: While it should not matter in practice, the window is technically defined
 // to be a half-open interval [beginning, end) for testing purposes instead of a closed
 // interval.
 
+// The quantiles and error bounds that every window's summary targets can be
+// given; an empty list keeps the CKMS defaults.
+//
+// By default an update inserts into the current window's summary, and one
+// update in every few hundred compresses it while holding the sample's lock.
+// With background_compaction, updates only append to a staging buffer; a
+// full buffer is swapped for an empty one and folded into the summary by a
+// compactor thread shared by every such sample, or by the next snapshot if
+// that comes first. Writers then only wait on a compression if the
+// compactor falls a few tens of thousands of values behind, at the cost of
+// a buffer per sample and summaries that lag the staged values.
+
 class CKMSSample : public Sample {
  public:
-  CKMSSample(std::chrono::seconds window_size = std::chrono::seconds(30));
+  CKMSSample(std::chrono::seconds window_size = std::chrono::seconds(30),
+             const std::vector<CKMS::Quantile>& quantiles = {},
+             std::size_t completed_windows = 1,
+             bool background_compaction = false);
   ~CKMSSample();
   virtual void Clear();
   virtual std::uint64_t size() const;
-  virtual std::uint64_t size(SystemClock::time_point timestamp) const;
+  virtual std::uint64_t size(Clock::time_point timestamp) const;
   virtual void Update(std::int64_t value);
-  virtual void Update(std::int64_t value, SystemClock::time_point timestamp);
+  virtual void Update(std::int64_t value, Clock::time_point timestamp);
   virtual Snapshot MakeSnapshot(uint64_t divisor = 1) const;
-  virtual Snapshot MakeSnapshot(SystemClock::time_point timestamp, uint64_t divisor = 1) const;
+  virtual Snapshot MakeSnapshot(Clock::time_point timestamp, uint64_t divisor = 1) const;
+  // Reports the completed windows that make up the last `horizon`.
+  virtual Snapshot MakeSnapshot(std::chrono::seconds horizon, uint64_t divisor = 1) const;
+  virtual Snapshot MakeSnapshot(std::chrono::seconds horizon,
+                                Clock::time_point timestamp,
+                                uint64_t divisor = 1) const;
+  // Windows are aligned to multiples of the window size, so those of two
+  // samples with the same size line up and are merged pairwise. The older
+  // sample is moved forward to the newer one's windows first, and windows
+  // older than this sample keeps are dropped.
+  virtual void Merge(const Sample& other);
+  // Saves the current and completed windows. Restoring lines them up with
+  // this sample's windows by how many have ended since, as Merge does, and
+  // drops any older than it keeps. The error targets come from this
+  // sample. Throws IncompatibleState unless the state was saved by a
+  // CKMSSample with the same window size.
+  virtual std::string SaveState() const;
+  virtual std::string SaveState(Clock::time_point timestamp) const;
+  virtual void RestoreState(const std::string& state, Clock::duration idle);
+  virtual void RestoreState(const std::string& state, Clock::duration idle,
+                            Clock::time_point timestamp);
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
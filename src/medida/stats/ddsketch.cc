@@ -0,0 +1,310 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/ddsketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "medida/encoding.h"
+
+namespace medida {
+namespace stats {
+
+namespace {
+
+const char kMagic[] = {'D', 'D', 'S', '2'};
+
+} // namespace
+
+
+DDSketch::DDSketch(double relative_accuracy, std::size_t max_bins)
+    : relative_accuracy_ {relative_accuracy},
+      gamma_ {(1 + relative_accuracy) / (1 - relative_accuracy)},
+      log_gamma_ {std::log(gamma_)},
+      // The smallest magnitude whose bucket index, and that bucket's value,
+      // are still finite.
+      min_indexable_ {std::numeric_limits<double>::min() * gamma_},
+      positive_ {max_bins},
+      negative_ {max_bins},
+      zero_count_ {0} {
+  if (!(relative_accuracy > 0 && relative_accuracy < 1)) {
+    throw std::invalid_argument("relative accuracy must lie in (0, 1)");
+  }
+  if (max_bins == 0) {
+    throw std::invalid_argument("a sketch needs at least one bin");
+  }
+}
+
+
+void DDSketch::insert(double value) {
+  moments_.insert(value);
+  if (value >= min_indexable_) {
+    positive_.add(Index(value));
+  } else if (value <= -min_indexable_) {
+    negative_.add(Index(-value));
+  } else {
+    zero_count_++;
+  }
+}
+
+
+void DDSketch::merge(const DDSketch& other) {
+  if (relative_accuracy_ != other.relative_accuracy_) {
+    throw std::invalid_argument("can only merge sketches with the same relative accuracy");
+  }
+  if (other.count() == 0) {
+    return;
+  }
+  moments_.merge(other.moments_);
+  positive_.merge(other.positive_);
+  negative_.merge(other.negative_);
+  zero_count_ += other.zero_count_;
+}
+
+
+double DDSketch::get(double q) const {
+  auto n = count();
+  if (n == 0) {
+    return 0.0;
+  }
+  q = std::min(std::max(q, 0.0), 1.0);
+  // The rank, counting from 0, of the value wanted.
+  auto rank = static_cast<std::uint64_t>(q * (n - 1));
+
+  double value;
+  std::uint64_t seen = 0;
+  if (rank < negative_.total()) {
+    // Negative values, largest magnitude first.
+    auto index = negative_.max_index();
+    for (;; index--) {
+      seen += negative_.at(index);
+      if (seen > rank) {
+        break;
+      }
+    }
+    value = -Value(index);
+  } else if (rank < negative_.total() + zero_count_) {
+    value = 0.0;
+  } else {
+    seen = negative_.total() + zero_count_;
+    auto index = positive_.min_index();
+    for (;; index++) {
+      seen += positive_.at(index);
+      if (seen > rank) {
+        break;
+      }
+    }
+    value = Value(index);
+  }
+  // The extremes are known exactly, and bucket midpoints may lie past them.
+  return std::min(std::max(value, moments_.min()), moments_.max());
+}
+
+
+void DDSketch::reset() {
+  positive_.clear();
+  negative_.clear();
+  zero_count_ = 0;
+  moments_.reset();
+}
+
+
+std::size_t DDSketch::count() const {
+  return positive_.total() + negative_.total() + zero_count_;
+}
+
+
+double DDSketch::min() const {
+  return moments_.min();
+}
+
+
+double DDSketch::max() const {
+  return moments_.max();
+}
+
+
+double DDSketch::sum() const {
+  return moments_.sum();
+}
+
+
+double DDSketch::mean() const {
+  return moments_.mean();
+}
+
+
+double DDSketch::variance() const {
+  return moments_.variance();
+}
+
+
+double DDSketch::relative_accuracy() const {
+  return relative_accuracy_;
+}
+
+
+std::string DDSketch::serialize() const {
+  std::string out(kMagic, sizeof(kMagic));
+  encoding::PutDouble(out, relative_accuracy_);
+  encoding::PutU64(out, positive_.max_bins());
+  moments_.serialize(out);
+  encoding::PutU64(out, zero_count_);
+  for (auto store : {&positive_, &negative_}) {
+    auto bins = store->empty() ? 0 : store->max_index() - store->min_index() + 1;
+    encoding::PutU32(out, static_cast<std::uint32_t>(store->min_index()));
+    encoding::PutU32(out, static_cast<std::uint32_t>(bins));
+    for (int i = 0; i < bins; i++) {
+      encoding::PutU64(out, store->at(store->min_index() + i));
+    }
+  }
+  return out;
+}
+
+
+DDSketch DDSketch::deserialize(const std::string& bytes) {
+  encoding::Reader in {bytes, "DDSketch"};
+  if (!in.Expect(kMagic, sizeof(kMagic))) {
+    throw std::invalid_argument("not a serialized DDSketch");
+  }
+  auto relative_accuracy = in.GetDouble();
+  auto max_bins = in.GetU64();
+  DDSketch sketch {relative_accuracy, static_cast<std::size_t>(max_bins)};
+  sketch.moments_ = Moments::deserialize(in);
+  sketch.zero_count_ = in.GetU64();
+  for (auto store : {&sketch.positive_, &sketch.negative_}) {
+    auto offset = static_cast<std::int32_t>(in.GetU32());
+    auto bins = in.GetU32();
+    if (bins > max_bins || bins > in.remaining() / 8 ||
+        static_cast<std::int64_t>(offset) + bins > std::numeric_limits<int>::max()) {
+      in.Malformed();
+    }
+    // Lowest first: every index is in range, so nothing collapses.
+    for (std::uint32_t i = 0; i < bins; i++) {
+      auto n = in.GetU64();
+      if (n) {
+        store->add(offset + static_cast<int>(i), n);
+      }
+    }
+  }
+  in.Finish();
+  if (sketch.moments_.count() != sketch.count()) {
+    in.Malformed();
+  }
+  return sketch;
+}
+
+
+int DDSketch::Index(double magnitude) const {
+  return static_cast<int>(std::ceil(std::log(magnitude) / log_gamma_));
+}
+
+
+double DDSketch::Value(int index) const {
+  // The bucket covers (gamma^(i-1), gamma^i]; this point is within the
+  // relative accuracy of both ends.
+  return 2 * std::pow(gamma_, index) / (gamma_ + 1);
+}
+
+
+DDSketch::Store::Store(std::size_t max_bins)
+    : max_bins_ {max_bins},
+      offset_ {0},
+      total_ {0} {
+}
+
+
+void DDSketch::Store::add(int index, std::uint64_t n) {
+  if (counts_.empty()) {
+    counts_.assign(1, 0);
+    offset_ = index;
+  } else if (index < offset_) {
+    auto top = max_index();
+    // Everything below the lowest bucket we may keep lands in it.
+    index = std::max<long>(index, static_cast<long>(top) - static_cast<long>(max_bins_) + 1);
+    if (index < offset_) {
+      counts_.insert(counts_.begin(), offset_ - index, 0);
+      offset_ = index;
+    }
+  } else if (index > max_index()) {
+    auto bottom = std::max<long>(offset_, static_cast<long>(index) - static_cast<long>(max_bins_) + 1);
+    if (bottom > offset_) {
+      // Collapse the buckets that fall out of range into the new lowest.
+      auto drop = std::min<std::size_t>(bottom - offset_, counts_.size());
+      std::uint64_t collapsed = 0;
+      for (std::size_t i = 0; i < drop; i++) {
+        collapsed += counts_[i];
+      }
+      counts_.erase(counts_.begin(), counts_.begin() + drop);
+      if (counts_.empty()) {
+        counts_.assign(1, 0);
+      }
+      counts_[0] += collapsed;
+      offset_ = bottom;
+    }
+    counts_.resize(index - offset_ + 1, 0);
+  }
+  counts_[index - offset_] += n;
+  total_ += n;
+}
+
+
+void DDSketch::Store::merge(const Store& other) {
+  if (other.empty()) {
+    return;
+  }
+  // Highest first, so any collapsing happens once, on the way down.
+  for (auto index = other.max_index(); index >= other.min_index(); index--) {
+    auto n = other.at(index);
+    if (n) {
+      add(index, n);
+    }
+  }
+}
+
+
+void DDSketch::Store::clear() {
+  counts_.clear();
+  offset_ = 0;
+  total_ = 0;
+}
+
+
+bool DDSketch::Store::empty() const {
+  return total_ == 0;
+}
+
+
+std::uint64_t DDSketch::Store::total() const {
+  return total_;
+}
+
+
+int DDSketch::Store::min_index() const {
+  return offset_;
+}
+
+
+int DDSketch::Store::max_index() const {
+  return offset_ + static_cast<int>(counts_.size()) - 1;
+}
+
+
+std::uint64_t DDSketch::Store::at(int index) const {
+  if (index < offset_ || index > max_index()) {
+    return 0;
+  }
+  return counts_[index - offset_];
+}
+
+
+std::size_t DDSketch::Store::max_bins() const {
+  return max_bins_;
+}
+
+} // namespace stats
+} // namespace medida
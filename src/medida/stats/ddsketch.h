@@ -0,0 +1,97 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_DDSKETCH_H_
+#define MEDIDA_DDSKETCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "medida/stats/moments.h"
+
+namespace medida {
+namespace stats {
+
+// DDSketch (Masson, Rim and Lee, 2019): a quantile summary whose answers
+// are within a relative error of the true value, rather than within a rank
+// error as with CKMS, so that p99.9 of a latency spread over several orders
+// of magnitude is as accurate as the median.
+//
+// Each value v falls in bucket ceil(log_gamma(|v|)), with gamma =
+// (1 + a) / (1 - a) for relative accuracy a; any value in a bucket is
+// within a of the bucket's midpoint. Inserting is a log and an increment,
+// and two sketches with the same accuracy merge by adding their counts.
+//
+// Positive and negative values have a store each, and values too small to
+// index count as zero. A store holds at most max_bins buckets: past that,
+// the buckets nearest zero are collapsed into one, trading accuracy for the
+// smallest magnitudes for bounded memory.
+class DDSketch {
+ public:
+  explicit DDSketch(double relative_accuracy = 0.01, std::size_t max_bins = 2048);
+
+  void insert(double value);
+  // Adds another sketch's counts to this one's. Throws std::invalid_argument
+  // if their relative accuracies differ.
+  void merge(const DDSketch& other);
+  // The value at quantile q in [0, 1], or 0 for an empty sketch.
+  double get(double q) const;
+  void reset();
+  std::size_t count() const;
+  // Exact, like the extremes; all 0 while empty.
+  double min() const;
+  double max() const;
+  double sum() const;
+  double mean() const;
+  double variance() const;
+  double relative_accuracy() const;
+
+  // A compact, byte-order independent encoding of the sketch, which
+  // deserialize turns back into an equal one. deserialize throws
+  // std::invalid_argument for anything serialize could not have produced.
+  std::string serialize() const;
+  static DDSketch deserialize(const std::string& bytes);
+
+ private:
+  // Counts for a contiguous range of bucket indices, collapsing the lowest
+  // to stay within max_bins.
+  class Store {
+   public:
+    explicit Store(std::size_t max_bins);
+    void add(int index, std::uint64_t n = 1);
+    void merge(const Store& other);
+    void clear();
+    bool empty() const;
+    std::uint64_t total() const;
+    int min_index() const;
+    int max_index() const;
+    std::uint64_t at(int index) const;
+    std::size_t max_bins() const;
+   private:
+    std::size_t max_bins_;
+    std::vector<std::uint64_t> counts_;
+    // Bucket index of counts_[0].
+    int offset_;
+    std::uint64_t total_;
+  };
+
+  int Index(double magnitude) const;
+  double Value(int index) const;
+
+  double relative_accuracy_;
+  double gamma_;
+  double log_gamma_;
+  double min_indexable_;
+  Store positive_;
+  Store negative_;
+  std::uint64_t zero_count_;
+  Moments moments_;
+};
+
+} // namespace stats
+} // namespace medida
+
+#endif // MEDIDA_DDSKETCH_H_
@@ -4,7 +4,7 @@
 
 #include "medida/stats/ewma.h"
 
-#include <atomic>
+#include <algorithm>
 #include <cmath>
 
 namespace medida {
@@ -19,31 +19,21 @@ static const double kM1_ALPHA = 1 - std::exp(-kINTERVAL / kSECONDS_PER_MINUTE /
 static const double kM5_ALPHA = 1 - std::exp(-kINTERVAL / kSECONDS_PER_MINUTE / kFIVE_MINUTES);
 static const double kM15_ALPHA = 1 - std::exp(-kINTERVAL / kSECONDS_PER_MINUTE / kFIFTEEN_MINUTES);
 
-class EWMA::Impl {
- public:
-  Impl(double alpha, std::chrono::nanoseconds interval);
-  Impl(Impl &other);
-  ~Impl();
-  void update(std::int64_t n);
-  void tick();
-  double getRate(std::chrono::nanoseconds duration = std::chrono::seconds {1}) const;
-  void clear();
- private:
-  volatile bool initialized_;
-  volatile double rate_;
-  std::atomic<std::int64_t> uncounted_;
-  const double alpha_;
-  const std::int64_t interval_nanos_;
-};
-
-
 EWMA::EWMA(double alpha, std::chrono::nanoseconds interval)
-    : impl_ {new EWMA::Impl {alpha, interval}} {
+    : initialized_    {false},
+      rate_           {0.0},
+      uncounted_      {0},
+      alpha_          {alpha},
+      interval_nanos_ {interval.count()} {
 }
 
 
-EWMA::EWMA(EWMA &&other) 
-    : impl_ {new EWMA::Impl{*other.impl_}} {
+EWMA::EWMA(EWMA &&other)
+    : initialized_    {other.initialized_},
+      rate_           {other.rate_},
+      uncounted_      {other.uncounted_.load()},
+      alpha_          {other.alpha_},
+      interval_nanos_ {other.interval_nanos_} {
 }
 
 
@@ -67,55 +57,11 @@ EWMA EWMA::fifteenMinuteEWMA() {
 
 
 void EWMA::update(std::int64_t n) {
-  impl_->update(n);
-}
-
-
-void EWMA::tick() {
-  impl_->tick();
-}
-
-
-double EWMA::getRate(std::chrono::nanoseconds duration) const {
-  return impl_->getRate(duration);
-}
-
-void EWMA::clear()
-{
-  impl_->clear();
-}
-
-// === Implementation ===
-
-
-EWMA::Impl::Impl(double alpha, std::chrono::nanoseconds interval)
-    : initialized_    {false},
-      rate_           {0.0},
-      uncounted_      {0},
-      alpha_          {alpha},
-      interval_nanos_ {interval.count()} {
-}
-
-
-EWMA::Impl::Impl(Impl &other)
-    : initialized_    {other.initialized_},
-      rate_           {other.rate_},
-      uncounted_      {other.uncounted_.load()},
-      alpha_          {other.alpha_},
-      interval_nanos_ {other.interval_nanos_} {
-}
-
-
-EWMA::Impl::~Impl() {
-}
-
-
-void EWMA::Impl::update(std::int64_t n) {
   uncounted_ += n;
 }
 
 
-void EWMA::Impl::tick() {
+void EWMA::tick() {
   double count = uncounted_.exchange(0);
   auto instantRate = count / interval_nanos_;
   if (initialized_) {
@@ -127,16 +73,37 @@ void EWMA::Impl::tick() {
 }
 
 
-double EWMA::Impl::getRate(std::chrono::nanoseconds duration) const {
+void EWMA::merge(const EWMA& other) {
+  uncounted_ += other.uncounted_.load();
+  if (other.initialized_) {
+    rate_ += other.rate_;
+    initialized_ = true;
+  }
+}
+
+
+double EWMA::getRate(std::chrono::nanoseconds duration) const {
   return rate_ * duration.count();
 }
 
-void EWMA::Impl::clear()
+void EWMA::clear()
 {
   initialized_ = false;
   rate_ = 0.0;
   uncounted_ = 0;
 }
 
+
+bool EWMA::initialized() const {
+  return initialized_;
+}
+
+
+void EWMA::restore(double rate, std::chrono::nanoseconds idle) {
+  auto ticks = std::max<std::int64_t>(idle.count(), 0) / interval_nanos_;
+  rate_ += rate * std::pow(1 - alpha_, static_cast<double>(ticks));
+  initialized_ = true;
+}
+
 } // namespace stats
 } // namespace medida
@@ -5,9 +5,9 @@
 #ifndef MEDIDA_EWMA_H_
 #define MEDIDA_EWMA_H_
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
-#include <memory>
 
 namespace medida {
 namespace stats {
@@ -23,11 +23,24 @@ class EWMA {
   static EWMA fifteenMinuteEWMA();
   void update(std::int64_t n);
   void tick();
+  // Rates of independent streams add up, as do their uncounted events.
+  void merge(const EWMA& other);
   double getRate(std::chrono::nanoseconds duration = std::chrono::seconds {1}) const;
   void clear();
+  // For checkpoints: whether a tick has set the rate yet, and a way to add
+  // back a rate per nanosecond saved from an EWMA like this one. The saved
+  // rate first decays by one tick without events for each interval in
+  // `idle`.
+  bool initialized() const;
+  void restore(double rate, std::chrono::nanoseconds idle);
  private:
-  class Impl;
-  std::unique_ptr<Impl> impl_;
+  // Held inline rather than behind a pimpl: every Meter and Timer owns
+  // three of these, and the state is only a few words.
+  volatile bool initialized_;
+  volatile double rate_;
+  std::atomic<std::int64_t> uncounted_;
+  const double alpha_;
+  const std::int64_t interval_nanos_;
 };
 
 } // namespace stats
@@ -9,17 +9,24 @@
 #include <chrono>
 #include <cmath>
 #include <functional>
-#include <map>
 #include <mutex>
-#include <random>
+#include <stdexcept>
+#include <vector>
 
+#include "medida/stats/random.h"
 #include "medida/stats/snapshot.h"
 
 namespace medida {
 namespace stats {
 
-static const Clock::duration kRESCALE_THRESHOLD = std::chrono::hours{1};
-
+// Forward decay with the priorities kept in log space: an update at time t
+// gets priority alpha * (t - start) - log(u) for a uniform u in (0, 1], the
+// log of the classic exp(alpha * (t - start)) / u. Ordering is unchanged,
+// but the value grows linearly rather than exponentially, so it never
+// overflows and the reservoir never needs rescaling.
+//
+// The reservoir is a min-heap on priority in a vector sized up front, so an
+// update is at most one sift-down and never allocates.
 class ExpDecaySample::Impl {
  public:
   Impl(std::uint32_t reservoirSize, double alpha);
@@ -29,18 +36,21 @@ class ExpDecaySample::Impl {
   void Update(std::int64_t value);
   void Update(std::int64_t value, Clock::time_point timestamp);
   Snapshot MakeSnapshot(uint64_t divisor = 1) const;
+  void Merge(const Impl& other);
  private:
+  struct Entry {
+    double priority;
+    std::int64_t value;
+  };
   const double alpha_;
   const std::uint64_t reservoirSize_;
   Clock::time_point startTime_;
-  Clock::time_point nextScaleTime_;
 
   std::atomic<std::uint64_t> count_;
-  std::map<double, std::int64_t> values_;
-  std::mutex mutex_;
-  mutable std::mt19937 rng_;
-  std::uniform_real_distribution<> dist_;
-  void Rescale(const Clock::time_point& when);
+  std::vector<Entry> heap_;
+  mutable std::mutex mutex_;
+  void Add(const Entry& entry);
+  void ReplaceMin(const Entry& entry);
 };
 
 
@@ -78,15 +88,23 @@ Snapshot ExpDecaySample::MakeSnapshot(uint64_t divisor) const {
 }
 
 
+void ExpDecaySample::Merge(const Sample& other) {
+  auto decaying = dynamic_cast<const ExpDecaySample*>(&other);
+  if (!decaying) {
+    throw std::invalid_argument("can only merge an ExpDecaySample");
+  }
+  impl_->Merge(*decaying->impl_);
+}
+
+
 // === Implementation ===
 
 
 ExpDecaySample::Impl::Impl(std::uint32_t reservoirSize, double alpha)
     : alpha_         {alpha},
       reservoirSize_ {reservoirSize},
-      count_         {},
-      rng_           {std::random_device()()},
-      dist_          (0, 1) {
+      count_         {} {
+    heap_.reserve(reservoirSize_);
     Clear();
 }
 
@@ -97,10 +115,9 @@ ExpDecaySample::Impl::~Impl() {
 
 void ExpDecaySample::Impl::Clear() {
   std::lock_guard<std::mutex> lock {mutex_};
-  values_.clear();
+  heap_.clear();
   count_ = 0;
   startTime_ = Clock::now();
-  nextScaleTime_ = startTime_ + kRESCALE_THRESHOLD;
 }
 
 
@@ -115,64 +132,84 @@ void ExpDecaySample::Impl::Update(std::int64_t value) {
 
 
 void ExpDecaySample::Impl::Update(std::int64_t value, Clock::time_point timestamp) {
-  {
-    if (timestamp >= nextScaleTime_) {
-      Rescale(timestamp);
-    }
-    std::lock_guard<std::mutex> lock {mutex_};
-    auto dur = std::chrono::duration_cast<std::chrono::seconds>(timestamp - startTime_);
-    auto priority = std::exp(alpha_ * dur.count()) / dist_(rng_);
-    auto count = ++count_;
-
-    if (count <= reservoirSize_) {
-      values_[priority] = value;
-    } else {
-      auto first = std::begin(values_)->first;
-      if (first < priority && values_.insert({priority, value}).second) {
-        while (values_.erase(first) == 0) {
-          first = std::begin(values_)->first;
-        }
-      }
-    }
-  }
+  std::lock_guard<std::mutex> lock {mutex_};
+  auto age = std::chrono::duration<double>(timestamp - startTime_).count();
+  // 1 - u keeps the argument of log in (0, 1].
+  auto priority = alpha_ * age - std::log(1.0 - ThreadRandom().NextDouble());
+  ++count_;
+  Add({priority, value});
 }
 
 
-void ExpDecaySample::Impl::Rescale(const Clock::time_point& when) {
+void ExpDecaySample::Impl::Merge(const Impl& other) {
+  if (alpha_ != other.alpha_) {
+    throw std::invalid_argument("can only merge samples with the same alpha");
+  }
+  std::vector<Entry> theirs;
+  std::uint64_t count;
+  Clock::time_point start;
+  {
+    std::lock_guard<std::mutex> lock {other.mutex_};
+    theirs = other.heap_;
+    count = other.count_.load();
+    start = other.startTime_;
+  }
   std::lock_guard<std::mutex> lock {mutex_};
-  nextScaleTime_ = when + kRESCALE_THRESHOLD;
-  auto oldStartTime = startTime_;
-  startTime_ = when;
-  size_t size = values_.size();
-  std::vector<double> keys;
-  std::vector<std::int64_t> values;
-
-  keys.reserve(size);
-  values.reserve(size);
-  for (auto& kv : values_) {
-    keys.push_back(kv.first);
-    values.push_back(kv.second);
+  // Priorities grow linearly with age, so moving the other sample's onto
+  // our start time is a single shift.
+  auto shift = alpha_ * std::chrono::duration<double>(start - startTime_).count();
+  for (auto& e : theirs) {
+    Add({e.priority + shift, e.value});
   }
+  count_ += count;
+}
 
-  values_.clear();
 
-  for (size_t i = 0; i < size; i++) {
-    auto dur = std::chrono::duration_cast<std::chrono::seconds>(when - oldStartTime);
-    auto key = keys[i] * std::exp(-alpha_ * dur.count());
-    values_[key] = values[i];
+void ExpDecaySample::Impl::Add(const Entry& entry) {
+  auto greater = [](const Entry& a, const Entry& b) {
+    return a.priority > b.priority;
+  };
+  if (heap_.size() < reservoirSize_) {
+    heap_.push_back(entry);
+    std::push_heap(heap_.begin(), heap_.end(), greater);
+  } else if (reservoirSize_ > 0 && heap_.front().priority < entry.priority) {
+    ReplaceMin(entry);
   }
+}
+
 
-  count_ = values_.size();
+void ExpDecaySample::Impl::ReplaceMin(const Entry& entry) {
+  // Sift the new entry down from the root in place of the evicted minimum.
+  std::size_t size = heap_.size();
+  std::size_t i = 0;
+  for (;;) {
+    std::size_t child = 2 * i + 1;
+    if (child >= size) {
+      break;
+    }
+    if (child + 1 < size && heap_[child + 1].priority < heap_[child].priority) {
+      ++child;
+    }
+    if (entry.priority <= heap_[child].priority) {
+      break;
+    }
+    heap_[i] = heap_[child];
+    i = child;
+  }
+  heap_[i] = entry;
 }
 
 
 Snapshot ExpDecaySample::Impl::MakeSnapshot(uint64_t divisor) const {
   std::vector<double> vals;
-  vals.reserve(values_.size());
-  for (auto& kv : values_) {
-    vals.push_back(kv.second);
+  {
+    std::lock_guard<std::mutex> lock {mutex_};
+    vals.reserve(heap_.size());
+    for (auto& e : heap_) {
+      vals.push_back(e.value);
+    }
   }
-  return {vals, divisor};
+  return {std::move(vals), divisor};
 }
 
 
@@ -24,6 +24,8 @@ class ExpDecaySample : public Sample {
   virtual void Update(std::int64_t value);
   virtual void Update(std::int64_t value, Clock::time_point timestamp);
   virtual Snapshot MakeSnapshot(uint64_t divisor = 1) const;
+  // Both samples must decay at the same rate.
+  virtual void Merge(const Sample& other);
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
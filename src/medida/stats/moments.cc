@@ -0,0 +1,120 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/moments.h"
+
+#include <algorithm>
+
+#include "medida/encoding.h"
+
+namespace medida {
+namespace stats {
+
+Moments::Moments()
+    : count_ {0},
+      min_ {0},
+      max_ {0},
+      sum_ {0},
+      mean_ {0},
+      m2_ {0} {
+}
+
+
+void Moments::insert(double value) {
+  if (count_ == 0) {
+    min_ = max_ = value;
+  } else {
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+  sum_ += value;
+  auto delta = value - mean_;
+  mean_ += delta / ++count_;
+  m2_ += delta * (value - mean_);
+}
+
+
+void Moments::merge(const Moments& other) {
+  if (other.count_ == 0) {
+    return;
+  }
+  if (count_ == 0) {
+    *this = other;
+    return;
+  }
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  sum_ += other.sum_;
+  // Chan et al.'s pairwise combination of the running means and sums of
+  // squared deviations.
+  double na = count_;
+  double nb = other.count_;
+  double delta = other.mean_ - mean_;
+  mean_ += delta * nb / (na + nb);
+  m2_ += other.m2_ + delta * delta * na * nb / (na + nb);
+  count_ += other.count_;
+}
+
+
+void Moments::reset() {
+  *this = Moments();
+}
+
+
+std::uint64_t Moments::count() const {
+  return count_;
+}
+
+
+double Moments::min() const {
+  return min_;
+}
+
+
+double Moments::max() const {
+  return max_;
+}
+
+
+double Moments::sum() const {
+  return sum_;
+}
+
+
+double Moments::mean() const {
+  return mean_;
+}
+
+
+double Moments::variance() const {
+  return count_ > 1 ? m2_ / (count_ - 1.0) : 0.0;
+}
+
+
+void Moments::serialize(std::string& out) const {
+  encoding::PutU64(out, count_);
+  encoding::PutDouble(out, min_);
+  encoding::PutDouble(out, max_);
+  encoding::PutDouble(out, sum_);
+  encoding::PutDouble(out, mean_);
+  encoding::PutDouble(out, m2_);
+}
+
+
+Moments Moments::deserialize(encoding::Reader& in) {
+  Moments moments;
+  moments.count_ = in.GetU64();
+  moments.min_ = in.GetDouble();
+  moments.max_ = in.GetDouble();
+  moments.sum_ = in.GetDouble();
+  moments.mean_ = in.GetDouble();
+  moments.m2_ = in.GetDouble();
+  if (moments.min_ > moments.max_ || moments.m2_ < 0) {
+    in.Malformed();
+  }
+  return moments;
+}
+
+} // namespace stats
+} // namespace medida
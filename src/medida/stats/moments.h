@@ -0,0 +1,56 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_MOMENTS_H_
+#define MEDIDA_MOMENTS_H_
+
+#include <cstdint>
+#include <string>
+
+namespace medida {
+namespace encoding {
+class Reader;
+} // namespace encoding
+
+namespace stats {
+
+// Exact summary statistics of a stream: its count, extremes and sum, and
+// Welford's running mean and sum of squared deviations. Quantile summaries
+// keep one alongside their approximation, so that a window reports a min,
+// mean and standard deviation that agree with its quantiles.
+class Moments {
+ public:
+  Moments();
+  void insert(double value);
+  // Combines another stream's statistics with these, as if one had seen
+  // both.
+  void merge(const Moments& other);
+  void reset();
+  std::uint64_t count() const;
+  // All 0 while empty. variance is the sample variance.
+  double min() const;
+  double max() const;
+  double sum() const;
+  double mean() const;
+  double variance() const;
+
+  // Appends a byte-order independent encoding to `out`, which deserialize
+  // reads back from `in`, throwing std::invalid_argument for anything
+  // serialize could not have produced.
+  void serialize(std::string& out) const;
+  static Moments deserialize(encoding::Reader& in);
+
+ private:
+  std::uint64_t count_;
+  double min_;
+  double max_;
+  double sum_;
+  double mean_;
+  double m2_;
+};
+
+} // namespace stats
+} // namespace medida
+
+#endif // MEDIDA_MOMENTS_H_
@@ -0,0 +1,82 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/random.h"
+
+#include <atomic>
+#include <mutex>
+#include <random>
+
+namespace medida {
+namespace stats {
+
+namespace {
+
+std::uint64_t SplitMix64(std::uint64_t& x) {
+  auto z = (x += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// Bumped by SetRandomSeed, so that threads notice with one relaxed load.
+std::atomic<std::uint64_t> seed_generation {1};
+
+std::mutex seed_mutex;
+bool have_seed = false;
+std::uint64_t process_seed;
+std::uint64_t next_stream;
+
+struct ThreadState {
+  Xoshiro256 rng;
+  std::uint64_t generation;
+};
+
+void Reseed(ThreadState& state) {
+  std::lock_guard<std::mutex> lock {seed_mutex};
+  if (!have_seed) {
+    std::random_device device;
+    process_seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+    have_seed = true;
+  }
+  auto x = process_seed + next_stream++;
+  state.rng.seed(SplitMix64(x));
+  state.generation = seed_generation.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+
+Xoshiro256::Xoshiro256(std::uint64_t seed) {
+  this->seed(seed);
+}
+
+
+void Xoshiro256::seed(std::uint64_t seed) {
+  for (auto& s : s_) {
+    s = SplitMix64(seed);
+  }
+}
+
+
+Xoshiro256& ThreadRandom() {
+  // Constant-initialised, so reaching it costs no guard check.
+  thread_local ThreadState state {};
+  if (state.generation != seed_generation.load(std::memory_order_relaxed)) {
+    Reseed(state);
+  }
+  return state.rng;
+}
+
+
+void SetRandomSeed(std::uint64_t seed) {
+  std::lock_guard<std::mutex> lock {seed_mutex};
+  process_seed = seed;
+  have_seed = true;
+  next_stream = 0;
+  seed_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace stats
+} // namespace medida
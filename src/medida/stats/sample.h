@@ -7,12 +7,23 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <stdexcept>
+#include <string>
 
+#include "medida/types.h"
 #include "medida/stats/snapshot.h"
 
 namespace medida {
 namespace stats {
 
+// Thrown by RestoreState for a well-formed state that a sample cannot
+// take: one saved by another type of sample, or with other windows or
+// parameters. Any other std::invalid_argument means the state is malformed.
+class IncompatibleState : public std::invalid_argument {
+public:
+  explicit IncompatibleState(const std::string& what) : std::invalid_argument(what) {}
+};
+
 class Sample {
 public:
   virtual ~Sample() {};
@@ -20,6 +31,19 @@ public:
   virtual std::uint64_t size() const = 0;
   virtual void Update(std::int64_t value) = 0;
   virtual Snapshot MakeSnapshot(uint64_t divisor = 1) const = 0;
+  // Folds in another sample of the same type, as if this one had seen both
+  // streams. Throws std::invalid_argument for any other type of sample.
+  virtual void Merge(const Sample& other) = 0;
+  // For checkpoints (see MetricsRegistry::Checkpoint). SaveState encodes
+  // the sample, or returns an empty string if it cannot be saved.
+  // RestoreState folds such an encoding in as Merge would, taking it to
+  // have been saved `idle` ago. It throws IncompatibleState for a state
+  // saved by a sample it cannot take in, and std::invalid_argument for one
+  // it cannot read.
+  virtual std::string SaveState() const { return std::string(); }
+  virtual void RestoreState(const std::string&, Clock::duration) {
+    throw IncompatibleState("this type of sample cannot be restored");
+  }
 };
 
 } // namespace stats
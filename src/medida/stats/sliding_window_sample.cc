@@ -4,12 +4,16 @@
 
 #include "medida/stats/sliding_window_sample.h"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
-#include <deque>
+#include <limits>
+#include <memory>
 #include <mutex>
-#include <random>
+#include <stdexcept>
+#include <vector>
 
+#include "medida/stats/random.h"
 #include "medida/stats/snapshot.h"
 
 namespace medida
@@ -28,6 +32,7 @@ class SlidingWindowSample::Impl
     void Update(std::int64_t value);
     void Update(std::int64_t value, Clock::time_point timestamp);
     Snapshot MakeSnapshot(uint64_t divisor);
+    void Merge(Impl& other);
 
   private:
     std::mutex mutex_;
@@ -35,9 +40,36 @@ class SlidingWindowSample::Impl
     const std::chrono::seconds windowTime_;
     const std::chrono::microseconds timeSlice_;
     std::uint32_t samplesInCurrentSlice_;
-    std::default_random_engine rng_;
-    std::uniform_int_distribution<std::uint32_t> dist_;
-    std::deque<std::pair<double, Clock::time_point>> values_;
+    // Set by Seed; otherwise draws come from the thread's generator.
+    std::unique_ptr<Xoshiro256> seeded_;
+
+    // A fixed-capacity ring of windowSize_ entries, oldest first starting at
+    // head_. Values and timestamps live in separate arrays so that snapshots
+    // copy values contiguously. Entries are only appended once the previous
+    // slice has ended, so timestamps are increasing and expiry can
+    // binary-search for the first live entry.
+    std::vector<double> values_;
+    std::vector<Clock::time_point> times_;
+    std::size_t head_;
+    std::size_t count_;
+
+    // The same values kept in ascending order, updated as entries are added,
+    // replaced and expired, so snapshots need no sort. Snapshots share it;
+    // it is copied before the next change if one is still holding it.
+    std::shared_ptr<std::vector<double>> sorted_;
+
+    std::size_t
+    Slot(std::size_t i) const
+    {
+        auto slot = head_ + i;
+        return slot < windowSize_ ? slot : slot - windowSize_;
+    }
+    std::vector<double>& MutableSorted();
+    void InsertSorted(double value);
+    void EraseSorted(double value);
+    void ReplaceSorted(double old, double value);
+    void PopFront(std::size_t n);
+    std::size_t CountExpired(Clock::time_point expiryTime) const;
 };
 
 SlidingWindowSample::SlidingWindowSample(std::size_t windowSize,
@@ -86,6 +118,17 @@ SlidingWindowSample::MakeSnapshot(uint64_t divisor) const
     return impl_->MakeSnapshot(divisor);
 }
 
+void
+SlidingWindowSample::Merge(const Sample& other)
+{
+    auto sliding = dynamic_cast<const SlidingWindowSample*>(&other);
+    if (!sliding)
+    {
+        throw std::invalid_argument("can only merge a SlidingWindowSample");
+    }
+    impl_->Merge(*sliding->impl_);
+}
+
 // === Implementation ===
 
 SlidingWindowSample::Impl::Impl(std::size_t windowSize,
@@ -96,9 +139,13 @@ SlidingWindowSample::Impl::Impl(std::size_t windowSize,
           std::chrono::duration_cast<std::chrono::microseconds>(windowTime) /
           windowSize)
     , samplesInCurrentSlice_(0)
-    , rng_(std::random_device()())
-    , dist_(0, std::numeric_limits<std::uint32_t>::max())
+    , values_(windowSize)
+    , times_(windowSize)
+    , head_(0)
+    , count_(0)
+    , sorted_(std::make_shared<std::vector<double>>())
 {
+    sorted_->reserve(windowSize);
     Clear();
 }
 
@@ -110,21 +157,121 @@ void
 SlidingWindowSample::Impl::Seed(size_t seed)
 {
     std::lock_guard<std::mutex> lock{mutex_};
-    rng_.seed(static_cast<std::uint32_t>(seed));
+    seeded_.reset(new Xoshiro256(seed));
 }
 
 void
 SlidingWindowSample::Impl::Clear()
 {
     std::lock_guard<std::mutex> lock{mutex_};
-    values_.clear();
+    head_ = 0;
+    count_ = 0;
+    MutableSorted().clear();
 }
 
 std::uint64_t
 SlidingWindowSample::Impl::size()
 {
     std::lock_guard<std::mutex> lock{mutex_};
-    return values_.size();
+    return count_;
+}
+
+std::vector<double>&
+SlidingWindowSample::Impl::MutableSorted()
+{
+    // Only this sample, under mutex_, ever adds a reference, so a count of
+    // one cannot go up behind our back.
+    if (sorted_.use_count() > 1)
+    {
+        auto copy = std::make_shared<std::vector<double>>();
+        copy->reserve(windowSize_);
+        copy->assign(sorted_->begin(), sorted_->end());
+        sorted_ = copy;
+    }
+    return *sorted_;
+}
+
+void
+SlidingWindowSample::Impl::InsertSorted(double value)
+{
+    auto& sorted = MutableSorted();
+    sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), value),
+                  value);
+}
+
+void
+SlidingWindowSample::Impl::EraseSorted(double value)
+{
+    auto& sorted = MutableSorted();
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), value);
+    assert(it != sorted.end() && *it == value);
+    sorted.erase(it);
+}
+
+void
+SlidingWindowSample::Impl::ReplaceSorted(double old, double value)
+{
+    // One shift of the values between the two positions, rather than
+    // closing the gap at one end and reopening it at the other.
+    auto& sorted = MutableSorted();
+    auto from = std::lower_bound(sorted.begin(), sorted.end(), old);
+    assert(from != sorted.end() && *from == old);
+    auto to = std::upper_bound(sorted.begin(), sorted.end(), value);
+    if (from < to)
+    {
+        std::move(from + 1, to, from);
+        *(to - 1) = value;
+    }
+    else
+    {
+        std::move_backward(to, from, from + 1);
+        *to = value;
+    }
+}
+
+void
+SlidingWindowSample::Impl::PopFront(std::size_t n)
+{
+    for (std::size_t i = 0; i < n; i++)
+    {
+        EraseSorted(values_[Slot(i)]);
+    }
+    head_ = Slot(n);
+    count_ -= n;
+}
+
+std::size_t
+SlidingWindowSample::Impl::CountExpired(Clock::time_point expiryTime) const
+{
+    if (count_ == 0 || !(times_[head_] < expiryTime))
+    {
+        return 0;
+    }
+    // Find the first entry that is still live. Usually only one or two
+    // entries expire per update, so gallop forward from the front before
+    // binary-searching, which makes retiring k entries O(log k). Entries
+    // before lo are known to have expired.
+    std::size_t lo = 1, step = 1;
+    while (lo + step <= count_ && times_[Slot(lo + step - 1)] < expiryTime)
+    {
+        lo += step;
+        step *= 2;
+    }
+    // The entry at hi, if any, is live.
+    std::size_t hi = std::min(lo + step - 1, count_);
+    while (lo < hi)
+    {
+        auto mid = lo + (hi - lo) / 2;
+        if (times_[Slot(mid)] < expiryTime)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
 }
 
 void
@@ -139,20 +286,23 @@ SlidingWindowSample::Impl::Update(std::int64_t value,
 {
     std::lock_guard<std::mutex> lock{mutex_};
 
-    if (!values_.empty())
+    if (windowSize_ == 0)
+    {
+        return;
+    }
+
+    // Old data is trimmed below, once we know whether the new value takes
+    // an expired entry's place.
+    std::size_t expired = 0;
+    if (count_ != 0)
     {
         // If we're in a new timeslice, reset count
-        if (timestamp > values_.back().second + timeSlice_)
+        if (timestamp > times_[Slot(count_ - 1)] + timeSlice_)
         {
             samplesInCurrentSlice_ = 0;
         }
 
-        // If there's old data, trim it.
-        Clock::time_point expiryTime = timestamp - windowTime_;
-        while (!values_.empty() && values_.front().second < expiryTime)
-        {
-            values_.pop_front();
-        }
+        expired = CountExpired(timestamp - windowTime_);
     }
 
     // When you add samples to the sliding window _slowly_ nothing goes wrong;
@@ -165,8 +315,10 @@ SlidingWindowSample::Impl::Update(std::int64_t value,
     // representative of the samples that arrive during that slice.
 
     // Check if we've already inserted an item for the same timeSlice.
-    if (!values_.empty() && timestamp <= values_.back().second + timeSlice_)
+    if (count_ != 0 && timestamp <= times_[Slot(count_ - 1)] + timeSlice_)
     {
+        PopFront(expired);
+
         // Here we're trying to cheaply (i.e. using only integer ops) calculate
         // a condition that results in each of N samples being chosen with
         // probability 1/N. Since we don't know N in advance, only as time
@@ -207,23 +359,42 @@ SlidingWindowSample::Impl::Update(std::int64_t value,
         // faithfully using integers when we write it as R*K <= M.
 
         samplesInCurrentSlice_++;
-        uint32_t r = dist_(rng_);
+        auto& rng = seeded_ ? *seeded_ : ThreadRandom();
+        uint32_t r = static_cast<uint32_t>(rng() >> 32);
         uint64_t rk = uint64_t(r) * uint64_t(samplesInCurrentSlice_);
         uint64_t m = uint64_t(std::numeric_limits<std::uint32_t>::max());
         if (rk <= m)
         {
             // Keep old timestamp to anchor timeSlice; but replace value.
-            values_.back().first = value;
+            auto slot = Slot(count_ - 1);
+            ReplaceSorted(values_[slot], value);
+            values_[slot] = value;
         }
     }
     else
     {
-        values_.emplace_back(value, timestamp);
-        samplesInCurrentSlice_ = 1;
-        if (values_.size() > windowSize_)
+        if (expired == 0 && count_ == windowSize_)
+        {
+            expired = 1;
+        }
+        if (expired > 0)
         {
-            values_.pop_front();
+            // The new value takes over the sorted position of the last
+            // entry to leave.
+            PopFront(expired - 1);
+            ReplaceSorted(values_[head_], value);
+            head_ = Slot(1);
+            --count_;
         }
+        else
+        {
+            InsertSorted(value);
+        }
+        auto slot = Slot(count_);
+        values_[slot] = value;
+        times_[slot] = timestamp;
+        ++count_;
+        samplesInCurrentSlice_ = 1;
     }
 }
 
@@ -231,13 +402,60 @@ Snapshot
 SlidingWindowSample::Impl::MakeSnapshot(uint64_t divisor)
 {
     std::lock_guard<std::mutex> lock{mutex_};
-    std::vector<double> vals;
-    vals.reserve(values_.size());
-    for (auto v : values_)
+    return {std::shared_ptr<const std::vector<double>>(sorted_), divisor};
+}
+
+void
+SlidingWindowSample::Impl::Merge(Impl& other)
+{
+    std::vector<double> values;
+    std::vector<Clock::time_point> times;
+    {
+        std::lock_guard<std::mutex> lock{other.mutex_};
+        values.reserve(other.count_);
+        times.reserve(other.count_);
+        for (std::size_t i = 0; i < other.count_; i++)
+        {
+            values.push_back(other.values_[other.Slot(i)]);
+            times.push_back(other.times_[other.Slot(i)]);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    // Walk both windows backwards from their newest entries, keeping as
+    // many as fit, then lay the survivors out oldest first from slot 0.
+    std::vector<double> mergedValues(windowSize_);
+    std::vector<Clock::time_point> mergedTimes(windowSize_);
+    std::size_t ours = count_, theirs = times.size(), kept = 0;
+    while (kept < windowSize_ && (ours > 0 || theirs > 0))
+    {
+        auto slot = windowSize_ - ++kept;
+        if (theirs == 0 ||
+            (ours > 0 && !(times_[Slot(ours - 1)] < times[theirs - 1])))
+        {
+            --ours;
+            mergedValues[slot] = values_[Slot(ours)];
+            mergedTimes[slot] = times_[Slot(ours)];
+        }
+        else
+        {
+            --theirs;
+            mergedValues[slot] = values[theirs];
+            mergedTimes[slot] = times[theirs];
+        }
+    }
+    values_.swap(mergedValues);
+    times_.swap(mergedTimes);
+    head_ = kept < windowSize_ ? windowSize_ - kept : 0;
+    count_ = kept;
+
+    auto& sorted = MutableSorted();
+    sorted.clear();
+    for (std::size_t i = 0; i < count_; i++)
     {
-        vals.emplace_back(v.first);
+        sorted.push_back(values_[Slot(i)]);
     }
-    return {vals, divisor};
+    std::sort(sorted.begin(), sorted.end());
 }
 
 } // namespace stats
@@ -27,12 +27,16 @@ class SlidingWindowSample : public Sample
     SlidingWindowSample(std::size_t windowSize,
                         std::chrono::seconds windowTime);
     ~SlidingWindowSample();
+    // Gives this sample a generator of its own, seeded with the argument,
+    // in place of the calling thread's.
     virtual void Seed(size_t);
     virtual void Clear();
     virtual std::uint64_t size() const;
     virtual void Update(std::int64_t value);
     virtual void Update(std::int64_t value, Clock::time_point timestamp);
     virtual Snapshot MakeSnapshot(uint64_t divisor = 1) const;
+    // Keeps the newest entries of both windows, up to this window's size.
+    virtual void Merge(const Sample& other);
 
   private:
     class Impl;
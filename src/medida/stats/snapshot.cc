@@ -9,6 +9,9 @@
 #include <cstddef>
 #include <stdexcept>
 #include <cassert>
+#include <mutex>
+
+#include "medida/stats/moments.h"
 
 namespace medida {
 namespace stats {
@@ -20,6 +23,13 @@ static const double kP98_Q = 0.98;
 static const double kP99_Q = 0.99;
 static const double kP999_Q = 0.999;
 
+// The quantiles every reporter reads, plus the max, in ascending order.
+static const double kStandardQuantiles[] = {
+  kMEDIAN_Q, kP75_Q, kP95_Q, kP98_Q, kP99_Q, kP999_Q, 1.0
+};
+static const std::size_t kStandardCount =
+    sizeof(kStandardQuantiles) / sizeof(kStandardQuantiles[0]);
+
 class Snapshot::Impl {
  public:
   virtual ~Impl();
@@ -32,21 +42,72 @@ class Snapshot::Impl {
   virtual double get99thPercentile() const;
   virtual double get999thPercentile() const;
   virtual double max() const = 0;
+  virtual double min() const = 0;
+  virtual double mean() const = 0;
+  virtual double std_dev() const = 0;
+  virtual double sum() const = 0;
   virtual std::vector<double> getValues() const = 0;
 };
 
 Snapshot::Impl::~Impl() {}
 
+namespace {
+
+// The neighbouring ranks that R7 interpolates between for a quantile, and
+// the weight of the upper one. hi == lo when there is no upper neighbour.
+struct R7Position {
+  std::size_t lo;
+  std::size_t hi;
+  double delta;
+};
+
+R7Position R7Locate(std::size_t size, double quantile);
+double R7Quantile(const std::vector<double>& values, double quantile);
+
+Moments Summarize(const std::vector<double>& values);
+
+} // namespace
+
+// Reporters read only a handful of quantiles, so rather than sorting the
+// whole sample up front, the ranks those quantiles need are selected in
+// place and their scaled values kept. Any other quantile, or the full list
+// of values, sorts the sample once on first use.
 class Snapshot::VectorImpl : public Snapshot::Impl {
  public:
-  VectorImpl(const std::vector<double>& values, uint64_t divisor = 1);
+  VectorImpl(std::vector<double> values, uint64_t divisor = 1);
   ~VectorImpl();
   std::size_t size() const override;
   double getValue(double quantile) const override;
   double max() const override;
+  double min() const override;
+  double mean() const override;
+  double std_dev() const override;
+  double sum() const override;
+  std::vector<double> getValues() const override;
+ private:
+  void sort() const;
+  mutable std::vector<double> values_;
+  double const divisor_;
+  double standard_[kStandardCount];
+  mutable std::once_flag sorted_;
+};
+
+
+class Snapshot::SortedImpl : public Snapshot::Impl {
+ public:
+  SortedImpl(std::shared_ptr<const std::vector<double>> sorted, uint64_t divisor = 1);
+  ~SortedImpl();
+  std::size_t size() const override;
+  double getValue(double quantile) const override;
+  double max() const override;
+  double min() const override;
+  double mean() const override;
+  double std_dev() const override;
+  double sum() const override;
   std::vector<double> getValues() const override;
  private:
-  std::vector<double> values_;
+  std::shared_ptr<const std::vector<double>> sorted_;
+  double const divisor_;
 };
 
 
@@ -57,6 +118,10 @@ class Snapshot::CKMSImpl : public Snapshot::Impl {
   std::size_t size() const override;
   double getValue(double quantile) const override;
   double max() const override;
+  double min() const override;
+  double mean() const override;
+  double std_dev() const override;
+  double sum() const override;
   std::vector<double> getValues() const override;
  private:
   std::shared_ptr<CKMS> ckms_;
@@ -64,14 +129,65 @@ class Snapshot::CKMSImpl : public Snapshot::Impl {
 };
 
 
+class Snapshot::DDSketchImpl : public Snapshot::Impl {
+ public:
+  DDSketchImpl(const DDSketch& sketch, uint64_t divisor = 1);
+  std::size_t size() const override;
+  double getValue(double quantile) const override;
+  double max() const override;
+  double min() const override;
+  double mean() const override;
+  double std_dev() const override;
+  double sum() const override;
+  std::vector<double> getValues() const override;
+ private:
+  DDSketch const sketch_;
+  uint64_t const divisor_;
+};
+
+
+class Snapshot::TDigestImpl : public Snapshot::Impl {
+ public:
+  TDigestImpl(const TDigest& digest, uint64_t divisor = 1);
+  std::size_t size() const override;
+  double getValue(double quantile) const override;
+  double max() const override;
+  double min() const override;
+  double mean() const override;
+  double std_dev() const override;
+  double sum() const override;
+  std::vector<double> getValues() const override;
+ private:
+  // Flushed, so that reads leave it alone.
+  TDigest digest_;
+  uint64_t const divisor_;
+};
+
+
 Snapshot::Snapshot(const std::vector<double>& values, uint64_t divisor)
   : impl_ {new Snapshot::VectorImpl {values, divisor}} {
 }
 
+Snapshot::Snapshot(std::vector<double>&& values, uint64_t divisor)
+  : impl_ {new Snapshot::VectorImpl {std::move(values), divisor}} {
+}
+
+Snapshot::Snapshot(std::shared_ptr<const std::vector<double>> sorted, uint64_t divisor)
+  : impl_ {new Snapshot::SortedImpl {sorted, divisor}} {
+}
+
 Snapshot::Snapshot(const CKMS& ckms, uint64_t divisor)
   : impl_ {new Snapshot::CKMSImpl {ckms, divisor}} {
 }
 
+Snapshot::Snapshot(const DDSketch& sketch, uint64_t divisor)
+  : impl_ {new Snapshot::DDSketchImpl {sketch, divisor}} {
+}
+
+Snapshot::Snapshot(const TDigest& digest, uint64_t divisor)
+  : impl_ {new Snapshot::TDigestImpl {digest, divisor}} {
+}
+
 Snapshot::Snapshot(Snapshot&& other)
     : impl_ {std::move(other.impl_)} {
 }
@@ -97,6 +213,26 @@ double Snapshot::max() const {
   return impl_->max();
 }
 
+double Snapshot::min() const {
+  checkImpl();
+  return impl_->min();
+}
+
+double Snapshot::mean() const {
+  checkImpl();
+  return impl_->mean();
+}
+
+double Snapshot::std_dev() const {
+  checkImpl();
+  return impl_->std_dev();
+}
+
+double Snapshot::sum() const {
+  checkImpl();
+  return impl_->sum();
+}
+
 std::vector<double> Snapshot::getValues() const {
   checkImpl();
   return impl_->getValues();
@@ -148,12 +284,45 @@ double Snapshot::get999thPercentile() const {
 // === Implementation ===
 
 
-Snapshot::VectorImpl::VectorImpl(const std::vector<double>& values, uint64_t divisor)
-    : values_ (values) {
-  std::sort(std::begin(this->values_), std::end(this->values_));
-  std::for_each(std::begin(this->values_),
-                std::end(this->values_),
-                [divisor](double& v) { v /= divisor; } );
+Snapshot::VectorImpl::VectorImpl(std::vector<double> values, uint64_t divisor)
+    : values_  (std::move(values)),
+      divisor_ (divisor) {
+  R7Position positions[kStandardCount];
+  for (std::size_t i = 0; i < kStandardCount; i++) {
+    positions[i] = R7Locate(values_.size(), kStandardQuantiles[i]);
+  }
+  if (!values_.empty()) {
+    // The quantiles ascend, so each selection only has to search the part
+    // of the sample above the previous one. An upper neighbour directly
+    // follows its lower rank and is just the minimum of what is left.
+    auto begin = std::begin(values_);
+    auto end = std::end(values_);
+    auto first = begin;
+    for (auto& p : positions) {
+      for (auto rank : {p.lo, p.hi}) {
+        auto nth = begin + rank;
+        if (nth < first) {
+          continue;
+        }
+        if (nth == first) {
+          std::iter_swap(nth, std::min_element(nth, end));
+        } else {
+          std::nth_element(first, nth, end);
+        }
+        first = nth + 1;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < kStandardCount; i++) {
+    auto& p = positions[i];
+    if (values_.empty()) {
+      standard_[i] = 0.0;
+    } else {
+      auto lower = values_[p.lo];
+      auto upper = values_[p.hi];
+      standard_[i] = (lower + p.delta * (upper - lower)) / divisor_;
+    }
+  }
 }
 
 
@@ -161,22 +330,159 @@ Snapshot::VectorImpl::~VectorImpl() {
 }
 
 
+void Snapshot::VectorImpl::sort() const {
+  std::call_once(sorted_, [this] {
+    std::sort(std::begin(values_), std::end(values_));
+  });
+}
+
+
 std::size_t Snapshot::VectorImpl::size() const {
  return values_.size();
 }
 
 
 double Snapshot::VectorImpl::max() const {
-  return getValue(1.0);
+  return standard_[kStandardCount - 1];
+}
+
+
+double Snapshot::VectorImpl::min() const {
+  return Summarize(values_).min() / divisor_;
+}
+
+
+double Snapshot::VectorImpl::mean() const {
+  return Summarize(values_).mean() / divisor_;
+}
+
+
+double Snapshot::VectorImpl::std_dev() const {
+  return std::sqrt(Summarize(values_).variance()) / divisor_;
+}
+
+
+double Snapshot::VectorImpl::sum() const {
+  return Summarize(values_).sum() / divisor_;
 }
 
 
 std::vector<double> Snapshot::VectorImpl::getValues() const {
-  return values_;
+  sort();
+  std::vector<double> values;
+  values.reserve(values_.size());
+  for (auto v : values_) {
+    values.push_back(v / divisor_);
+  }
+  return values;
 }
 
 
 double Snapshot::VectorImpl::getValue(double quantile) const
+{
+    for (std::size_t i = 0; i < kStandardCount; i++)
+    {
+        if (quantile == kStandardQuantiles[i])
+        {
+            return standard_[i];
+        }
+    }
+    sort();
+    return R7Quantile(values_, quantile) / divisor_;
+}
+
+
+Snapshot::SortedImpl::SortedImpl(std::shared_ptr<const std::vector<double>> sorted,
+                                 uint64_t divisor)
+    : sorted_  (sorted),
+      divisor_ (divisor) {
+}
+
+
+Snapshot::SortedImpl::~SortedImpl() {
+}
+
+
+std::size_t Snapshot::SortedImpl::size() const {
+  return sorted_->size();
+}
+
+
+double Snapshot::SortedImpl::max() const {
+  return getValue(1.0);
+}
+
+
+double Snapshot::SortedImpl::min() const {
+  return getValue(0.0);
+}
+
+
+double Snapshot::SortedImpl::mean() const {
+  return Summarize(*sorted_).mean() / divisor_;
+}
+
+
+double Snapshot::SortedImpl::std_dev() const {
+  return std::sqrt(Summarize(*sorted_).variance()) / divisor_;
+}
+
+
+double Snapshot::SortedImpl::sum() const {
+  return Summarize(*sorted_).sum() / divisor_;
+}
+
+
+std::vector<double> Snapshot::SortedImpl::getValues() const {
+  std::vector<double> values;
+  values.reserve(sorted_->size());
+  for (auto v : *sorted_) {
+    values.push_back(v / divisor_);
+  }
+  return values;
+}
+
+
+double Snapshot::SortedImpl::getValue(double quantile) const {
+  // Interpolation is linear, so scaling the result is the same as scaling
+  // every value first.
+  return R7Quantile(*sorted_, quantile) / divisor_;
+}
+
+
+namespace {
+
+R7Position R7Locate(std::size_t size, double quantile)
+{
+    // Step 1: define range of actually-allowed indexes: [0, max_idx]
+    size_t max_idx = size == 0 ? 0 : size - 1;
+
+    // Step 2: calculate "ideal" fractional index (with 1.0 => max_idx).
+    double ideal_index = quantile * max_idx;
+
+    // Step 3: calculate ideal-index floor and integral low and hi indexes.
+    double floor_ideal = std::floor(ideal_index);
+    assert(floor_ideal >= 0.0);
+    size_t lo_idx = static_cast<size_t>(floor_ideal);
+    assert(lo_idx <= max_idx);
+    size_t hi_idx = lo_idx + 1;
+
+    // Step 4: if there's no upper sample to interpolate with, the lower one
+    // is the highest and is taken as is.
+    if (hi_idx > max_idx)
+    {
+        return {lo_idx, lo_idx, 0.0};
+    }
+
+    // Step 5: weight for linear interpolation of elements at lo_idx and
+    // hi_idx.
+    double delta = ideal_index - floor_ideal;
+    assert(delta >= 0.0);
+    assert(delta < 1.0);
+    return {lo_idx, hi_idx, delta};
+}
+
+double R7Quantile(const std::vector<double>& values, double quantile)
 {
     // Calculating a quantile is _mostly_ just about scaling the requested
     // quantile from the range it's given in [0.0, 1.0] to an index value in the
@@ -207,40 +513,29 @@ double Snapshot::VectorImpl::getValue(double quantile) const
         throw std::invalid_argument("quantile is not in [0..1]");
     }
 
-    if (values_.empty())
+    if (values.empty())
     {
         return 0.0;
     }
 
-    // Step 1: define range of actually-allowed indexes: [0, max_idx]
-    size_t max_idx = values_.size() - 1;
-
-    // Step 2: calculate "ideal" fractional index (with 1.0 => max_idx).
-    double ideal_index = quantile * max_idx;
-
-    // Step 3: calculate ideal-index floor and integral low and hi indexes.
-    double floor_ideal = std::floor(ideal_index);
-    assert(floor_ideal >= 0.0);
-    size_t lo_idx = static_cast<size_t>(floor_ideal);
-    assert(lo_idx <= max_idx);
-    size_t hi_idx = lo_idx + 1;
+    auto p = R7Locate(values.size(), quantile);
+    double lower = values.at(p.lo);
+    double upper = values.at(p.hi);
+    return lower + (p.delta * (upper - lower));
+}
 
-    // Step 4: if there's no upper sample to interpolate with, just return
-    // the highest one.
-    if (hi_idx > max_idx)
+Moments Summarize(const std::vector<double>& values)
+{
+    Moments moments;
+    for (auto v : values)
     {
-        return values_.back();
+        moments.insert(v);
     }
-
-    // Step 5: return linear interpolation of elements at lo_idx and hi_idx.
-    double delta = ideal_index - floor_ideal;
-    assert(delta >= 0.0);
-    assert(delta < 1.0);
-    double lower = values_.at(lo_idx);
-    double upper = values_.at(hi_idx);
-    return lower + (delta * (upper - lower));
+    return moments;
 }
 
+} // namespace
+
 Snapshot::CKMSImpl::CKMSImpl(const CKMS & ckms, uint64_t divisor)
     : ckms_ (std::make_shared<CKMS>(ckms)),
       divisor_ (divisor) {
@@ -264,10 +559,117 @@ double Snapshot::CKMSImpl::max() const {
     return ckms_->max() / (double) divisor_;
 }
 
+double Snapshot::CKMSImpl::min() const {
+    return ckms_->min() / (double) divisor_;
+}
+
+double Snapshot::CKMSImpl::mean() const {
+    return ckms_->mean() / (double) divisor_;
+}
+
+double Snapshot::CKMSImpl::std_dev() const {
+    return std::sqrt(ckms_->variance()) / (double) divisor_;
+}
+
+double Snapshot::CKMSImpl::sum() const {
+    return ckms_->sum() / (double) divisor_;
+}
+
 double Snapshot::CKMSImpl::getValue(double quantile) const {
     return ckms_->get(quantile) / (double) divisor_;
 }
 
+Snapshot::DDSketchImpl::DDSketchImpl(const DDSketch& sketch, uint64_t divisor)
+    : sketch_ (sketch),
+      divisor_ (divisor) {
+}
+
+
+std::size_t Snapshot::DDSketchImpl::size() const {
+    return sketch_.count();
+}
+
+
+std::vector<double> Snapshot::DDSketchImpl::getValues() const {
+    throw std::runtime_error("Can't return the values since a sketch doesn't have them");
+}
+
+
+double Snapshot::DDSketchImpl::max() const {
+    return sketch_.max() / (double) divisor_;
+}
+
+
+double Snapshot::DDSketchImpl::min() const {
+    return sketch_.min() / (double) divisor_;
+}
+
+
+double Snapshot::DDSketchImpl::mean() const {
+    return sketch_.mean() / (double) divisor_;
+}
+
+
+double Snapshot::DDSketchImpl::std_dev() const {
+    return std::sqrt(sketch_.variance()) / (double) divisor_;
+}
+
+
+double Snapshot::DDSketchImpl::sum() const {
+    return sketch_.sum() / (double) divisor_;
+}
+
+
+double Snapshot::DDSketchImpl::getValue(double quantile) const {
+    return sketch_.get(quantile) / (double) divisor_;
+}
+
+Snapshot::TDigestImpl::TDigestImpl(const TDigest& digest, uint64_t divisor)
+    : digest_ (digest),
+      divisor_ (divisor) {
+    digest_.flush();
+}
+
+
+std::size_t Snapshot::TDigestImpl::size() const {
+    return digest_.count();
+}
+
+
+std::vector<double> Snapshot::TDigestImpl::getValues() const {
+    throw std::runtime_error("Can't return the values since a digest doesn't have them");
+}
+
+
+double Snapshot::TDigestImpl::max() const {
+    return digest_.max() / (double) divisor_;
+}
+
+
+double Snapshot::TDigestImpl::min() const {
+    return digest_.min() / (double) divisor_;
+}
+
+
+double Snapshot::TDigestImpl::mean() const {
+    return digest_.mean() / (double) divisor_;
+}
+
+
+double Snapshot::TDigestImpl::std_dev() const {
+    return std::sqrt(digest_.variance()) / (double) divisor_;
+}
+
+
+double Snapshot::TDigestImpl::sum() const {
+    return digest_.sum() / (double) divisor_;
+}
+
+
+double Snapshot::TDigestImpl::getValue(double quantile) const {
+    return digest_.get(quantile) / (double) divisor_;
+}
+
 double Snapshot::Impl::getMedian() const {
   return getValue(kMEDIAN_Q);
 }
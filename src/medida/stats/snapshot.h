@@ -6,6 +6,8 @@
 #define MEDIDA_METRICS_SNAPSHOT_H_
 
 #include "medida/stats/ckms.h"
+#include "medida/stats/ddsketch.h"
+#include "medida/stats/tdigest.h"
 
 #include <memory>
 #include <vector>
@@ -16,7 +18,15 @@ namespace stats {
 class Snapshot {
  public:
   Snapshot(const std::vector<double>& values, uint64_t divisor = 1);
+  // Adopts the caller's buffer instead of copying it.
+  Snapshot(std::vector<double>&& values, uint64_t divisor = 1);
+  // Shares values that the caller already keeps in ascending order, so
+  // neither a copy nor a sort is needed. The caller must not modify them
+  // afterwards.
+  Snapshot(std::shared_ptr<const std::vector<double>> sorted, uint64_t divisor = 1);
   Snapshot(const CKMS& ckms, uint64_t divisor = 1);
+  Snapshot(const DDSketch& sketch, uint64_t divisor = 1);
+  Snapshot(const TDigest& digest, uint64_t divisor = 1);
   ~Snapshot();
   Snapshot(Snapshot const&) = delete;
   Snapshot& operator=(Snapshot const&) = delete;
@@ -30,10 +40,20 @@ class Snapshot {
   double get99thPercentile() const;
   double get999thPercentile() const;
   double max() const;
+  // Exact summary statistics of the values the snapshot covers, all 0 if
+  // there are none; std_dev is that of a sample. Windowed snapshots cover
+  // the same windows as their quantiles.
+  double min() const;
+  double mean() const;
+  double std_dev() const;
+  double sum() const;
   std::vector<double> getValues() const;
   class Impl;
   class VectorImpl;
+  class SortedImpl;
   class CKMSImpl;
+  class DDSketchImpl;
+  class TDigestImpl;
  private:
   void checkImpl() const;
   std::unique_ptr<Impl> impl_;
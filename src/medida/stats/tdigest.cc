@@ -0,0 +1,279 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/tdigest.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+#include "medida/encoding.h"
+
+namespace medida {
+namespace stats {
+
+namespace {
+
+// Values buffered per unit of compression before a merge pass.
+const std::size_t kBufferFactor = 5;
+
+const char kMagic[] = {'T', 'D', 'G', '2'};
+
+} // namespace
+
+
+TDigest::TDigest(double compression)
+    : compression_ {compression},
+      buffer_limit_ {static_cast<std::size_t>(std::ceil(compression * kBufferFactor))},
+      centroid_weight_ {0},
+      buffer_weight_ {0},
+      reverse_merge_ {false} {
+  if (!(compression >= 1)) {
+    throw std::invalid_argument("t-digest compression must be at least 1");
+  }
+}
+
+
+void TDigest::insert(double value) {
+  moments_.insert(value);
+  buffer_.push_back({value, 1});
+  buffer_weight_ += 1;
+  if (buffer_.size() >= buffer_limit_) {
+    flush();
+  }
+}
+
+
+void TDigest::merge(const TDigest& other) {
+  if (other.count() == 0) {
+    return;
+  }
+  moments_.merge(other.moments_);
+  buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+  buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+  buffer_weight_ += other.centroid_weight_ + other.buffer_weight_;
+  flush();
+}
+
+
+double TDigest::get(double q) {
+  flush();
+  return static_cast<const TDigest&>(*this).get(q);
+}
+
+
+double TDigest::get(double q) const {
+  assert(buffer_.empty());
+  if (centroids_.empty()) {
+    return 0.0;
+  }
+  if (q <= 0) {
+    return min();
+  }
+  if (q >= 1) {
+    return max();
+  }
+  if (centroids_.size() == 1) {
+    return centroids_[0].mean;
+  }
+
+  // Each centroid's weight is taken to be spread evenly around its mean,
+  // half below and half above; a singleton sits exactly on its value.
+  auto total = centroid_weight_;
+  auto index = q * total;
+  auto& first = centroids_.front();
+  if (index < first.weight / 2) {
+    if (first.weight == 1) {
+      return min();
+    }
+    return min() + (first.mean - min()) * index / (first.weight / 2);
+  }
+  auto& last = centroids_.back();
+  if (index > total - last.weight / 2) {
+    if (last.weight == 1) {
+      return max();
+    }
+    return max() - (max() - last.mean) * (total - index) / (last.weight / 2);
+  }
+
+  auto so_far = first.weight / 2;
+  for (std::size_t i = 0; i + 1 < centroids_.size(); i++) {
+    auto& a = centroids_[i];
+    auto& b = centroids_[i + 1];
+    auto gap = (a.weight + b.weight) / 2;
+    if (so_far + gap > index) {
+      double left = 0, right = 0;
+      if (a.weight == 1) {
+        if (index - so_far < 0.5) {
+          return a.mean;
+        }
+        left = 0.5;
+      }
+      if (b.weight == 1) {
+        if (so_far + gap - index <= 0.5) {
+          return b.mean;
+        }
+        right = 0.5;
+      }
+      auto z1 = index - so_far - left;
+      auto z2 = so_far + gap - index - right;
+      return (a.mean * z2 + b.mean * z1) / (z1 + z2);
+    }
+    so_far += gap;
+  }
+  return last.mean;
+}
+
+
+void TDigest::reset() {
+  centroids_.clear();
+  buffer_.clear();
+  centroid_weight_ = 0;
+  buffer_weight_ = 0;
+  moments_.reset();
+}
+
+
+std::size_t TDigest::count() const {
+  return static_cast<std::size_t>(centroid_weight_ + buffer_weight_);
+}
+
+
+double TDigest::min() const {
+  return moments_.min();
+}
+
+
+double TDigest::max() const {
+  return moments_.max();
+}
+
+
+double TDigest::sum() const {
+  return moments_.sum();
+}
+
+
+double TDigest::mean() const {
+  return moments_.mean();
+}
+
+
+double TDigest::variance() const {
+  return moments_.variance();
+}
+
+
+double TDigest::compression() const {
+  return compression_;
+}
+
+
+std::size_t TDigest::centroid_count() {
+  flush();
+  return centroids_.size();
+}
+
+
+void TDigest::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+  auto by_mean = [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; };
+  std::sort(buffer_.begin(), buffer_.end(), by_mean);
+  std::vector<Centroid> all;
+  all.reserve(centroids_.size() + buffer_.size());
+  std::merge(centroids_.begin(), centroids_.end(), buffer_.begin(), buffer_.end(),
+             std::back_inserter(all), by_mean);
+  buffer_.clear();
+  auto total = centroid_weight_ + buffer_weight_;
+  centroid_weight_ = total;
+  buffer_weight_ = 0;
+
+  // k2 and its inverse. A centroid may span one unit of k, so it may grow
+  // until the running weight reaches the quantile one unit further on.
+  // k2 is unbounded at both ends, so the extreme centroids shrink to single
+  // values; the normalizer keeps the count near `compression` whatever the
+  // total.
+  auto normalizer = compression_ / (4 * std::log(std::max(total / compression_, 1.0)) + 24);
+  auto k = [normalizer](double q) { return normalizer * std::log(q / (1 - q)); };
+  auto k_inverse = [normalizer](double k) { return 1 / (1 + std::exp(-k / normalizer)); };
+
+  // Building from the low end lets centroids just above each boundary grow
+  // a little too large, so alternate ends to keep that from biasing one tail.
+  reverse_merge_ = !reverse_merge_;
+  if (reverse_merge_) {
+    std::reverse(all.begin(), all.end());
+  }
+
+  centroids_.clear();
+  auto current = all.front();
+  double so_far = 0;
+  auto limit = total * k_inverse(k(0) + 1);
+  for (std::size_t i = 1; i < all.size(); i++) {
+    auto& next = all[i];
+    if (so_far + current.weight + next.weight <= limit) {
+      current.weight += next.weight;
+      current.mean += (next.mean - current.mean) * next.weight / current.weight;
+    } else {
+      so_far += current.weight;
+      centroids_.push_back(current);
+      limit = total * k_inverse(k(so_far / total) + 1);
+      current = next;
+    }
+  }
+  centroids_.push_back(current);
+  if (reverse_merge_) {
+    std::reverse(centroids_.begin(), centroids_.end());
+  }
+}
+
+
+std::string TDigest::serialize() const {
+  TDigest flushed {*this};
+  flushed.flush();
+  std::string out(kMagic, sizeof(kMagic));
+  encoding::PutDouble(out, flushed.compression_);
+  flushed.moments_.serialize(out);
+  encoding::PutDouble(out, static_cast<double>(flushed.centroids_.size()));
+  for (auto& c : flushed.centroids_) {
+    encoding::PutDouble(out, c.mean);
+    encoding::PutDouble(out, c.weight);
+  }
+  return out;
+}
+
+
+TDigest TDigest::deserialize(const std::string& bytes) {
+  encoding::Reader in {bytes, "t-digest"};
+  if (!in.Expect(kMagic, sizeof(kMagic))) {
+    throw std::invalid_argument("not a serialized t-digest");
+  }
+  TDigest digest {in.GetDouble()};
+  digest.moments_ = Moments::deserialize(in);
+  auto n = in.GetDouble();
+  if (!(n >= 0) || n != std::floor(n) || n * 16 != in.remaining()) {
+    in.Malformed();
+  }
+  for (std::size_t i = 0; i < n; i++) {
+    Centroid c;
+    c.mean = in.GetDouble();
+    c.weight = in.GetDouble();
+    if (!(c.weight > 0) || (!digest.centroids_.empty() && c.mean < digest.centroids_.back().mean)) {
+      in.Malformed();
+    }
+    digest.centroids_.push_back(c);
+    digest.centroid_weight_ += c.weight;
+  }
+  if (digest.moments_.count() != digest.count()) {
+    in.Malformed();
+  }
+  return digest;
+}
+
+} // namespace stats
+} // namespace medida
@@ -0,0 +1,82 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_TDIGEST_H_
+#define MEDIDA_TDIGEST_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "medida/stats/moments.h"
+
+namespace medida {
+namespace stats {
+
+// A merging t-digest (Dunning and Ertl, 2019): a quantile summary of
+// weighted centroids that are kept small near the extremes and allowed to
+// grow in the middle, so that p99.9 and p99.99 are far more accurate per
+// byte than the median.
+//
+// Inserts go to a buffer. When it fills, it is sorted and merged with the
+// existing centroids in one pass, which combines neighbours for as long as
+// the k2 scale function, k(q) = compression / Z(n) * log(q / (1 - q)),
+// allows. Z(n) = 4 log(n / compression) + 24 holds the digest to at most
+// about `compression` centroids, and the smallest and largest few values
+// stay in centroids of their own.
+class TDigest {
+ public:
+  explicit TDigest(double compression = 100);
+
+  void insert(double value);
+  // Folds in another digest, whatever its compression; the result keeps
+  // this one's.
+  void merge(const TDigest& other);
+  // The value at quantile q in [0, 1], interpolated between centroids, or
+  // 0 for an empty digest. The const overload leaves the buffer alone, so
+  // it needs a digest with nothing buffered, as flush leaves it.
+  double get(double q);
+  double get(double q) const;
+  // Merges the buffered values into the centroids.
+  void flush();
+  void reset();
+  std::size_t count() const;
+  // Exact, like the extremes; all 0 while empty.
+  double min() const;
+  double max() const;
+  double sum() const;
+  double mean() const;
+  double variance() const;
+  double compression() const;
+  // Centroids held once the buffer is merged in.
+  std::size_t centroid_count();
+
+  // A compact, byte-order independent encoding of the digest, which
+  // deserialize turns back into an equal one. deserialize throws
+  // std::invalid_argument for anything serialize could not have produced.
+  std::string serialize() const;
+  static TDigest deserialize(const std::string& bytes);
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  double compression_;
+  std::size_t buffer_limit_;
+  // Sorted by mean once flushed.
+  std::vector<Centroid> centroids_;
+  std::vector<Centroid> buffer_;
+  double centroid_weight_;
+  double buffer_weight_;
+  Moments moments_;
+  // Whether the last merge pass ran from the high end.
+  bool reverse_merge_;
+};
+
+} // namespace stats
+} // namespace medida
+
+#endif // MEDIDA_TDIGEST_H_
@@ -6,13 +6,28 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <mutex>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
+#include "medida/stats/random.h"
+
 namespace medida {
 namespace stats {
 
+// Once the reservoir is full, updates are selected with Algorithm L (Li,
+// 1994): rather than drawing a random number per update to decide whether
+// it replaces an entry, it draws the number of updates to skip before the
+// next replacement. next_ holds the ticket number of that replacement, so a
+// skipped update costs one atomic increment and one load, takes no lock and
+// consults no RNG.
+//
+// Concurrent updates have no defined order, so when an update lands on the
+// slow path at or past next_, it takes that replacement even if its own
+// ticket was not the chosen one. Each selection is consumed exactly once and
+// the sample stays uniform.
 class UniformSample::Impl {
  public:
   Impl(std::uint32_t reservoirSize);
@@ -21,11 +36,15 @@ class UniformSample::Impl {
   std::uint64_t size() const;
   void Update(std::int64_t value);
   Snapshot MakeSnapshot(uint64_t divisor) const;
+  void Merge(const Impl& other);
  private:
   std::atomic<std::uint64_t> count_;
+  std::atomic<std::uint64_t> next_;
   std::vector<std::int64_t> values_;
-  mutable std::mt19937_64 rng_;
+  double w_;
   mutable std::mutex mutex_;
+  double Random();
+  std::uint64_t NextGap();
 };
 
 
@@ -58,13 +77,23 @@ Snapshot UniformSample::MakeSnapshot(uint64_t divisor) const {
 }
 
 
+void UniformSample::Merge(const Sample& other) {
+  auto uniform = dynamic_cast<const UniformSample*>(&other);
+  if (!uniform) {
+    throw std::invalid_argument("can only merge a UniformSample");
+  }
+  impl_->Merge(*uniform->impl_);
+}
+
+
 // === Implementation ===
 
 
 UniformSample::Impl::Impl(std::uint32_t reservoirSize)
     : count_          {},
+      next_           {},
       values_         (reservoirSize), // FIXME: Explicit and non-uniform
-      rng_            {std::random_device()()},
+      w_              {},
       mutex_          {} {
     Clear();
 }
@@ -80,6 +109,10 @@ void UniformSample::Impl::Clear() {
     v = 0;
   }
   count_ = 0;
+  // The first update past a full reservoir takes the slow path, which
+  // starts the skip sequence.
+  next_ = values_.size() + 1;
+  w_ = 0.0;
 }
 
 
@@ -92,17 +125,93 @@ std::uint64_t UniformSample::Impl::size() const {
 
 void UniformSample::Impl::Update(std::int64_t value) {
   auto count = ++count_;
-  std::lock_guard<std::mutex> lock {mutex_};
   auto size = values_.size();
-  if (count < size) {
+  if (size == 0 || (count > size && count < next_.load(std::memory_order_relaxed))) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock {mutex_};
+  if (count <= size) {
     values_[count - 1] = value;
-  } else {
-    std::uniform_int_distribution<uint64_t> uniform(0, count - 1);
-    auto rand = uniform(rng_);
-    if (rand < size) {
-      values_[rand] = value;
+    return;
+  }
+  if (w_ == 0.0) {
+    w_ = std::exp(std::log(Random()) / size);
+    next_ = size + NextGap();
+  }
+  auto next = next_.load(std::memory_order_relaxed);
+  if (count < next) {
+    return;
+  }
+  std::uniform_int_distribution<std::size_t> uniform(0, size - 1);
+  values_[uniform(ThreadRandom())] = value;
+  w_ *= std::exp(std::log(Random()) / size);
+  next_.store(next + NextGap(), std::memory_order_relaxed);
+}
+
+
+double UniformSample::Impl::Random() {
+  // In (0, 1], so its log is finite.
+  return 1.0 - ThreadRandom().NextDouble();
+}
+
+
+std::uint64_t UniformSample::Impl::NextGap() {
+  // One past the number of updates to skip, which is geometric with
+  // success probability w_.
+  auto skip = std::floor(std::log(Random()) / std::log1p(-w_));
+  if (!(skip < 1e18)) {
+    skip = 1e18;
+  }
+  return static_cast<std::uint64_t>(skip) + 1;
+}
+
+
+void UniformSample::Impl::Merge(const Impl& other) {
+  std::vector<std::int64_t> theirs;
+  std::uint64_t b;
+  {
+    std::lock_guard<std::mutex> lock {other.mutex_};
+    b = other.count_.load();
+    auto begin = std::begin(other.values_);
+    theirs.assign(begin, begin + std::min<std::uint64_t>(b, other.values_.size()));
+  }
+  if (b == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock {mutex_};
+  auto size = values_.size();
+  auto a = count_.load();
+  auto begin = std::begin(values_);
+  std::vector<std::int64_t> ours(begin, begin + std::min<std::uint64_t>(a, size));
+  auto added = b;
+
+  // Fill each slot from one reservoir or the other, in proportion to the
+  // updates each still stands for, taking a random value not yet taken.
+  // Every update of the combined stream is then equally likely to be kept.
+  std::size_t filled = 0, ai = 0, bi = 0;
+  auto& rng = ThreadRandom();
+  auto take = [&rng](std::vector<std::int64_t>& from, std::size_t& i) {
+    std::uniform_int_distribution<std::size_t> pick(i, from.size() - 1);
+    std::swap(from[i], from[pick(rng)]);
+    return from[i++];
+  };
+  for (auto left = a + b; filled < size && left > 0; left--) {
+    if (std::uniform_int_distribution<std::uint64_t>(1, left)(rng) <= a) {
+      values_[filled++] = take(ours, ai);
+      a--;
+    } else {
+      values_[filled++] = take(theirs, bi);
+      b--;
     }
   }
+
+  auto count = count_ += added;
+  if (count > size) {
+    // Restart the skip sequence at the acceptance rate a reservoir that
+    // has seen this many updates would have reached.
+    w_ = static_cast<double>(size) / count;
+    next_ = count + NextGap();
+  }
 }
 
 
@@ -111,7 +220,8 @@ Snapshot UniformSample::Impl::MakeSnapshot(uint64_t divisor) const {
   std::uint64_t count = count_.load();
   std::lock_guard<std::mutex> lock {mutex_};
   auto begin = std::begin(values_);
-  return Snapshot {{begin, begin + std::min(count, size)}, divisor};
+  std::vector<double> vals(begin, begin + std::min(count, size));
+  return {std::move(vals), divisor};
 }
 
 
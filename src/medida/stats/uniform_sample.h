@@ -22,6 +22,7 @@ class UniformSample : public Sample {
   virtual std::uint64_t size() const;
   virtual void Update(std::int64_t value);
   virtual Snapshot MakeSnapshot(uint64_t divisor = 1) const;
+  virtual void Merge(const Sample& other);
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
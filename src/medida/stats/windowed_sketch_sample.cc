@@ -0,0 +1,309 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/windowed_sketch_sample.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+
+#include "medida/encoding.h"
+
+namespace medida {
+namespace stats {
+
+namespace {
+
+const std::size_t kMagicSize = 4;
+
+} // namespace
+
+template <typename Sketch>
+class WindowedSketchSample<Sketch>::Impl {
+ public:
+  Impl(std::chrono::seconds window_size, double parameter);
+  ~Impl();
+  void Clear();
+  std::uint64_t size(Clock::time_point timestamp);
+  void Update(std::int64_t value, Clock::time_point timestamp);
+  Snapshot MakeSnapshot(Clock::time_point timestamp, uint64_t divisor);
+  void Merge(Impl& other);
+  std::string SaveState(Clock::time_point timestamp);
+  void RestoreState(const std::string& state, Clock::duration idle,
+                    Clock::time_point timestamp);
+ private:
+  typedef SketchTraits<Sketch> Traits;
+  std::mutex mutex_;
+  Sketch current_;
+  Sketch previous_;
+  Clock::time_point cur_window_begin_;
+  Clock::time_point cur_window_end_;
+  std::chrono::seconds const window_size_;
+  // Moves the windows on to the one holding `timestamp`. Returns false if
+  // that is the previous window, which is kept immutable.
+  bool AdvanceWindows(Clock::time_point timestamp);
+};
+
+
+template <typename Sketch>
+WindowedSketchSample<Sketch>::WindowedSketchSample(std::chrono::seconds window_size,
+                                                   double parameter)
+    : impl_ {new WindowedSketchSample::Impl {window_size, parameter}} {
+}
+
+
+template <typename Sketch>
+WindowedSketchSample<Sketch>::~WindowedSketchSample() {
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::Clear() {
+  impl_->Clear();
+}
+
+
+template <typename Sketch>
+std::uint64_t WindowedSketchSample<Sketch>::size() const {
+  return impl_->size(CoarseClock::now());
+}
+
+
+template <typename Sketch>
+std::uint64_t WindowedSketchSample<Sketch>::size(Clock::time_point timestamp) const {
+  return impl_->size(timestamp);
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::Update(std::int64_t value) {
+  impl_->Update(value, CoarseClock::now());
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::Update(std::int64_t value, Clock::time_point timestamp) {
+  impl_->Update(value, timestamp);
+}
+
+
+template <typename Sketch>
+Snapshot WindowedSketchSample<Sketch>::MakeSnapshot(uint64_t divisor) const {
+  return impl_->MakeSnapshot(CoarseClock::now(), divisor);
+}
+
+
+template <typename Sketch>
+Snapshot WindowedSketchSample<Sketch>::MakeSnapshot(Clock::time_point timestamp,
+                                                    uint64_t divisor) const {
+  return impl_->MakeSnapshot(timestamp, divisor);
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::Merge(const Sample& other) {
+  auto sketch = dynamic_cast<const WindowedSketchSample*>(&other);
+  if (!sketch) {
+    throw std::invalid_argument(std::string("can only merge a ") +
+                                SketchTraits<Sketch>::sample_name());
+  }
+  impl_->Merge(*sketch->impl_);
+}
+
+
+template <typename Sketch>
+std::string WindowedSketchSample<Sketch>::SaveState() const {
+  return impl_->SaveState(CoarseClock::now());
+}
+
+
+template <typename Sketch>
+std::string WindowedSketchSample<Sketch>::SaveState(Clock::time_point timestamp) const {
+  return impl_->SaveState(timestamp);
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::RestoreState(const std::string& state, Clock::duration idle) {
+  impl_->RestoreState(state, idle, CoarseClock::now());
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::RestoreState(const std::string& state, Clock::duration idle,
+                                                Clock::time_point timestamp) {
+  impl_->RestoreState(state, idle, timestamp);
+}
+
+
+// === Implementation ===
+
+
+template <typename Sketch>
+WindowedSketchSample<Sketch>::Impl::Impl(std::chrono::seconds window_size, double parameter)
+    : current_ {parameter},
+      previous_ {parameter},
+      cur_window_begin_ {},
+      cur_window_end_ {cur_window_begin_ + window_size},
+      window_size_ {window_size} {
+}
+
+
+template <typename Sketch>
+WindowedSketchSample<Sketch>::Impl::~Impl() {
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::Impl::Clear() {
+  std::lock_guard<std::mutex> lock {mutex_};
+  current_.reset();
+  previous_.reset();
+  cur_window_begin_ = Clock::time_point();
+  cur_window_end_ = cur_window_begin_ + window_size_;
+}
+
+
+template <typename Sketch>
+std::uint64_t WindowedSketchSample<Sketch>::Impl::size(Clock::time_point timestamp) {
+  return MakeSnapshot(timestamp, 1).size();
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::Impl::Update(std::int64_t value, Clock::time_point timestamp) {
+  std::lock_guard<std::mutex> lock {mutex_};
+  if (AdvanceWindows(timestamp)) {
+    current_.insert(value);
+  }
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::Impl::Merge(Impl& other) {
+  if (window_size_ != other.window_size_) {
+    throw std::invalid_argument("can only merge samples with the same window size");
+  }
+  auto parameter = Traits::parameter(current_);
+  if (parameter != Traits::parameter(other.current_)) {
+    throw std::invalid_argument(std::string("can only merge samples with the same ") +
+                                Traits::parameter_name());
+  }
+  Sketch their_current {parameter};
+  Sketch their_previous {parameter};
+  Clock::time_point their_begin;
+  {
+    std::lock_guard<std::mutex> lock {other.mutex_};
+    their_current = other.current_;
+    their_previous = other.previous_;
+    their_begin = other.cur_window_begin_;
+  }
+
+  std::lock_guard<std::mutex> lock {mutex_};
+  if (cur_window_begin_ < their_begin) {
+    AdvanceWindows(their_begin);
+  }
+  if (cur_window_begin_ == their_begin) {
+    current_.merge(their_current);
+    previous_.merge(their_previous);
+  } else if (cur_window_begin_ == their_begin + window_size_) {
+    previous_.merge(their_current);
+  }
+}
+
+
+template <typename Sketch>
+std::string WindowedSketchSample<Sketch>::Impl::SaveState(Clock::time_point timestamp) {
+  std::lock_guard<std::mutex> lock {mutex_};
+  AdvanceWindows(timestamp);
+  std::string out(Traits::magic(), kMagicSize);
+  encoding::PutU64(out, window_size_.count());
+  // How far into the current window the state was taken.
+  auto position = std::max(timestamp, cur_window_begin_) - cur_window_begin_;
+  encoding::PutI64(out, std::chrono::duration_cast<std::chrono::nanoseconds>(position).count());
+  encoding::PutBytes(out, current_.serialize());
+  encoding::PutBytes(out, previous_.serialize());
+  return out;
+}
+
+
+template <typename Sketch>
+void WindowedSketchSample<Sketch>::Impl::RestoreState(const std::string& state,
+                                                      Clock::duration idle,
+                                                      Clock::time_point timestamp) {
+  auto what = std::string(Traits::sample_name()) + " state";
+  encoding::Reader in {state, what.c_str()};
+  if (!in.Expect(Traits::magic(), kMagicSize)) {
+    throw IncompatibleState(std::string("not a saved ") + Traits::sample_name());
+  }
+  if (in.GetU64() != static_cast<std::uint64_t>(window_size_.count())) {
+    throw IncompatibleState("can only restore a sample with the same window size");
+  }
+  auto position = std::chrono::nanoseconds(in.GetI64());
+  auto saved_current = Sketch::deserialize(in.GetBytes());
+  auto saved_previous = Sketch::deserialize(in.GetBytes());
+  in.Finish();
+  if (position.count() < 0 || position >= window_size_) {
+    in.Malformed();
+  }
+  auto parameter = Traits::parameter(current_);
+  if (Traits::parameter(saved_current) != parameter ||
+      Traits::parameter(saved_previous) != parameter) {
+    throw IncompatibleState(std::string("can only restore a sample with the same ") +
+                            Traits::parameter_name());
+  }
+
+  // The saved windows are as many behind ours as window ends have passed.
+  auto passed = (position + std::max(idle, Clock::duration::zero())) / window_size_;
+  std::lock_guard<std::mutex> lock {mutex_};
+  AdvanceWindows(timestamp);
+  if (passed == 0) {
+    current_.merge(saved_current);
+    previous_.merge(saved_previous);
+  } else if (passed == 1) {
+    previous_.merge(saved_current);
+  }
+}
+
+
+template <typename Sketch>
+Snapshot WindowedSketchSample<Sketch>::Impl::MakeSnapshot(Clock::time_point timestamp,
+                                                          uint64_t divisor) {
+  std::lock_guard<std::mutex> lock {mutex_};
+  if (!AdvanceWindows(timestamp)) {
+    return {Sketch {Traits::parameter(current_)}, divisor};
+  }
+  return {previous_, divisor};
+}
+
+
+template <typename Sketch>
+bool WindowedSketchSample<Sketch>::Impl::AdvanceWindows(Clock::time_point timestamp) {
+  if (cur_window_begin_ <= timestamp && timestamp < cur_window_end_) {
+    return true;
+  }
+  if (timestamp < cur_window_begin_ && timestamp + window_size_ >= cur_window_begin_) {
+    return false;
+  }
+  auto begin = timestamp - timestamp.time_since_epoch() % window_size_;
+  if (begin == cur_window_end_) {
+    // The current window just ended: it becomes the previous one.
+    std::swap(previous_, current_);
+    current_.reset();
+  } else {
+    // Windows went by with no input, or time went backwards by a lot.
+    previous_.reset();
+    current_.reset();
+  }
+  cur_window_begin_ = begin;
+  cur_window_end_ = begin + window_size_;
+  return true;
+}
+
+template class WindowedSketchSample<DDSketch>;
+template class WindowedSketchSample<TDigest>;
+
+} // namespace stats
+} // namespace medida
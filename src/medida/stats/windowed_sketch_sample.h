@@ -0,0 +1,94 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef MEDIDA_WINDOWED_SKETCH_SAMPLE_H_
+#define MEDIDA_WINDOWED_SKETCH_SAMPLE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "medida/types.h"
+#include "medida/stats/ddsketch.h"
+#include "medida/stats/sample.h"
+#include "medida/stats/snapshot.h"
+#include "medida/stats/tdigest.h"
+
+namespace medida {
+namespace stats {
+
+// What WindowedSketchSample needs to know about a sketch type beyond its
+// insert, merge, reset and serialize: the one parameter two sketches must
+// share to be merged, and the name and four-byte magic its saved state
+// goes by.
+template <typename Sketch>
+struct SketchTraits;
+
+template <>
+struct SketchTraits<DDSketch> {
+  static double parameter(const DDSketch& sketch) { return sketch.relative_accuracy(); }
+  static const char* parameter_name() { return "relative accuracy"; }
+  static const char* sample_name() { return "DDSketchSample"; }
+  static const char* magic() { return "DDSW"; }
+};
+
+template <>
+struct SketchTraits<TDigest> {
+  static double parameter(const TDigest& digest) { return digest.compression(); }
+  static const char* parameter_name() { return "compression"; }
+  static const char* sample_name() { return "TDigestSample"; }
+  static const char* magic() { return "TDGW"; }
+};
+
+// WindowedSketchSample keeps a sketch per N-second window and, like
+// CKMSSample, adds new data to the current window and reports the previous
+// one. `parameter` is the relative accuracy of a DDSketch or the
+// compression of a t-digest, and defaults to the sketch's own default.
+//
+// The versions with a timestamp follow CKMSSample's rules: they are for
+// tests, and time must not go backwards across calls.
+template <typename Sketch>
+class WindowedSketchSample : public Sample {
+ public:
+  WindowedSketchSample(std::chrono::seconds window_size = std::chrono::seconds(30),
+                       double parameter = SketchTraits<Sketch>::parameter(Sketch()));
+  ~WindowedSketchSample();
+  virtual void Clear();
+  virtual std::uint64_t size() const;
+  virtual std::uint64_t size(Clock::time_point timestamp) const;
+  virtual void Update(std::int64_t value);
+  virtual void Update(std::int64_t value, Clock::time_point timestamp);
+  virtual Snapshot MakeSnapshot(uint64_t divisor = 1) const;
+  virtual Snapshot MakeSnapshot(Clock::time_point timestamp, uint64_t divisor = 1) const;
+  // Windows of samples with the same size line up, as for CKMSSample.
+  // Throws std::invalid_argument unless the other sample has the same
+  // window size and parameter.
+  virtual void Merge(const Sample& other);
+  // Saves both windows. Restoring moves them on by the windows that have
+  // passed since, so state older than the previous window is dropped.
+  // Throws IncompatibleState unless the state was saved by a sample with
+  // the same window size and parameter.
+  virtual std::string SaveState() const;
+  virtual std::string SaveState(Clock::time_point timestamp) const;
+  virtual void RestoreState(const std::string& state, Clock::duration idle);
+  virtual void RestoreState(const std::string& state, Clock::duration idle,
+                            Clock::time_point timestamp);
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+extern template class WindowedSketchSample<DDSketch>;
+extern template class WindowedSketchSample<TDigest>;
+
+// Quantiles within the relative accuracy of the true values.
+typedef WindowedSketchSample<DDSketch> DDSketchSample;
+// Higher compression buys accuracy with more centroids (see TDigest).
+typedef WindowedSketchSample<TDigest> TDigestSample;
+
+} // namespace stats
+} // namespace medida
+
+#endif // MEDIDA_WINDOWED_SKETCH_SAMPLE_H_
@@ -4,6 +4,9 @@
 
 #include "medida/timer.h"
 
+#include <stdexcept>
+
+#include "medida/encoding.h"
 #include "medida/histogram.h"
 #include "medida/meter.h"
 
@@ -11,11 +14,17 @@
 
 namespace medida {
 
+static const char kMagic[] = {'T', 'M', 'R', '1'};
+
 class Timer::Impl {
  public:
-  Impl(Timer& self, std::chrono::nanoseconds duration_unit = std::chrono::milliseconds(1),
-      std::chrono::nanoseconds rate_unit = std::chrono::seconds(1),
-      std::chrono::seconds ckms_window_size = std::chrono::seconds(30));
+  Impl(Timer& self, std::chrono::nanoseconds duration_unit,
+      std::chrono::nanoseconds rate_unit,
+      std::chrono::seconds ckms_window_size,
+      const std::vector<stats::CKMS::Quantile>& quantiles,
+      std::size_t ckms_windows,
+      bool ckms_background_compaction,
+      SamplingInterface::SampleType sample_type);
   ~Impl();
   void Process(MetricProcessor& processor);
   std::chrono::nanoseconds rate_unit() const;
@@ -26,6 +35,9 @@ class Timer::Impl {
   double one_minute_rate();
   double mean_rate();
   stats::Snapshot GetSnapshot() const;
+  stats::Snapshot GetSnapshot(std::chrono::seconds horizon) const;
+  std::vector<double> quantiles() const;
+  bool windowed() const;
   double max() const;
   double min() const;
   double mean() const;
@@ -34,6 +46,9 @@ class Timer::Impl {
   std::chrono::nanoseconds duration_unit() const;
   void Clear();
   void Update(std::chrono::nanoseconds duration);
+  void MergeFrom(const Impl& other);
+  std::string SaveState() const;
+  void RestoreState(const std::string& state, Clock::duration idle);
   TimerContext TimeScope();
   void Time(std::function<void()>);
  private:
@@ -48,8 +63,13 @@ class Timer::Impl {
 
 Timer::Timer(std::chrono::nanoseconds duration_unit,
              std::chrono::nanoseconds rate_unit,
-             std::chrono::seconds ckms_window_size)
-    : impl_ {new Timer::Impl {*this, duration_unit, rate_unit, ckms_window_size}} {
+             std::chrono::seconds ckms_window_size,
+             const std::vector<stats::CKMS::Quantile>& quantiles,
+             std::size_t ckms_windows,
+             bool ckms_background_compaction,
+             SampleType sample_type)
+    : impl_ {new Timer::Impl {*this, duration_unit, rate_unit, ckms_window_size, quantiles,
+                              ckms_windows, ckms_background_compaction, sample_type}} {
 }
 
 
@@ -129,20 +149,54 @@ void Timer::Process(MetricProcessor& processor) {
 
 
 void Timer::Clear() {
+  Touch();
   impl_->Clear();
 }
 
 
 void Timer::Update(std::chrono::nanoseconds duration) {
+  Touch();
   impl_->Update(duration);
 }
 
 
+void Timer::MergeFrom(const Timer& other) {
+  Touch();
+  impl_->MergeFrom(*other.impl_);
+}
+
+
+std::string Timer::SaveState() const {
+  return impl_->SaveState();
+}
+
+
+void Timer::RestoreState(const std::string& state, Clock::duration idle) {
+  Touch();
+  impl_->RestoreState(state, idle);
+}
+
+
 stats::Snapshot Timer::GetSnapshot() const {
   return impl_->GetSnapshot();
 }
 
 
+stats::Snapshot Timer::GetSnapshot(std::chrono::seconds horizon) const {
+  return impl_->GetSnapshot(horizon);
+}
+
+
+std::vector<double> Timer::quantiles() const {
+  return impl_->quantiles();
+}
+
+
+bool Timer::windowed() const {
+  return impl_->windowed();
+}
+
+
 TimerContext Timer::TimeScope() {
   return impl_->TimeScope();
 }
@@ -159,13 +213,18 @@ void Timer::Time(std::function<void()> func) {
 Timer::Impl::Impl(Timer& self,
                   std::chrono::nanoseconds duration_unit,
                   std::chrono::nanoseconds rate_unit,
-                  std::chrono::seconds ckms_window_size)
+                  std::chrono::seconds ckms_window_size,
+                  const std::vector<stats::CKMS::Quantile>& quantiles,
+                  std::size_t ckms_windows,
+                  bool ckms_background_compaction,
+                  SamplingInterface::SampleType sample_type)
     : self_ (self),
       duration_unit_       {duration_unit},
       duration_unit_nanos_ {duration_unit.count()},
       rate_unit_           {rate_unit},
       meter_               {"calls", rate_unit},
-      histogram_           {SamplingInterface::kCKMS, ckms_window_size} {
+      histogram_           {sample_type, ckms_window_size, quantiles, ckms_windows,
+                            ckms_background_compaction} {
 }
 
 
@@ -257,11 +316,53 @@ void Timer::Impl::Update(std::chrono::nanoseconds duration) {
 }
 
 
+void Timer::Impl::MergeFrom(const Impl& other) {
+  histogram_.MergeFrom(other.histogram_);
+  meter_.MergeFrom(other.meter_);
+}
+
+
+std::string Timer::Impl::SaveState() const {
+  std::string out(kMagic, sizeof(kMagic));
+  encoding::PutBytes(out, meter_.SaveState());
+  encoding::PutBytes(out, histogram_.SaveState());
+  return out;
+}
+
+
+void Timer::Impl::RestoreState(const std::string& state, Clock::duration idle) {
+  encoding::Reader in {state, "timer state"};
+  if (!in.Expect(kMagic, sizeof(kMagic))) {
+    throw std::invalid_argument("not a saved timer");
+  }
+  auto meter = in.GetBytes();
+  auto histogram = in.GetBytes();
+  in.Finish();
+  meter_.RestoreState(meter, idle);
+  histogram_.RestoreState(histogram, idle);
+}
+
+
+std::vector<double> Timer::Impl::quantiles() const {
+  return histogram_.quantiles();
+}
+
+
+bool Timer::Impl::windowed() const {
+  return histogram_.windowed();
+}
+
+
 stats::Snapshot Timer::Impl::GetSnapshot() const {
   return histogram_.GetSnapshot(duration_unit_nanos_);
 }
 
 
+stats::Snapshot Timer::Impl::GetSnapshot(std::chrono::seconds horizon) const {
+  return histogram_.GetSnapshot(horizon, duration_unit_nanos_);
+}
+
+
 void Timer::Impl::Time(std::function<void()> func) {
   auto t = self_.TimeScope();
   func();
@@ -9,21 +9,34 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "medida/disable.h"
 #include "medida/metered_interface.h"
 #include "medida/metric_interface.h"
 #include "medida/metric_processor.h"
 #include "medida/sampling_interface.h"
 #include "medida/summarizable_interface.h"
 #include "medida/timer_context.h"
+#include "medida/types.h"
+#include "medida/stats/ckms.h"
 
 namespace medida {
 
+#ifndef MEDIDA_DISABLE
+
 class Timer : public MetricInterface, MeteredInterface, SamplingInterface, SummarizableInterface {
  public:
+  // `quantiles`, `ckms_windows`, `ckms_background_compaction` and
+  // `sample_type` are as for Histogram.
   Timer(std::chrono::nanoseconds duration_unit = std::chrono::milliseconds(1),
       std::chrono::nanoseconds rate_unit = std::chrono::seconds(1),
-      std::chrono::seconds ckms_window_size = std::chrono::seconds(30));
+      std::chrono::seconds ckms_window_size = std::chrono::seconds(30),
+      const std::vector<stats::CKMS::Quantile>& quantiles = {},
+      std::size_t ckms_windows = 1,
+      bool ckms_background_compaction = false,
+      SampleType sample_type = kCKMS);
   ~Timer();
   void Process(MetricProcessor& processor);
   virtual std::chrono::nanoseconds rate_unit() const;
@@ -34,6 +47,10 @@ class Timer : public MetricInterface, MeteredInterface, SamplingInterface, Summa
   virtual double one_minute_rate();
   virtual double mean_rate();
   virtual stats::Snapshot GetSnapshot() const;
+  // Reports the completed windows covering the last `horizon`.
+  virtual stats::Snapshot GetSnapshot(std::chrono::seconds horizon) const;
+  virtual std::vector<double> quantiles() const;
+  virtual bool windowed() const;
   virtual double max() const;
   virtual double min() const;
   virtual double mean() const;
@@ -42,6 +59,12 @@ class Timer : public MetricInterface, MeteredInterface, SamplingInterface, Summa
   std::chrono::nanoseconds duration_unit() const;
   void Clear();
   void Update(std::chrono::nanoseconds duration);
+  // Folds in another timer's durations and call rates.
+  void MergeFrom(const Timer& other);
+  // For checkpoints: the states of the timer's meter and histogram (see
+  // Meter::SaveState and Histogram::SaveState).
+  std::string SaveState() const;
+  void RestoreState(const std::string& state, Clock::duration idle);
   TimerContext TimeScope();
   void Time(std::function<void()>);
  private:
@@ -49,6 +72,55 @@ class Timer : public MetricInterface, MeteredInterface, SamplingInterface, Summa
   std::unique_ptr<Impl> impl_;
 };
 
+#else
+
+MEDIDA_BEGIN_DISABLED
+
+class Timer : public MetricInterface, MeteredInterface, SamplingInterface, SummarizableInterface {
+ public:
+  Timer(std::chrono::nanoseconds duration_unit = std::chrono::milliseconds(1),
+      std::chrono::nanoseconds rate_unit = std::chrono::seconds(1),
+      std::chrono::seconds = std::chrono::seconds(30),
+      const std::vector<stats::CKMS::Quantile>& = {},
+      std::size_t = 1,
+      bool = false,
+      SampleType = kCKMS)
+      : duration_unit_ {duration_unit}, rate_unit_ {rate_unit} {}
+  void Process(MetricProcessor& processor) { processor.Process(*this); }
+  virtual std::chrono::nanoseconds rate_unit() const { return rate_unit_; }
+  virtual std::string event_type() const { return "calls"; }
+  virtual std::uint64_t count() const { return 0; }
+  virtual double fifteen_minute_rate() { return 0.0; }
+  virtual double five_minute_rate() { return 0.0; }
+  virtual double one_minute_rate() { return 0.0; }
+  virtual double mean_rate() { return 0.0; }
+  virtual stats::Snapshot GetSnapshot() const { return {std::vector<double>()}; }
+  virtual stats::Snapshot GetSnapshot(std::chrono::seconds) const { return {std::vector<double>()}; }
+  virtual std::vector<double> quantiles() const { return {}; }
+  virtual bool windowed() const { return false; }
+  virtual double max() const { return 0.0; }
+  virtual double min() const { return 0.0; }
+  virtual double mean() const { return 0.0; }
+  virtual double std_dev() const { return 0.0; }
+  virtual double sum() const { return 0.0; }
+  std::chrono::nanoseconds duration_unit() const { return duration_unit_; }
+  void Clear() {}
+  void Update(std::chrono::nanoseconds) {}
+  void MergeFrom(const Timer&) {}
+  std::string SaveState() const { return std::string(); }
+  void RestoreState(const std::string&, Clock::duration) {}
+  TimerContext TimeScope() { return {*this}; }
+  // The function still runs; only its timing is dropped.
+  void Time(std::function<void()> func) { func(); }
+ private:
+  std::chrono::nanoseconds const duration_unit_;
+  std::chrono::nanoseconds const rate_unit_;
+};
+
+MEDIDA_END_DISABLED
+
+#endif // MEDIDA_DISABLE
+
 } // namespace medida
 
 #endif // MEDIDA_TIMER_H_
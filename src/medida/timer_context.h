@@ -8,9 +8,15 @@
 #include <chrono>
 #include <memory>
 
+#include "medida/disable.h"
+
 namespace medida {
 
+MEDIDA_BEGIN_DISABLED
 class Timer;
+MEDIDA_END_DISABLED
+
+#ifndef MEDIDA_DISABLE
 
 class TimerContext {
  public:
@@ -27,6 +33,24 @@ class TimerContext {
   std::unique_ptr<Impl> impl_;
 };
 
+#else
+
+MEDIDA_BEGIN_DISABLED
+
+class TimerContext {
+ public:
+  TimerContext(Timer&) {}
+  TimerContext(TimerContext &&) {}
+  TimerContext(TimerContext const&) = delete;
+  TimerContext& operator=(TimerContext const&) = delete;
+  void Reset() {}
+  std::chrono::nanoseconds Stop() { return std::chrono::nanoseconds::zero(); }
+};
+
+MEDIDA_END_DISABLED
+
+#endif // MEDIDA_DISABLE
+
 } // namespace medida
 
 #endif // MEDIDA_TIMER_CONTEXT_H_
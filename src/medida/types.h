@@ -6,12 +6,36 @@
 #define MEDIDA_TYPES_H_
 
 #include <chrono>
+#include <time.h>
 
 namespace medida {
 
   using Clock = std::chrono::steady_clock;
   using SystemClock = std::chrono::system_clock;
 
+  // Clock as of the last kernel tick. It is a few milliseconds coarse but
+  // several times cheaper to read, which suits code that only needs to know
+  // which period it is in. Its time points are Clock's, so the two can be
+  // compared; where there is no coarse clock it is simply Clock.
+  struct CoarseClock {
+    using duration = Clock::duration;
+    using rep = Clock::rep;
+    using period = Clock::period;
+    using time_point = Clock::time_point;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+      timespec ts;
+      clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+      return time_point(std::chrono::duration_cast<duration>(
+          std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+#else
+      return Clock::now();
+#endif
+    }
+  };
+
 } // namespace medida
 
 #endif // MEDIDA_TYPES_H_
@@ -20,6 +20,7 @@ TEST(CollectdReporterTest, foo) {
   auto& histogram = registry.NewHistogram({"test", "console_reporter", "myhistogram"});
   auto& meter = registry.NewMeter({"test", "console_reporter", "mymeter"}, "cycles");
   auto& timer = registry.NewTimer({"test", "console_reporter", "mytimer"});
+  registry.NewGauge({"test", "console_reporter", "mygauge"}, [] { return 42.0; });
   CollectdReporter reporter {registry, "localhost", 25826};
   for (auto i = 1; i <= 100; i++) {
     auto t = timer.TimeScope();
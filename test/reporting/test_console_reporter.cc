@@ -4,6 +4,7 @@
 
 #include "medida/reporting/console_reporter.h"
 
+#include <sstream>
 #include <thread>
 
 #include <gtest/gtest.h>
@@ -20,6 +21,7 @@ TEST(ConsoleReporterTest, foo) {
   auto& histogram = registry.NewHistogram({"test", "console_reporter", "histogram"});
   auto& meter = registry.NewMeter({"test", "console_reporter", "meter"}, "cycles");
   auto& timer = registry.NewTimer({"test", "console_reporter", "timer"});
+  registry.NewGauge({"test", "console_reporter", "gauge"}, [] { return 42.0; });
   ConsoleReporter reporter {registry};
   counter.inc();
   for (auto i = 1; i <= 1000; i++) {
@@ -33,3 +35,17 @@ TEST(ConsoleReporterTest, foo) {
 }
 
 
+TEST(ConsoleReporterTest, changedOnly) {
+  MetricsRegistry registry;
+  auto& busy = registry.NewCounter({"test", "console_reporter", "busy"});
+  registry.NewCounter({"test", "console_reporter", "idle"});
+  std::ostringstream out;
+  ConsoleReporter reporter {registry, out, Temporality::kChangedOnly};
+  reporter.Run();
+  EXPECT_NE(std::string::npos, out.str().find("test.console_reporter.idle:"));
+
+  out.str("");
+  busy.inc(4);
+  reporter.Run();
+  EXPECT_EQ("test.console_reporter.busy:\n  count = 4\n\n", out.str());
+}
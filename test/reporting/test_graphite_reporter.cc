@@ -0,0 +1,196 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/graphite_reporter.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "medida/metrics_registry.h"
+
+using namespace medida;
+using namespace medida::reporting;
+
+namespace {
+
+// A TCP listener on loopback, standing in for carbon.
+class Server {
+ public:
+  // Listens on `port`, or on any free port for 0.
+  explicit Server(std::uint16_t port = 0)
+      : connection_ {-1} {
+    listener_ = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    bind(listener_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    listen(listener_, 4);
+    socklen_t size = sizeof(addr);
+    getsockname(listener_, reinterpret_cast<sockaddr*>(&addr), &size);
+    port_ = ntohs(addr.sin_port);
+  }
+
+  ~Server() {
+    Hangup();
+    close(listener_);
+  }
+
+  std::uint16_t port() const {
+    return port_;
+  }
+
+  // Takes the next connection, if one comes within a second.
+  bool Accept() {
+    Hangup();
+    pollfd p {listener_, POLLIN, 0};
+    if (poll(&p, 1, 1000) != 1) {
+      return false;
+    }
+    connection_ = accept(listener_, nullptr, nullptr);
+    return connection_ != -1;
+  }
+
+  void Hangup() {
+    if (connection_ != -1) {
+      close(connection_);
+      connection_ = -1;
+    }
+  }
+
+  // "<path> <value>" for every line read before a short silence, in order.
+  std::vector<std::string> Read() {
+    std::string data;
+    char buffer[65536];
+    pollfd p {connection_, POLLIN, 0};
+    while (poll(&p, 1, 200) == 1) {
+      auto n = recv(connection_, buffer, sizeof(buffer), 0);
+      if (n <= 0) {
+        break;
+      }
+      data.append(buffer, n);
+    }
+    std::vector<std::string> lines;
+    std::istringstream in {data};
+    std::string path, value, timestamp;
+    while (in >> path >> value >> timestamp) {
+      lines.push_back(path + " " + value);
+    }
+    return lines;
+  }
+
+ private:
+  int listener_;
+  int connection_;
+  std::uint16_t port_;
+};
+
+bool Contains(const std::vector<std::string>& lines, const std::string& line) {
+  return std::find(lines.begin(), lines.end(), line) != lines.end();
+}
+
+} // namespace
+
+
+TEST(GraphiteReporterTest, writesPlaintextLines) {
+  Server server;
+  MetricsRegistry registry;
+  registry.NewCounter({"test", "graphite", "counter"}).inc(7);
+  registry.NewGauge({"test", "graphite", "gauge"}, [] { return 1.5; });
+  registry.NewMeter({"test", "graphite", "meter", "with space"}, "things").Mark(3);
+  auto& timer = registry.NewTimer({"test", "graphite", "timer"});
+  for (auto i = 1; i <= 4; i++) {
+    timer.Update(std::chrono::milliseconds(i));
+  }
+  GraphiteReporter reporter {registry, "127.0.0.1", server.port(), "prefix"};
+  reporter.Run();
+  EXPECT_TRUE(reporter.connected());
+  ASSERT_TRUE(server.Accept());
+  auto lines = server.Read();
+  EXPECT_TRUE(Contains(lines, "prefix.test.graphite.counter.count 7"));
+  EXPECT_TRUE(Contains(lines, "prefix.test.graphite.gauge.value 1.5"));
+  EXPECT_TRUE(Contains(lines, "prefix.test.graphite.meter.with_space.count 3"));
+  EXPECT_TRUE(Contains(lines, "prefix.test.graphite.timer.count 4"));
+  EXPECT_TRUE(Contains(lines, "prefix.test.graphite.timer.sum 10"));
+  std::vector<std::string> paths;
+  for (auto& line : lines) {
+    paths.push_back(line.substr(0, line.find(' ')));
+  }
+  EXPECT_TRUE(Contains(paths, "prefix.test.graphite.meter.with_space.m15_rate"));
+  EXPECT_TRUE(Contains(paths, "prefix.test.graphite.timer.p99_9"));
+
+  // The connection is kept for the next run.
+  reporter.Run();
+  EXPECT_TRUE(Contains(server.Read(), "prefix.test.graphite.counter.count 7"));
+}
+
+
+TEST(GraphiteReporterTest, reconnectsAndSendsTheLastPeriod) {
+  std::uint16_t port;
+  {
+    // Find a free port, then leave it with nobody listening.
+    Server closed;
+    port = closed.port();
+  }
+  MetricsRegistry registry;
+  auto& counter = registry.NewCounter({"test", "graphite", "counter"});
+  GraphiteReporter reporter {registry, "127.0.0.1", port, "", Clock::duration::zero()};
+  counter.inc();
+  reporter.Run();
+  EXPECT_FALSE(reporter.connected());
+  counter.inc();
+  reporter.Run();
+  EXPECT_FALSE(reporter.connected());
+
+  // Only the last failed period is kept, and it goes out before the
+  // current one.
+  Server server {port};
+  counter.inc();
+  reporter.Run();
+  EXPECT_TRUE(reporter.connected());
+  ASSERT_TRUE(server.Accept());
+  auto expected = std::vector<std::string> {
+    "test.graphite.counter.count 2",
+    "test.graphite.counter.count 3",
+  };
+  EXPECT_EQ(expected, server.Read());
+
+  // Once the server hangs up, the next run notices and connects again.
+  server.Hangup();
+  counter.inc();
+  reporter.Run();
+  EXPECT_TRUE(reporter.connected());
+  ASSERT_TRUE(server.Accept());
+  EXPECT_EQ(std::vector<std::string> {"test.graphite.counter.count 4"}, server.Read());
+}
+
+
+TEST(GraphiteReporterTest, backsOffAfterAFailure) {
+  std::uint16_t port;
+  {
+    Server closed;
+    port = closed.port();
+  }
+  MetricsRegistry registry;
+  registry.NewCounter({"test", "graphite", "counter"});
+  GraphiteReporter reporter {registry, "127.0.0.1", port};
+  reporter.Run();
+  EXPECT_FALSE(reporter.connected());
+  // The next attempt is a second off.
+  Server server {port};
+  reporter.Run();
+  EXPECT_FALSE(reporter.connected());
+}
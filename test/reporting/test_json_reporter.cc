@@ -32,3 +32,65 @@ TEST(JsonReporterTest, foo) {
 }
 
 
+
+
+TEST(JsonReporterTest, gauge) {
+  MetricsRegistry registry;
+  double depth = 7;
+  registry.NewGauge({"test", "json_reporter", "callback"}, [&depth] { return depth; });
+  registry.NewGauge({"test", "json_reporter", "settable"}).set_value(2.5);
+  JsonReporter reporter {registry};
+  depth = 9;
+  auto json = reporter.Report();
+  EXPECT_NE(std::string::npos, json.find(
+      "\"test.json_reporter.callback\":{\n\"type\":\"gauge\",\n\"value\":9\n}"));
+  EXPECT_NE(std::string::npos, json.find(
+      "\"test.json_reporter.settable\":{\n\"type\":\"gauge\",\n\"value\":2.5\n}"));
+}
+
+
+TEST(JsonReporterTest, nonFiniteGaugesAreNull) {
+  MetricsRegistry registry;
+  double zero = 0;
+  registry.NewGauge({"test", "json_reporter", "nan"}, [&zero] { return zero / zero; });
+  registry.NewGauge({"test", "json_reporter", "inf"}, [&zero] { return 1 / zero; });
+  JsonReporter reporter {registry};
+  auto json = reporter.Report();
+  EXPECT_NE(std::string::npos, json.find(
+      "\"test.json_reporter.nan\":{\n\"type\":\"gauge\",\n\"value\":null\n}"));
+  EXPECT_NE(std::string::npos, json.find(
+      "\"test.json_reporter.inf\":{\n\"type\":\"gauge\",\n\"value\":null\n}"));
+}
+
+
+TEST(JsonReporterTest, configuredQuantiles) {
+  MetricsRegistry registry;
+  auto& histogram = registry.NewHistogram({"test", "json_reporter", "histogram"},
+                                          SamplingInterface::kUniform,
+                                          {{0.9, 0.01}, {0.9999, 0.0001}});
+  for (auto i = 1; i <= 100; i++) {
+    histogram.Update(i);
+  }
+  JsonReporter reporter {registry};
+  auto json = reporter.Report();
+  EXPECT_NE(std::string::npos, json.find(
+      "\"sum\":5050,\n\"90%\":90.1,\n\"99.99%\":99.9901,\n\"100%\":100\n}"));
+  EXPECT_EQ(std::string::npos, json.find("median"));
+}
+
+
+TEST(JsonReporterTest, deltaTemporality) {
+  MetricsRegistry registry;
+  auto& busy = registry.NewCounter({"test", "json_reporter", "busy"});
+  registry.NewCounter({"test", "json_reporter", "idle"}).inc(2);
+  JsonReporter reporter {registry, Temporality::kDelta};
+  busy.inc(5);
+  auto json = reporter.Report();
+  EXPECT_NE(std::string::npos, json.find("\"test.json_reporter.busy\":{\n\"type\":\"counter\",\n\"count\":5\n}"));
+  EXPECT_NE(std::string::npos, json.find("\"test.json_reporter.idle\""));
+
+  busy.inc(3);
+  json = reporter.Report();
+  EXPECT_NE(std::string::npos, json.find("\"test.json_reporter.busy\":{\n\"type\":\"counter\",\n\"count\":3\n}"));
+  EXPECT_EQ(std::string::npos, json.find("\"test.json_reporter.idle\""));
+}
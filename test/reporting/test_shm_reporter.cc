@@ -0,0 +1,148 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/shm_reporter.h"
+
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "medida/metrics_registry.h"
+#include "medida/reporting/shm_reader.h"
+
+using namespace medida;
+using namespace medida::reporting;
+
+namespace {
+
+// A path of its own for each test, in /dev/shm where there is one.
+std::string SegmentPath(const std::string& test) {
+  std::string dir = access("/dev/shm", W_OK) == 0 ? "/dev/shm" : "/tmp";
+  return dir + "/medida-test-" + test + "-" + std::to_string(getpid());
+}
+
+std::map<std::string, ShmReader::Metric> ByName(const std::vector<ShmReader::Metric>& metrics) {
+  std::map<std::string, ShmReader::Metric> by_name;
+  for (auto& m : metrics) {
+    by_name.emplace(m.name, m);
+  }
+  return by_name;
+}
+
+} // namespace
+
+
+TEST(ShmReporterTest, publishesSummaries) {
+  auto path = SegmentPath("summaries");
+  MetricsRegistry registry;
+  auto& counter = registry.NewCounter({"test", "shm", "counter"});
+  auto& meter = registry.NewMeter({"test", "shm", "meter"}, "things");
+  auto& histogram = registry.NewHistogram({"test", "shm", "histogram"}, SamplingInterface::kUniform);
+  auto& timer = registry.NewTimer({"test", "shm", "timer"});
+  registry.NewGauge({"test", "shm", "gauge"}, [] { return 42.0; });
+  counter.inc(7);
+  meter.Mark(3);
+  for (auto i = 1; i <= 100; i++) {
+    histogram.Update(i);
+  }
+  timer.Update(std::chrono::milliseconds(5));
+
+  ShmReporter reporter {registry, path};
+  ShmReader reader {path};
+  EXPECT_TRUE(reader.Read().empty());
+  reporter.Run();
+  EXPECT_EQ(static_cast<std::uint64_t>(getpid()), reader.pid());
+  EXPECT_EQ(0u, reader.dropped());
+  EXPECT_FALSE(reader.superseded());
+
+  auto metrics = ByName(reader.Read());
+  ASSERT_EQ(5u, metrics.size());
+  auto& c = metrics.at("test.shm.counter");
+  EXPECT_EQ(shm::kCounter, c.type);
+  EXPECT_EQ(std::vector<double> {7}, c.values);
+  EXPECT_EQ(std::vector<double> {42}, metrics.at("test.shm.gauge").values);
+
+  auto& m = metrics.at("test.shm.meter");
+  EXPECT_EQ(shm::kMeter, m.type);
+  EXPECT_EQ(std::chrono::seconds(1), m.rate_unit);
+  ASSERT_EQ(ShmReader::FieldNames(shm::kMeter).size(), m.values.size());
+  EXPECT_EQ(3, m.values[0]);
+
+  auto& h = metrics.at("test.shm.histogram");
+  ASSERT_EQ(12u, h.values.size());
+  EXPECT_EQ(100, h.values[0]);
+  EXPECT_EQ(1, h.values[1]);
+  EXPECT_EQ(100, h.values[2]);
+  EXPECT_EQ(5050, h.values[5]);
+  EXPECT_NEAR(50.5, h.values[6], 0.01);
+
+  auto& t = metrics.at("test.shm.timer");
+  EXPECT_EQ(shm::kTimer, t.type);
+  EXPECT_EQ(std::chrono::milliseconds(1), t.duration_unit);
+  ASSERT_EQ(16u, t.values.size());
+  EXPECT_EQ(1, t.values[0]);
+  // A CKMS timer's max, like its quantiles, covers its completed windows,
+  // and none has completed yet.
+  EXPECT_EQ(0, t.values[6]);
+
+  // Later passes update the same entries in place.
+  counter.inc();
+  reporter.Run();
+  EXPECT_EQ(8, ByName(reader.Read()).at("test.shm.counter").values[0]);
+}
+
+
+TEST(ShmReporterTest, removedMetricsAndFullSegments) {
+  auto path = SegmentPath("removed");
+  MetricsRegistry registry;
+  registry.NewCounter({"test", "shm", "a"});
+  registry.NewCounter({"test", "shm", "b"});
+  registry.NewCounter({"test", "shm", "c"});
+  ShmReporter reporter {registry, path, 2};
+  reporter.Run();
+  {
+    ShmReader reader {path};
+    EXPECT_EQ(2u, reader.Read().size());
+    EXPECT_EQ(1u, reader.dropped());
+  }
+
+  // "a" is marked removed, and its entry is reclaimed by starting a new
+  // segment on the pass after.
+  registry.Remove({"test", "shm", "a"});
+  reporter.Run();
+  ShmReader old_reader {path};
+  auto metrics = old_reader.Read();
+  ASSERT_EQ(1u, metrics.size());
+  EXPECT_EQ("test.shm.b", metrics[0].name);
+
+  reporter.Run();
+  EXPECT_TRUE(old_reader.superseded());
+  ShmReader reader {path};
+  EXPECT_FALSE(reader.superseded());
+  EXPECT_EQ(0u, reader.dropped());
+  auto names = ByName(reader.Read());
+  EXPECT_EQ(1u, names.count("test.shm.b"));
+  EXPECT_EQ(1u, names.count("test.shm.c"));
+}
+
+
+TEST(ShmReporterTest, theFileGoesWithTheReporter) {
+  auto path = SegmentPath("lifetime");
+  MetricsRegistry registry;
+  {
+    ShmReporter reporter {registry, path};
+    EXPECT_EQ(0, access(path.c_str(), F_OK));
+  }
+  EXPECT_NE(0, access(path.c_str(), F_OK));
+  EXPECT_THROW(ShmReader {path}, std::runtime_error);
+
+  std::ofstream {path} << "not a segment of any kind, but long enough to have a header";
+  EXPECT_THROW(ShmReader {path}, std::invalid_argument);
+  unlink(path.c_str());
+}
@@ -0,0 +1,213 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/statsd_reporter.h"
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "medida/metrics_registry.h"
+
+using namespace medida;
+using namespace medida::reporting;
+
+namespace {
+
+// A UDP socket on a free loopback port, standing in for the agent.
+class Agent {
+ public:
+  Agent() {
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t size = sizeof(addr);
+    getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &size);
+    port_ = ntohs(addr.sin_port);
+    timeval timeout {0, 200000};
+    setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  }
+
+  ~Agent() {
+    close(socket_);
+  }
+
+  std::uint16_t port() const {
+    return port_;
+  }
+
+  // Every datagram that arrives before a short silence.
+  std::vector<std::string> Datagrams() {
+    std::vector<std::string> datagrams;
+    char buffer[65536];
+    ssize_t size;
+    while ((size = recv(socket_, buffer, sizeof(buffer), 0)) >= 0) {
+      datagrams.emplace_back(buffer, size);
+    }
+    return datagrams;
+  }
+
+  std::vector<std::string> Lines() {
+    std::vector<std::string> lines;
+    for (auto& datagram : Datagrams()) {
+      std::istringstream in {datagram};
+      std::string line;
+      while (std::getline(in, line)) {
+        lines.push_back(line);
+      }
+    }
+    return lines;
+  }
+
+ private:
+  int socket_;
+  std::uint16_t port_;
+};
+
+bool Contains(const std::vector<std::string>& lines, const std::string& line) {
+  for (auto& l : lines) {
+    if (l == line) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+
+TEST(StatsdReporterTest, sendsCountsAsDeltas) {
+  Agent agent;
+  MetricsRegistry registry;
+  auto& counter = registry.NewCounter({"test", "statsd", "counter"});
+  auto& meter = registry.NewMeter({"test", "statsd", "meter"}, "things");
+  auto& quiet = registry.NewCounter({"test", "statsd", "quiet"});
+  registry.NewGauge({"test", "statsd", "gauge"}, [] { return -2.5; });
+  StatsdReporter reporter {registry, "127.0.0.1", agent.port()};
+
+  counter.inc(7);
+  meter.Mark(3);
+  reporter.Run();
+  auto lines = agent.Lines();
+  EXPECT_TRUE(Contains(lines, "test.statsd.counter:7|c"));
+  EXPECT_TRUE(Contains(lines, "test.statsd.meter.count:3|c"));
+  EXPECT_FALSE(Contains(lines, "test.statsd.quiet:0|c"));
+  // A negative gauge is reset to zero first, lest it be read as a change.
+  EXPECT_TRUE(Contains(lines, "test.statsd.gauge:0|g"));
+  EXPECT_TRUE(Contains(lines, "test.statsd.gauge:-2.5|g"));
+  auto rates = 0;
+  for (auto& line : lines) {
+    if (line.find("test.statsd.meter.") == 0 && line.find("_rate:") != std::string::npos) {
+      EXPECT_EQ("|g", line.substr(line.size() - 2));
+      rates++;
+    }
+  }
+  EXPECT_EQ(4, rates);
+
+  counter.inc(2);
+  quiet.dec();
+  reporter.Run();
+  lines = agent.Lines();
+  EXPECT_TRUE(Contains(lines, "test.statsd.counter:2|c"));
+  EXPECT_TRUE(Contains(lines, "test.statsd.quiet:-1|c"));
+  EXPECT_FALSE(Contains(lines, "test.statsd.meter.count:3|c"));
+}
+
+
+TEST(StatsdReporterTest, summarizesTimers) {
+  Agent agent;
+  MetricsRegistry registry;
+  auto& timer = registry.NewTimer({"test", "statsd", "timer"});
+  for (auto i = 1; i <= 4; i++) {
+    timer.Update(std::chrono::milliseconds(i));
+  }
+  StatsdReporter reporter {registry, "127.0.0.1", agent.port()};
+  reporter.Run();
+  auto lines = agent.Lines();
+  EXPECT_TRUE(Contains(lines, "test.statsd.timer.count:4|c"));
+  // A CKMS timer's min and max, like its quantiles, cover its completed
+  // windows, and none has completed yet.
+  EXPECT_TRUE(Contains(lines, "test.statsd.timer.min:0|g"));
+  EXPECT_TRUE(Contains(lines, "test.statsd.timer.max:0|g"));
+  EXPECT_TRUE(Contains(lines, "test.statsd.timer.sum:10|g"));
+  std::set<std::string> names;
+  for (auto& line : lines) {
+    names.insert(line.substr(0, line.find(':')));
+  }
+  EXPECT_EQ(1u, names.count("test.statsd.timer.p99"));
+  EXPECT_EQ(1u, names.count("test.statsd.timer.p99_9"));
+  EXPECT_EQ(1u, names.count("test.statsd.timer.m15_rate"));
+}
+
+
+TEST(StatsdReporterTest, summarizesReservoirsOverTheirLifetime) {
+  Agent agent;
+  MetricsRegistry registry;
+  auto& histogram = registry.NewHistogram({"test", "statsd", "sliding"},
+                                          SamplingInterface::kSliding);
+  for (auto i = 1; i <= 2000; i++) {
+    histogram.Update(i);
+  }
+  StatsdReporter reporter {registry, "127.0.0.1", agent.port()};
+  reporter.Run();
+  auto lines = agent.Lines();
+  // The sliding window holds only the last 1028 values; the min and max
+  // still cover them all.
+  EXPECT_TRUE(Contains(lines, "test.statsd.sliding.min:1|g"));
+  EXPECT_TRUE(Contains(lines, "test.statsd.sliding.max:2000|g"));
+  EXPECT_TRUE(Contains(lines, "test.statsd.sliding.mean:1000.5|g"));
+}
+
+
+TEST(StatsdReporterTest, tagsScope) {
+  Agent agent;
+  MetricsRegistry registry;
+  registry.NewCounter({"test", "statsd", "peers", "peer:1"}).inc();
+  registry.NewCounter({"test", "statsd", "unscoped"}).inc();
+  StatsdReporter reporter {registry, "127.0.0.1", agent.port(), 1432, true};
+  reporter.Run();
+  auto lines = agent.Lines();
+  EXPECT_TRUE(Contains(lines, "test.statsd.peers:1|c|#scope:peer_1"));
+  EXPECT_TRUE(Contains(lines, "test.statsd.unscoped:1|c"));
+}
+
+
+TEST(StatsdReporterTest, packsDatagramsUpToTheLimit) {
+  Agent agent;
+  MetricsRegistry registry;
+  const std::size_t limit = 200;
+  const int counters = 100;
+  for (auto i = 0; i < counters; i++) {
+    registry.NewCounter({"test", "statsd", "counter" + std::to_string(i)}).inc(i + 1);
+  }
+  StatsdReporter reporter {registry, "127.0.0.1", agent.port(), limit};
+  reporter.Run();
+  auto datagrams = agent.Datagrams();
+  ASSERT_FALSE(datagrams.empty());
+  std::size_t lines = 0;
+  for (std::size_t i = 0; i < datagrams.size(); i++) {
+    auto& datagram = datagrams[i];
+    EXPECT_LE(datagram.size(), limit);
+    EXPECT_NE('\n', datagram.back());
+    // No line is 30 bytes long, so every datagram but the last is filled
+    // closer to the limit than that.
+    if (i + 1 < datagrams.size()) {
+      EXPECT_GT(datagram.size(), limit - 30);
+    }
+    lines += std::count(datagram.begin(), datagram.end(), '\n') + 1;
+  }
+  EXPECT_EQ(static_cast<std::size_t>(counters), lines);
+}
@@ -0,0 +1,110 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/reporting/temporality.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "medida/metrics_registry.h"
+
+using namespace medida;
+using namespace medida::reporting;
+
+
+TEST(ChangeTrackerTest, cumulativeReportsEverything) {
+  Counter counter;
+  MetricName name {"test", "tracker", "counter"};
+  ChangeTracker tracker;
+  for (auto i = 0; i < 2; i++) {
+    tracker.Begin();
+    EXPECT_TRUE(tracker.Visit(name, counter));
+    EXPECT_EQ(0, tracker.Count(counter.count()));
+    tracker.End();
+  }
+}
+
+
+TEST(ChangeTrackerTest, changedOnlySkipsIdleMetrics) {
+  Counter busy, idle, cleared {5};
+  Gauge settable {1.0};
+  Gauge callback {[] { return 2.0; }};
+  MetricName a {"test", "tracker", "a"}, b {"test", "tracker", "b"}, c {"test", "tracker", "c"},
+      d {"test", "tracker", "d"}, e {"test", "tracker", "e"};
+  ChangeTracker tracker {Temporality::kChangedOnly};
+  auto report = [&] {
+    std::vector<bool> visits;
+    tracker.Begin();
+    visits.push_back(tracker.Visit(a, busy));
+    visits.push_back(tracker.Visit(b, idle));
+    visits.push_back(tracker.Visit(c, cleared));
+    visits.push_back(tracker.Visit(d, settable));
+    visits.push_back(tracker.Visit(e, callback));
+    // A reporter reads what it visits.
+    if (visits.back()) {
+      callback.value();
+    }
+    tracker.End();
+    return visits;
+  };
+
+  // Everything is in the first report, and after that only what has been
+  // updated, along with callback gauges.
+  busy.inc();
+  EXPECT_EQ(std::vector<bool>({true, true, true, true, true}), report());
+  idle.inc();
+  EXPECT_EQ(std::vector<bool>({false, true, false, false, true}), report());
+  EXPECT_EQ(std::vector<bool>({false, false, false, false, true}), report());
+
+  busy.inc();
+  cleared.clear();
+  settable.set_value(3.0);
+  EXPECT_EQ(std::vector<bool>({true, false, true, true, true}), report());
+  // Counts stay cumulative.
+  tracker.Begin();
+  tracker.Visit(a, busy);
+  EXPECT_EQ(2, tracker.Count(busy.count()));
+  tracker.End();
+}
+
+
+TEST(ChangeTrackerTest, deltaCountsSinceTheLastReport) {
+  Counter first, second;
+  Histogram histogram;
+  MetricName a {"test", "tracker", "a"}, b {"test", "tracker", "b"}, h {"test", "tracker", "h"};
+  ChangeTracker tracker {Temporality::kDelta};
+
+  first.inc(3);
+  second.inc(4);
+  tracker.Begin();
+  ASSERT_TRUE(tracker.Visit(a, first));
+  EXPECT_EQ(3, tracker.Count(first.count()));
+  ASSERT_TRUE(tracker.Visit(b, second));
+  EXPECT_EQ(4, tracker.Count(second.count()));
+  tracker.End();
+
+  // Several parts keep a count each.
+  first.inc(2);
+  histogram.Update(1);
+  tracker.Begin();
+  ASSERT_TRUE(tracker.Visit(a, first));
+  EXPECT_EQ(2, tracker.Count(first.count()));
+  ASSERT_TRUE(tracker.Visit(h, histogram));
+  EXPECT_EQ(1, tracker.Count(histogram.count()));
+  EXPECT_EQ(10, tracker.Count(10));
+  tracker.End();
+
+  // `b` went unvisited, as a removed metric would, so a new one by that
+  // name starts over.
+  histogram.Update(2);
+  Counter recreated {6};
+  tracker.Begin();
+  ASSERT_TRUE(tracker.Visit(b, recreated));
+  EXPECT_EQ(6, tracker.Count(recreated.count()));
+  ASSERT_TRUE(tracker.Visit(h, histogram));
+  EXPECT_EQ(1, tracker.Count(histogram.count()));
+  EXPECT_EQ(5, tracker.Count(15));
+  tracker.End();
+}
@@ -1,7 +1,9 @@
 #include "medida/stats/ckms.h"
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <memory>
 #include <random>
+#include <stdexcept>
 
 using namespace medida::stats;
 
@@ -179,3 +181,95 @@ TEST(CKMSTest, aCKMSGamma) {
       EXPECT_GE(values[int((1 + error) * q * count)], ckms.get(q));
   }
 }
+
+TEST(CKMSTest, aCKMSMergeOfShards) {
+  // Two shards see alternating halves of 1..100000 in random order; the
+  // merged summary answers for the whole stream within its error targets.
+  std::vector<CKMS::Quantile> v({{0.5, 0.001}, {0.99, 0.001}});
+  const int size = 100000;
+  std::vector<int> values;
+  for (int i = 1; i <= size; i++) {
+      values.push_back(i);
+  }
+  std::mt19937 rng(7);
+  std::shuffle(values.begin(), values.end(), rng);
+  auto a = CKMS(v);
+  auto b = CKMS(v);
+  for (int i = 0; i < size; i++) {
+      (values[i] % 2 ? a : b).insert(values[i]);
+  }
+  a.merge(b);
+  EXPECT_EQ(std::size_t(size), a.count());
+  EXPECT_EQ(size, a.max());
+  EXPECT_NEAR(0.5 * size, a.get(0.5), 2 * 0.001 * size);
+  EXPECT_NEAR(0.99 * size, a.get(0.99), 2 * 0.001 * size);
+}
+
+TEST(CKMSTest, aCKMSMergeOfSmallSummariesIsExact) {
+  std::vector<CKMS::Quantile> v({{0.5, 0.001}, {0.99, 0.001}});
+  auto a = CKMS(v);
+  auto b = CKMS(v);
+  for (int i = 1; i <= 100; i++) {
+      (i % 2 ? a : b).insert(i);
+  }
+  a.merge(b);
+  a.merge(CKMS(v));
+  EXPECT_EQ(100u, a.count());
+  EXPECT_NEAR(50, a.get(0.5), 1e-6);
+  EXPECT_NEAR(99, a.get(0.99), 1e-6);
+  EXPECT_NEAR(100, a.max(), 1e-6);
+}
+
+TEST(CKMSTest, aCKMSKeepsExactMoments) {
+  std::vector<CKMS::Quantile> v({{0.5, 0.001}, {0.99, 0.001}});
+  auto a = CKMS(v);
+  auto b = CKMS(v);
+  auto whole = CKMS(v);
+  EXPECT_EQ(0, whole.min());
+  EXPECT_EQ(0, whole.variance());
+  // Enough that each shard compresses some and buffers the rest.
+  for (int i = 1; i <= 1234; i++) {
+      (i % 3 ? a : b).insert(i);
+      whole.insert(i);
+  }
+  EXPECT_EQ(1, whole.min());
+  EXPECT_EQ(1234, whole.max());
+  EXPECT_EQ(1234 * 1235 / 2, whole.sum());
+  EXPECT_NEAR(617.5, whole.mean(), 1e-9);
+  EXPECT_NEAR(1234 * 1235 / 12.0, whole.variance(), 1e-6);
+
+  a.merge(b);
+  EXPECT_EQ(whole.count(), a.count());
+  EXPECT_EQ(whole.min(), a.min());
+  EXPECT_EQ(whole.sum(), a.sum());
+  EXPECT_NEAR(whole.mean(), a.mean(), 1e-9);
+  EXPECT_NEAR(whole.variance(), a.variance(), 1e-6);
+
+  a.reset();
+  EXPECT_EQ(0, a.sum());
+  EXPECT_EQ(0, a.mean());
+}
+
+TEST(CKMSTest, aCKMSSerializeRoundTrips) {
+  std::vector<CKMS::Quantile> v({{0.5, 0.001}, {0.99, 0.001}});
+  auto ckms = CKMS(v);
+  // Enough for compressed items and some still buffered.
+  for (int i = 1; i <= 1234; i++) {
+      ckms.insert(i);
+  }
+  auto bytes = ckms.serialize();
+  auto copy = CKMS::deserialize(bytes, std::make_shared<const std::vector<CKMS::Quantile>>(v));
+  EXPECT_EQ(ckms.count(), copy.count());
+  EXPECT_EQ(ckms.max(), copy.max());
+  EXPECT_EQ(ckms.min(), copy.min());
+  EXPECT_EQ(ckms.sum(), copy.sum());
+  EXPECT_EQ(ckms.variance(), copy.variance());
+  EXPECT_EQ(bytes, copy.serialize());
+  EXPECT_EQ(ckms.get(0.5), copy.get(0.5));
+  EXPECT_EQ(ckms.get(0.99), copy.get(0.99));
+
+  EXPECT_EQ(0u, CKMS::deserialize(CKMS().serialize()).count());
+  EXPECT_THROW(CKMS::deserialize(""), std::invalid_argument);
+  EXPECT_THROW(CKMS::deserialize(bytes.substr(0, bytes.size() - 1)), std::invalid_argument);
+  EXPECT_THROW(CKMS::deserialize(bytes + "x"), std::invalid_argument);
+}
@@ -1,5 +1,11 @@
 #include "medida/stats/ckms_sample.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 using namespace medida::stats;
@@ -7,7 +13,7 @@ using namespace medida::stats;
 TEST(CKMSSampleTest, aSameValueEverySecond) {
   CKMSSample sample;
 
-  auto t = medida::SystemClock::now();
+  auto t = medida::Clock::now();
   for (auto i = 0; i < 300; i++) {
     t += std::chrono::seconds(1);
     sample.Update(100, t);
@@ -25,7 +31,7 @@ TEST(CKMSSampleTest, aSameValueEverySecond) {
 TEST(CKMSSampleTest, aThreeDifferentValues) {
   CKMSSample sample;
 
-  auto t = medida::SystemClock::now();
+  auto t = medida::Clock::now();
   for (auto i = 0; i < 300; i++) {
     t += std::chrono::seconds(1);
     sample.Update(i % 3, t);
@@ -150,3 +156,230 @@ TEST(CKMSSampleTest, aSpikyInputs) {
   EXPECT_NEAR(size, snapshot.getValue(1), size * error);
 }
 
+
+TEST(CKMSSampleTest, aSnapshotHasItsWindowsMoments) {
+  CKMSSample sample {std::chrono::seconds(30), {}, 2};
+  auto t = medida::Clock::time_point();
+
+  // [0, 30) holds 1..30, [30, 60) a single 1000, and [60, 90) holds 5.
+  for (auto i = 1; i <= 30; i++) {
+    sample.Update(i, t + std::chrono::seconds(i - 1));
+  }
+  sample.Update(1000, t + std::chrono::seconds(30));
+
+  auto first = sample.MakeSnapshot(t + std::chrono::seconds(30));
+  EXPECT_EQ(1, first.min());
+  EXPECT_EQ(30, first.max());
+  EXPECT_EQ(465, first.sum());
+  EXPECT_DOUBLE_EQ(15.5, first.mean());
+  EXPECT_NEAR(std::sqrt(77.5), first.std_dev(), 1e-9);
+
+  // The spike leaves with its window.
+  auto second = sample.MakeSnapshot(t + std::chrono::seconds(60));
+  EXPECT_EQ(1000, second.min());
+  EXPECT_EQ(1000, second.max());
+  EXPECT_EQ(0, second.std_dev());
+  sample.Update(5, t + std::chrono::seconds(60));
+  auto third = sample.MakeSnapshot(t + std::chrono::seconds(90));
+  EXPECT_EQ(5, third.min());
+  EXPECT_EQ(5, third.max());
+
+  // A horizon covers the moments of every window in it, scaled as the
+  // quantiles are.
+  auto both = sample.MakeSnapshot(std::chrono::seconds(60), t + std::chrono::seconds(90), 5);
+  EXPECT_EQ(1, both.min());
+  EXPECT_EQ(200, both.max());
+  EXPECT_EQ(201, both.sum());
+  EXPECT_DOUBLE_EQ(100.5, both.mean());
+}
+
+TEST(CKMSSampleTest, aMergeLinesUpWindows) {
+  CKMSSample a, b;
+  auto t = medida::Clock::time_point() + std::chrono::seconds(3000);
+  // b is a window ahead of a: a's current window is b's previous one.
+  for (auto i = 0; i < 10; i++) {
+    a.Update(1, t + std::chrono::seconds(i));
+    b.Update(2, t + std::chrono::seconds(i));
+  }
+  for (auto i = 0; i < 10; i++) {
+    b.Update(3, t + std::chrono::seconds(30 + i));
+  }
+  a.Merge(b);
+  auto snapshot = a.MakeSnapshot(t + std::chrono::seconds(40));
+  EXPECT_EQ(20, snapshot.size());
+  EXPECT_EQ(1, snapshot.getValue(0.5));
+  EXPECT_EQ(2, snapshot.getValue(1));
+  EXPECT_EQ(10, a.MakeSnapshot(t + std::chrono::seconds(60)).size());
+
+  CKMSSample c {std::chrono::seconds(10)};
+  EXPECT_THROW(a.Merge(c), std::invalid_argument);
+}
+
+TEST(CKMSSampleTest, aConfiguredTargetIsAccurate) {
+  // The defaults only promise the median and p99; a target on p99.9 holds
+  // it to within 0.01% of the rank.
+  CKMSSample sample {std::chrono::seconds(30), {{0.999, 0.0001}}};
+  std::vector<int> values;
+  for (int i = 1; i <= 100000; i++) {
+    values.push_back(i);
+  }
+  std::mt19937 rng(3);
+  std::shuffle(values.begin(), values.end(), rng);
+  auto t = medida::Clock::time_point() + std::chrono::seconds(3000);
+  for (auto v : values) {
+    sample.Update(v, t);
+  }
+  auto snapshot = sample.MakeSnapshot(t + std::chrono::seconds(30));
+  EXPECT_NEAR(99900, snapshot.getValue(0.999), 2 * 0.0001 * 100000);
+}
+
+TEST(CKMSSampleTest, aHorizonMergesCompletedWindows) {
+  // Keep four completed 10-second windows; window w holds ten copies of w.
+  CKMSSample sample {std::chrono::seconds(10), {}, 4};
+  auto t = medida::Clock::time_point() + std::chrono::seconds(3000);
+  for (auto w = 1; w <= 5; w++) {
+    for (auto i = 0; i < 10; i++) {
+      sample.Update(w, t + std::chrono::seconds(10 * (w - 1) + i));
+    }
+  }
+  // Window 5 is current, so window 4 is the most recent completed one.
+  auto now = t + std::chrono::seconds(45);
+  EXPECT_EQ(10, sample.MakeSnapshot(now).size());
+  EXPECT_EQ(4, sample.MakeSnapshot(now).getValue(1));
+
+  auto last30 = sample.MakeSnapshot(std::chrono::seconds(30), now);
+  EXPECT_EQ(30, last30.size());
+  EXPECT_EQ(2, last30.getValue(0.01));
+  EXPECT_EQ(4, last30.getValue(1));
+
+  // Partial windows round up, and the horizon is capped at what is kept.
+  EXPECT_EQ(30, sample.MakeSnapshot(std::chrono::seconds(25), now).size());
+  EXPECT_EQ(40, sample.MakeSnapshot(std::chrono::seconds(600), now).size());
+
+  // Once the windows rotate, the cached merge no longer applies.
+  now += std::chrono::seconds(10);
+  auto rotated = sample.MakeSnapshot(std::chrono::seconds(30), now);
+  EXPECT_EQ(30, rotated.size());
+  EXPECT_EQ(3, rotated.getValue(0.01));
+  EXPECT_EQ(5, rotated.getValue(1));
+
+  // A long gap empties every window.
+  now += std::chrono::seconds(100);
+  EXPECT_EQ(0, sample.MakeSnapshot(std::chrono::seconds(40), now).size());
+}
+
+TEST(CKMSSampleTest, aMergeFillsEveryKeptWindow) {
+  CKMSSample a {std::chrono::seconds(10), {}, 3};
+  CKMSSample b {std::chrono::seconds(10), {}, 3};
+  auto t = medida::Clock::time_point() + std::chrono::seconds(3000);
+  for (auto w = 0; w < 3; w++) {
+    a.Update(1, t + std::chrono::seconds(10 * w));
+    b.Update(2, t + std::chrono::seconds(10 * w));
+  }
+  EXPECT_EQ(2, a.MakeSnapshot(std::chrono::seconds(30), t + std::chrono::seconds(25)).size());
+  a.Merge(b);
+  auto snapshot = a.MakeSnapshot(std::chrono::seconds(30), t + std::chrono::seconds(25));
+  EXPECT_EQ(4, snapshot.size());
+  EXPECT_EQ(1, snapshot.getValue(0.01));
+  EXPECT_EQ(2, snapshot.getValue(1));
+}
+
+TEST(CKMSSampleTest, aCoarseClockTracksTheSteadyClock) {
+  auto before = medida::Clock::now();
+  auto coarse = medida::CoarseClock::now();
+  auto after = medida::Clock::now();
+  // The coarse clock lags by at most a kernel tick or so.
+  EXPECT_LE(coarse, after);
+  EXPECT_GE(coarse, before - std::chrono::milliseconds(50));
+
+  CKMSSample sample {std::chrono::seconds(1)};
+  sample.Update(7);
+  auto snapshot = sample.MakeSnapshot(medida::CoarseClock::now() + std::chrono::seconds(1));
+  EXPECT_EQ(1, snapshot.size());
+  EXPECT_EQ(7, snapshot.getValue(1));
+}
+
+TEST(CKMSSampleTest, aBackgroundCompactionMatchesInline) {
+  CKMSSample inline_sample {std::chrono::seconds(10), {}, 2};
+  CKMSSample background {std::chrono::seconds(10), {}, 2, true};
+  auto t = medida::Clock::time_point() + std::chrono::seconds(3000);
+  for (auto w = 0; w < 3; w++) {
+    for (auto i = 1; i <= 5000; i++) {
+      auto when = t + std::chrono::seconds(10 * w) + std::chrono::milliseconds(i);
+      inline_sample.Update(i, when);
+      background.Update(i, when);
+    }
+  }
+  auto now = t + std::chrono::seconds(25);
+  for (auto horizon : {std::chrono::seconds(10), std::chrono::seconds(20)}) {
+    auto expected = inline_sample.MakeSnapshot(horizon, now);
+    auto actual = background.MakeSnapshot(horizon, now);
+    EXPECT_EQ(expected.size(), actual.size());
+    EXPECT_NEAR(expected.getMedian(), actual.getMedian(), 5000 * 0.001);
+    EXPECT_NEAR(expected.get99thPercentile(), actual.get99thPercentile(), 5000 * 0.001);
+    EXPECT_EQ(5000, actual.max());
+  }
+}
+
+TEST(CKMSSampleTest, aBackgroundCompactionKeepsEveryUpdate) {
+  CKMSSample sample {std::chrono::seconds(10), {}, 1, true};
+  auto t = medida::Clock::time_point() + std::chrono::seconds(3000);
+  std::vector<std::thread> writers;
+  for (auto w = 0; w < 4; w++) {
+    writers.emplace_back([&sample, t] {
+      for (auto i = 1; i <= 25000; i++) {
+        sample.Update(i, t);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  EXPECT_EQ(100000, sample.size(t + std::chrono::seconds(10)));
+
+  // Samples can go away with batches still waiting for the compactor.
+  for (auto s = 0; s < 100; s++) {
+    CKMSSample shortLived {std::chrono::seconds(10), {}, 1, true};
+    for (auto i = 0; i < 1000; i++) {
+      shortLived.Update(i, t);
+    }
+  }
+}
+
+TEST(CKMSSampleTest, aRestoreLinesUpWindows) {
+  CKMSSample saved {std::chrono::seconds(30), {}, 2};
+  auto t = medida::Clock::time_point() + std::chrono::seconds(3000);
+  for (auto i = 0; i < 10; i++) {
+    saved.Update(1, t + std::chrono::seconds(i));
+  }
+  for (auto i = 0; i < 10; i++) {
+    saved.Update(2, t + std::chrono::seconds(30 + i));
+  }
+  // Saved 15 seconds into the window holding the 2s.
+  auto state = saved.SaveState(t + std::chrono::seconds(45));
+
+  // With no time lost, the windows line up as they were.
+  CKMSSample a {std::chrono::seconds(30), {}, 2};
+  a.RestoreState(state, std::chrono::seconds(0), t + std::chrono::seconds(45));
+  EXPECT_EQ(10u, a.size(t + std::chrono::seconds(45)));
+  EXPECT_EQ(20u, a.MakeSnapshot(std::chrono::seconds(60), t + std::chrono::seconds(60)).size());
+  EXPECT_EQ(2, a.MakeSnapshot(t + std::chrono::seconds(60)).getValue(1));
+
+  // Down for 20 seconds: the window holding the 2s has since completed,
+  // and the one before it is the oldest kept.
+  CKMSSample b {std::chrono::seconds(30), {}, 2};
+  auto now = t + std::chrono::seconds(3000);
+  b.RestoreState(state, std::chrono::seconds(20), now);
+  EXPECT_EQ(10u, b.size(now));
+  EXPECT_EQ(2, b.MakeSnapshot(now).getValue(0.5));
+  EXPECT_EQ(20u, b.MakeSnapshot(std::chrono::seconds(60), now).size());
+
+  // Down for longer than the windows kept.
+  CKMSSample c {std::chrono::seconds(30), {}, 2};
+  c.RestoreState(state, std::chrono::minutes(5), now);
+  EXPECT_EQ(0u, c.MakeSnapshot(std::chrono::seconds(60), now).size());
+
+  CKMSSample d {std::chrono::seconds(10)};
+  EXPECT_THROW(d.RestoreState(state, std::chrono::seconds(0)), std::invalid_argument);
+  EXPECT_THROW(d.RestoreState("CKMW", std::chrono::seconds(0)), std::invalid_argument);
+}
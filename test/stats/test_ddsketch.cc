@@ -0,0 +1,165 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/ddsketch.h"
+#include "medida/stats/snapshot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace medida::stats;
+
+namespace {
+
+double Exact(std::vector<double> values, double q) {
+  std::sort(values.begin(), values.end());
+  return values[static_cast<std::size_t>(q * (values.size() - 1))];
+}
+
+// Latencies spread over six orders of magnitude.
+std::vector<double> HeavyTailed(std::size_t n, unsigned seed) {
+  std::mt19937 rng {seed};
+  std::lognormal_distribution<double> dist {3.0, 2.5};
+  std::vector<double> values;
+  for (std::size_t i = 0; i < n; i++) {
+    values.push_back(std::min(1e7, 1 + dist(rng)));
+  }
+  return values;
+}
+
+} // namespace
+
+
+TEST(DDSketchTest, anEmptySketch) {
+  DDSketch sketch;
+  EXPECT_EQ(0u, sketch.count());
+  EXPECT_EQ(0.0, sketch.get(0.5));
+}
+
+
+TEST(DDSketchTest, quantilesAreWithinTheRelativeAccuracy) {
+  DDSketch sketch {0.01};
+  auto values = HeavyTailed(100000, 1);
+  for (auto v : values) {
+    sketch.insert(v);
+  }
+  EXPECT_EQ(values.size(), sketch.count());
+  for (auto q : {0.0, 0.1, 0.5, 0.9, 0.99, 0.999, 0.9999, 1.0}) {
+    auto exact = Exact(values, q);
+    EXPECT_NEAR(exact, sketch.get(q), exact * 0.01) << "q = " << q;
+  }
+  EXPECT_EQ(*std::max_element(values.begin(), values.end()), sketch.max());
+}
+
+
+TEST(DDSketchTest, negativeAndZeroValues) {
+  DDSketch sketch {0.01};
+  std::vector<double> values;
+  for (auto i = -500; i <= 500; i++) {
+    values.push_back(i * 10.0);
+    sketch.insert(i * 10.0);
+  }
+  for (auto q : {0.0, 0.25, 0.5, 0.75, 1.0}) {
+    auto exact = Exact(values, q);
+    EXPECT_NEAR(exact, sketch.get(q), std::abs(exact) * 0.01) << "q = " << q;
+  }
+  EXPECT_EQ(-5000, sketch.min());
+}
+
+
+TEST(DDSketchTest, aMergeMatchesOneSketchOfBoth) {
+  DDSketch a, b, both;
+  auto values = HeavyTailed(20000, 2);
+  for (std::size_t i = 0; i < values.size(); i++) {
+    (i % 3 ? a : b).insert(values[i]);
+    both.insert(values[i]);
+  }
+  a.merge(b);
+  EXPECT_EQ(both.count(), a.count());
+  EXPECT_EQ(both.max(), a.max());
+  for (auto q : {0.0, 0.5, 0.99, 0.999, 1.0}) {
+    EXPECT_EQ(both.get(q), a.get(q));
+  }
+
+  DDSketch coarse {0.05};
+  EXPECT_THROW(a.merge(coarse), std::invalid_argument);
+}
+
+
+TEST(DDSketchTest, keepsExactMoments) {
+  DDSketch a, b, whole;
+  EXPECT_EQ(0, whole.sum());
+  EXPECT_EQ(0, whole.mean());
+  EXPECT_EQ(0, whole.variance());
+  for (int i = 1; i <= 1234; i++) {
+      (i % 3 ? a : b).insert(i);
+      whole.insert(i);
+  }
+  EXPECT_EQ(1, whole.min());
+  EXPECT_EQ(1234 * 1235 / 2, whole.sum());
+  EXPECT_NEAR(617.5, whole.mean(), 1e-9);
+  EXPECT_NEAR(1234 * 1235 / 12.0, whole.variance(), 1e-6);
+
+  a.merge(b);
+  EXPECT_EQ(whole.min(), a.min());
+  EXPECT_EQ(whole.sum(), a.sum());
+  EXPECT_NEAR(whole.mean(), a.mean(), 1e-9);
+  EXPECT_NEAR(whole.variance(), a.variance(), 1e-6);
+
+  Snapshot snapshot {a, 2};
+  EXPECT_EQ(0.5, snapshot.min());
+  EXPECT_EQ(617, snapshot.max());
+  EXPECT_EQ(1234 * 1235 / 4.0, snapshot.sum());
+  EXPECT_NEAR(308.75, snapshot.mean(), 1e-9);
+  EXPECT_NEAR(std::sqrt(1234 * 1235 / 12.0) / 2, snapshot.std_dev(), 1e-9);
+}
+
+
+TEST(DDSketchTest, collapsingBoundsTheSmallestMagnitudes) {
+  // 300 bins at 1% cover a factor of about 400, so values spread over six
+  // orders of magnitude collapse the lowest buckets while the top stays
+  // accurate.
+  DDSketch sketch {0.01, 300};
+  auto values = HeavyTailed(50000, 3);
+  for (auto v : values) {
+    sketch.insert(v);
+  }
+  EXPECT_EQ(values.size(), sketch.count());
+  for (auto q : {0.99, 0.999, 1.0}) {
+    auto exact = Exact(values, q);
+    EXPECT_NEAR(exact, sketch.get(q), exact * 0.01) << "q = " << q;
+  }
+  EXPECT_LE(sketch.get(0.0), sketch.get(0.5));
+}
+
+
+TEST(DDSketchTest, serializeRoundTrips) {
+  DDSketch sketch {0.01, 300};
+  for (auto v : HeavyTailed(5000, 4)) {
+    sketch.insert(v);
+    sketch.insert(-v / 2);
+  }
+  sketch.insert(0);
+  auto bytes = sketch.serialize();
+  auto copy = DDSketch::deserialize(bytes);
+  EXPECT_EQ(sketch.count(), copy.count());
+  EXPECT_EQ(sketch.relative_accuracy(), copy.relative_accuracy());
+  EXPECT_EQ(sketch.min(), copy.min());
+  EXPECT_EQ(sketch.sum(), copy.sum());
+  EXPECT_EQ(sketch.variance(), copy.variance());
+  for (auto q : {0.0, 0.1, 0.5, 0.99, 1.0}) {
+    EXPECT_EQ(sketch.get(q), copy.get(q)) << "q = " << q;
+  }
+  EXPECT_EQ(bytes, copy.serialize());
+
+  EXPECT_EQ(0u, DDSketch::deserialize(DDSketch().serialize()).count());
+  EXPECT_THROW(DDSketch::deserialize("DDS0"), std::invalid_argument);
+  EXPECT_THROW(DDSketch::deserialize(bytes.substr(0, bytes.size() - 1)), std::invalid_argument);
+  EXPECT_THROW(DDSketch::deserialize(bytes + "x"), std::invalid_argument);
+}
@@ -138,3 +138,20 @@ TEST(EWMATest, rateDefaultDurationIsOneSecond) {
   EXPECT_NEAR(36.0, ewma.getRate(std::chrono::minutes(1)), 1e-6);
   EXPECT_NEAR(2160.0, ewma.getRate(std::chrono::hours(1)), 1e-6);
 }
+
+
+TEST(EWMATest, aRestoredRateDecaysWhileIdle) {
+  auto ewma = EWMA::oneMinuteEWMA();
+  ewma.update(3);
+  ewma.tick();
+  auto saved = ewma.getRate(std::chrono::nanoseconds(1));
+
+  // A minute without events is twelve ticks without events.
+  elapseMinute(ewma);
+  auto restored = EWMA::oneMinuteEWMA();
+  EXPECT_FALSE(restored.initialized());
+  restored.restore(saved, std::chrono::seconds(62));
+  EXPECT_TRUE(restored.initialized());
+  EXPECT_NEAR(ewma.getRate(), restored.getRate(), 1e-9);
+  EXPECT_NEAR(0.22072766, restored.getRate(), 1e-6);
+}
@@ -4,6 +4,8 @@
 
 #include "medida/stats/exp_decay_sample.h"
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 using namespace medida::stats;
@@ -82,15 +84,16 @@ TEST(ExpDecaySampleTest, longPeriodsOfInactivityShouldNotCorruptSamplingState) {
     EXPECT_GE(v, 1000.0);
   }
 
-  // wait for 15 hours and add another value.
-  // this should trigger a rescale. Note that the number of samples will be reduced to 2
-  // because of the very small scaling factor that will make all existing priorities equal to
-  // zero after rescale.
+  // wait for 15 hours and add another value. Priorities are kept in log
+  // space and never rescaled, so the reservoir stays full and the new value
+  // displaces one of the old ones.
   t += std::chrono::hours(15);
   sample.Update(2000, t);
-  EXPECT_EQ(2, sample.size());
+  EXPECT_EQ(10, sample.size());
 
-  for (auto& v : sample.MakeSnapshot().getValues()) {
+  auto values = sample.MakeSnapshot().getValues();
+  EXPECT_EQ(1, std::count(values.begin(), values.end(), 2000.0));
+  for (auto& v : values) {
     EXPECT_LT(v, 3000.0);
     EXPECT_GE(v, 1000.0);
   }
@@ -108,3 +111,43 @@ TEST(ExpDecaySampleTest, longPeriodsOfInactivityShouldNotCorruptSamplingState) {
     EXPECT_GE(v, 3000.0);
   }
 }
+
+
+TEST(ExpDecaySampleTest, favoursRecentValues) {
+  // With alpha = 0.1/s, values older than 50s carry under 1% of the total
+  // weight, so nearly all of the reservoir should come from the last 100s.
+  ExpDecaySample sample {100, 0.1};
+  auto t = medida::Clock::now();
+  for (auto i = 0; i < 10000; i++) {
+    sample.Update(i, t);
+    t += std::chrono::milliseconds(100);
+  }
+  auto values = sample.MakeSnapshot().getValues();
+  ASSERT_EQ(100u, values.size());
+  auto recent = std::count_if(values.begin(), values.end(),
+                              [](double v) { return v >= 9000; });
+  EXPECT_GE(recent, 90);
+}
+
+
+TEST(ExpDecaySampleTest, mergeKeepsTheHighestPriorities) {
+  // a starts an hour before b; b's recent values should dominate once the
+  // two are merged.
+  auto t = medida::Clock::now();
+  ExpDecaySample a {100, 0.015};
+  for (auto i = 0; i < 1000; i++) {
+    a.Update(1, t);
+  }
+  ExpDecaySample b {100, 0.015};
+  t += std::chrono::hours(1);
+  for (auto i = 0; i < 1000; i++) {
+    b.Update(2, t);
+  }
+  a.Merge(b);
+  EXPECT_EQ(100, a.size());
+  auto values = a.MakeSnapshot().getValues();
+  EXPECT_EQ(100, std::count(values.begin(), values.end(), 2.0));
+
+  ExpDecaySample c {100, 0.5};
+  EXPECT_THROW(a.Merge(c), std::invalid_argument);
+}
@@ -0,0 +1,85 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/random.h"
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "medida/stats/exp_decay_sample.h"
+#include "medida/stats/uniform_sample.h"
+
+using namespace medida::stats;
+
+namespace {
+
+std::vector<std::uint64_t> Draws(Xoshiro256& rng, int n) {
+  std::vector<std::uint64_t> draws;
+  for (auto i = 0; i < n; i++) {
+    draws.push_back(rng());
+  }
+  return draws;
+}
+
+} // namespace
+
+
+TEST(RandomTest, sameSeedSameSequence) {
+  Xoshiro256 a {42}, b {42}, c {43};
+  auto first = Draws(a, 100);
+  EXPECT_EQ(first, Draws(b, 100));
+  EXPECT_NE(first, Draws(c, 100));
+  a.seed(42);
+  EXPECT_EQ(first, Draws(a, 100));
+}
+
+
+TEST(RandomTest, doublesAreUniformInTheUnitInterval) {
+  Xoshiro256 rng {1};
+  const int n = 100000;
+  int buckets[10] = {};
+  for (auto i = 0; i < n; i++) {
+    auto d = rng.NextDouble();
+    ASSERT_LE(0.0, d);
+    ASSERT_GT(1.0, d);
+    buckets[static_cast<int>(d * 10)]++;
+  }
+  for (auto count : buckets) {
+    EXPECT_NEAR(n / 10, count, n / 100);
+  }
+}
+
+
+TEST(RandomTest, threadsDrawDifferentStreams) {
+  std::vector<std::uint64_t> mine = Draws(ThreadRandom(), 4);
+  std::vector<std::uint64_t> theirs;
+  std::thread([&theirs] { theirs = Draws(ThreadRandom(), 4); }).join();
+  EXPECT_NE(mine, theirs);
+}
+
+
+TEST(RandomTest, aFixedSeedMakesSamplesReproducible) {
+  auto run = [] {
+    SetRandomSeed(7);
+    UniformSample uniform {100};
+    ExpDecaySample biased {100, 0.015};
+    // One timestamp throughout, so that priorities depend only on the
+    // draws and not on how long the loop takes.
+    auto t = medida::Clock::now();
+    for (auto i = 0; i < 10000; i++) {
+      uniform.Update(i);
+      biased.Update(i, t);
+    }
+    return std::make_pair(uniform.MakeSnapshot().getValues(),
+                          biased.MakeSnapshot().getValues());
+  };
+  auto first = run();
+  auto second = run();
+  EXPECT_EQ(first.first, second.first);
+  EXPECT_EQ(first.second, second.second);
+  EXPECT_EQ(100u, std::set<double>(first.first.begin(), first.first.end()).size());
+}
@@ -0,0 +1,134 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/sliding_window_sample.h"
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+using namespace medida;
+using namespace medida::stats;
+
+namespace {
+
+std::vector<double> Sorted(std::vector<double> v) {
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+} // namespace
+
+
+TEST(SlidingWindowSampleTest, keepsOneValuePerSlice) {
+  // 10 slices of 1s each.
+  SlidingWindowSample sample {10, std::chrono::seconds(10)};
+  sample.Seed(1);
+  auto t = Clock::now();
+  for (auto i = 0; i < 5; i++) {
+    sample.Update(i * 10, t);
+    sample.Update(i * 10 + 1, t + std::chrono::milliseconds(500));
+    t += std::chrono::milliseconds(1001);
+  }
+  EXPECT_EQ(5u, sample.size());
+  auto values = sample.MakeSnapshot().getValues();
+  ASSERT_EQ(5u, values.size());
+  for (auto i = 0; i < 5; i++) {
+    EXPECT_TRUE(values[i] == i * 10 || values[i] == i * 10 + 1);
+  }
+}
+
+
+TEST(SlidingWindowSampleTest, timeLimitAppliesToAFullRing) {
+  // Slices are 100s; one value every 150s fills the ring and wraps it, and
+  // the 400s limit then leaves only the last three.
+  SlidingWindowSample sample {4, std::chrono::seconds(400)};
+  auto t = Clock::now();
+  for (auto i = 0; i < 10; i++) {
+    sample.Update(i, t);
+    t += std::chrono::seconds(150);
+  }
+  EXPECT_EQ(3u, sample.size());
+  EXPECT_EQ((std::vector<double> {7, 8, 9}),
+            Sorted(sample.MakeSnapshot().getValues()));
+}
+
+
+TEST(SlidingWindowSampleTest, ringWrapsAround) {
+  SlidingWindowSample sample {4, std::chrono::seconds(4000)};
+  auto t = Clock::now();
+  for (auto i = 0; i < 10; i++) {
+    sample.Update(i, t);
+    t += std::chrono::seconds(1001);
+  }
+  EXPECT_EQ(4u, sample.size());
+  EXPECT_EQ((std::vector<double> {6, 7, 8, 9}),
+            Sorted(sample.MakeSnapshot().getValues()));
+}
+
+
+TEST(SlidingWindowSampleTest, expiresByTime) {
+  SlidingWindowSample sample {100, std::chrono::seconds(10)};
+  auto t = Clock::now();
+  for (auto i = 0; i < 20; i++) {
+    sample.Update(i, t + std::chrono::seconds(i));
+  }
+  // Values older than 10s before the last update (at 19s) are gone.
+  EXPECT_EQ((std::vector<double> {9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19}),
+            Sorted(sample.MakeSnapshot().getValues()));
+
+  // A long gap expires everything but the new value.
+  sample.Update(100, t + std::chrono::hours(1));
+  EXPECT_EQ((std::vector<double> {100}), sample.MakeSnapshot().getValues());
+}
+
+
+TEST(SlidingWindowSampleTest, clear) {
+  SlidingWindowSample sample {10, std::chrono::seconds(10)};
+  auto t = Clock::now();
+  for (auto i = 0; i < 5; i++) {
+    sample.Update(i, t + std::chrono::seconds(i));
+  }
+  sample.Clear();
+  EXPECT_EQ(0u, sample.size());
+  EXPECT_EQ(0u, sample.MakeSnapshot().size());
+  sample.Update(42, t + std::chrono::seconds(6));
+  EXPECT_EQ((std::vector<double> {42}), sample.MakeSnapshot().getValues());
+}
+
+
+TEST(SlidingWindowSampleTest, snapshotIsUnaffectedByLaterUpdates) {
+  SlidingWindowSample sample {4, std::chrono::seconds(4000)};
+  auto t = Clock::now();
+  for (auto v : {40, 10, 30, 20}) {
+    sample.Update(v, t);
+    t += std::chrono::seconds(1001);
+  }
+  auto snapshot = sample.MakeSnapshot(2);
+  for (auto v : {1, 2, 3}) {
+    sample.Update(v, t);
+    t += std::chrono::seconds(1001);
+  }
+  EXPECT_EQ((std::vector<double> {5, 10, 15, 20}), snapshot.getValues());
+  EXPECT_EQ(20, snapshot.max());
+  EXPECT_EQ((std::vector<double> {1, 2, 3, 20}),
+            sample.MakeSnapshot().getValues());
+}
+
+
+TEST(SlidingWindowSampleTest, mergeKeepsTheNewestEntries) {
+  SlidingWindowSample a {4, std::chrono::seconds(4000)};
+  SlidingWindowSample b {4, std::chrono::seconds(4000)};
+  auto t = Clock::now();
+  for (auto v : {1, 2, 3, 4, 5, 6}) {
+    (v % 2 ? a : b).Update(v, t);
+    t += std::chrono::seconds(1001);
+  }
+  a.Merge(b);
+  EXPECT_EQ(4u, a.size());
+  EXPECT_EQ((std::vector<double> {3, 4, 5, 6}), a.MakeSnapshot().getValues());
+  // The ring keeps working from the merged state.
+  a.Update(7, t);
+  EXPECT_EQ((std::vector<double> {4, 5, 6, 7}), a.MakeSnapshot().getValues());
+}
@@ -4,6 +4,10 @@
 
 #include "medida/stats/snapshot.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
 #include <gtest/gtest.h>
 
 using namespace medida::stats;
@@ -67,3 +71,45 @@ TEST_F(SnapshotTest, hasValues) {
 TEST_F(SnapshotTest, hasASize) {
   EXPECT_EQ(5, snapshot.size());
 }
+
+
+TEST_F(SnapshotTest, hasMoments) {
+  EXPECT_EQ(1, snapshot.min());
+  EXPECT_EQ(5, snapshot.max());
+  EXPECT_EQ(15, snapshot.sum());
+  EXPECT_EQ(3, snapshot.mean());
+  EXPECT_NEAR(std::sqrt(2.5), snapshot.std_dev(), 1e-9);
+
+  Snapshot scaled {values, 2};
+  EXPECT_EQ(0.5, scaled.min());
+  EXPECT_EQ(7.5, scaled.sum());
+  EXPECT_NEAR(std::sqrt(2.5) / 2, scaled.std_dev(), 1e-9);
+
+  Snapshot empty {std::vector<double>()};
+  EXPECT_EQ(0, empty.min());
+  EXPECT_EQ(0, empty.mean());
+}
+
+TEST(SnapshotSelectionTest, matchesAFullSort) {
+  std::mt19937 rng {42};
+  std::uniform_int_distribution<int> dist {0, 100000};
+  for (auto n : {1, 2, 7, 1000, 1028}) {
+    std::vector<double> values;
+    for (auto i = 0; i < n; i++) {
+      values.push_back(dist(rng));
+    }
+    std::vector<double> sorted {values};
+    std::sort(sorted.begin(), sorted.end());
+    Snapshot expected {std::make_shared<const std::vector<double>>(sorted), 1000};
+    Snapshot snapshot {std::move(values), 1000};
+    EXPECT_DOUBLE_EQ(expected.getMedian(), snapshot.getMedian());
+    EXPECT_DOUBLE_EQ(expected.get75thPercentile(), snapshot.get75thPercentile());
+    EXPECT_DOUBLE_EQ(expected.get95thPercentile(), snapshot.get95thPercentile());
+    EXPECT_DOUBLE_EQ(expected.get98thPercentile(), snapshot.get98thPercentile());
+    EXPECT_DOUBLE_EQ(expected.get99thPercentile(), snapshot.get99thPercentile());
+    EXPECT_DOUBLE_EQ(expected.get999thPercentile(), snapshot.get999thPercentile());
+    EXPECT_DOUBLE_EQ(expected.max(), snapshot.max());
+    EXPECT_DOUBLE_EQ(expected.getValue(0.3), snapshot.getValue(0.3));
+    EXPECT_EQ(expected.getValues(), snapshot.getValues());
+  }
+}
@@ -0,0 +1,165 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/tdigest.h"
+#include "medida/stats/snapshot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace medida::stats;
+
+namespace {
+
+// Latencies spread over six orders of magnitude.
+std::vector<double> HeavyTailed(std::size_t n, unsigned seed) {
+  std::mt19937 rng {seed};
+  std::lognormal_distribution<double> dist {3.0, 2.5};
+  std::vector<double> values;
+  for (std::size_t i = 0; i < n; i++) {
+    values.push_back(std::min(1e7, 1 + dist(rng)));
+  }
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+// The quantile at which `value` sits in the sorted `values`.
+double Rank(const std::vector<double>& values, double value) {
+  auto below = std::lower_bound(values.begin(), values.end(), value) - values.begin();
+  auto not_above = std::upper_bound(values.begin(), values.end(), value) - values.begin();
+  return (below + not_above) / 2.0 / values.size();
+}
+
+} // namespace
+
+
+TEST(TDigestTest, anEmptyDigest) {
+  TDigest digest;
+  EXPECT_EQ(0u, digest.count());
+  EXPECT_EQ(0.0, digest.get(0.5));
+  EXPECT_EQ(0u, digest.centroid_count());
+  EXPECT_THROW(TDigest {0.5}, std::invalid_argument);
+}
+
+
+TEST(TDigestTest, tailQuantilesAreAccurate) {
+  TDigest digest {100};
+  auto values = HeavyTailed(100000, 1);
+  auto shuffled = values;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937 {2});
+  for (auto v : shuffled) {
+    digest.insert(v);
+  }
+  EXPECT_EQ(values.size(), digest.count());
+  EXPECT_EQ(values.front(), digest.get(0));
+  EXPECT_EQ(values.back(), digest.get(1));
+  // The rank error shrinks towards the tails.
+  EXPECT_NEAR(0.5, Rank(values, digest.get(0.5)), 0.02);
+  EXPECT_NEAR(0.99, Rank(values, digest.get(0.99)), 0.0005);
+  EXPECT_NEAR(0.999, Rank(values, digest.get(0.999)), 0.0001);
+  EXPECT_NEAR(0.9999, Rank(values, digest.get(0.9999)), 0.00003);
+  EXPECT_NEAR(0.001, Rank(values, digest.get(0.001)), 0.0001);
+}
+
+
+TEST(TDigestTest, centroidsStayBounded) {
+  TDigest digest {50};
+  for (auto v : HeavyTailed(200000, 3)) {
+    digest.insert(v);
+  }
+  EXPECT_LE(digest.centroid_count(), 50u);
+  EXPECT_GT(digest.centroid_count(), 10u);
+}
+
+
+TEST(TDigestTest, aMergeMatchesOneDigestOfBoth) {
+  TDigest a, b {200};
+  auto values = HeavyTailed(50000, 4);
+  auto shuffled = values;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937 {5});
+  for (std::size_t i = 0; i < shuffled.size(); i++) {
+    (i % 3 ? a : b).insert(shuffled[i]);
+  }
+  a.merge(b);
+  EXPECT_EQ(values.size(), a.count());
+  EXPECT_EQ(100, a.compression());
+  EXPECT_EQ(values.front(), a.min());
+  EXPECT_EQ(values.back(), a.max());
+  EXPECT_NEAR(0.5, Rank(values, a.get(0.5)), 0.02);
+  EXPECT_NEAR(0.999, Rank(values, a.get(0.999)), 0.0001);
+  EXPECT_LE(a.centroid_count(), 100u);
+}
+
+
+TEST(TDigestTest, aFlushedDigestReadsTheSameWhenConst) {
+  TDigest digest;
+  for (auto v : HeavyTailed(1234, 7)) {
+    digest.insert(v);
+  }
+  TDigest copy {digest};
+  copy.flush();
+  const TDigest& flushed = copy;
+  for (auto q : {0.0, 0.5, 0.99, 0.999, 1.0}) {
+    EXPECT_EQ(digest.get(q), flushed.get(q));
+  }
+  EXPECT_EQ(digest.centroid_count(), copy.centroid_count());
+}
+
+
+TEST(TDigestTest, keepsExactMoments) {
+  TDigest a, b, whole;
+  EXPECT_EQ(0, whole.sum());
+  EXPECT_EQ(0, whole.mean());
+  EXPECT_EQ(0, whole.variance());
+  for (int i = 1; i <= 1234; i++) {
+      (i % 3 ? a : b).insert(i);
+      whole.insert(i);
+  }
+  EXPECT_EQ(1234 * 1235 / 2, whole.sum());
+  EXPECT_NEAR(617.5, whole.mean(), 1e-9);
+  EXPECT_NEAR(1234 * 1235 / 12.0, whole.variance(), 1e-6);
+
+  a.merge(b);
+  EXPECT_EQ(whole.sum(), a.sum());
+  EXPECT_NEAR(whole.mean(), a.mean(), 1e-9);
+  EXPECT_NEAR(whole.variance(), a.variance(), 1e-6);
+
+  Snapshot snapshot {a, 2};
+  EXPECT_EQ(0.5, snapshot.min());
+  EXPECT_EQ(617, snapshot.max());
+  EXPECT_EQ(1234 * 1235 / 4.0, snapshot.sum());
+  EXPECT_NEAR(308.75, snapshot.mean(), 1e-9);
+  EXPECT_NEAR(std::sqrt(1234 * 1235 / 12.0) / 2, snapshot.std_dev(), 1e-9);
+}
+
+
+TEST(TDigestTest, serializeRoundTrips) {
+  TDigest digest {100};
+  for (auto v : HeavyTailed(10000, 6)) {
+    digest.insert(v);
+  }
+  auto bytes = digest.serialize();
+  auto copy = TDigest::deserialize(bytes);
+  EXPECT_EQ(digest.count(), copy.count());
+  EXPECT_EQ(digest.compression(), copy.compression());
+  EXPECT_EQ(digest.min(), copy.min());
+  EXPECT_EQ(digest.max(), copy.max());
+  EXPECT_EQ(digest.sum(), copy.sum());
+  EXPECT_EQ(digest.variance(), copy.variance());
+  for (auto q : {0.0, 0.5, 0.99, 0.999, 1.0}) {
+    EXPECT_EQ(digest.get(q), copy.get(q));
+  }
+  EXPECT_EQ(bytes, copy.serialize());
+
+  EXPECT_THROW(TDigest::deserialize(""), std::invalid_argument);
+  EXPECT_THROW(TDigest::deserialize("XDG1"), std::invalid_argument);
+  EXPECT_THROW(TDigest::deserialize(bytes.substr(0, bytes.size() - 1)), std::invalid_argument);
+  EXPECT_THROW(TDigest::deserialize(bytes + "12345678"), std::invalid_argument);
+}
@@ -5,6 +5,10 @@
 
 #include "medida/stats/uniform_sample.h"
 
+#include <set>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 using namespace medida::stats;
@@ -40,3 +44,105 @@ TEST(UniformSampleTest, clear) {
 
   EXPECT_EQ(0, sample.size());
 }
+
+
+TEST(UniformSampleTest, isUniform) {
+  // Sample 100 out of 10000 values, 200 times over, and check that the
+  // sampled values are spread evenly over ten buckets of the input with a
+  // chi-square test. 27.88 is the 99.9% critical value for 9 degrees of
+  // freedom.
+  const int kTrials = 200, kStream = 10000, kReservoir = 100, kBuckets = 10;
+  std::vector<double> observed(kBuckets);
+  for (auto trial = 0; trial < kTrials; trial++) {
+    UniformSample sample {kReservoir};
+    for (auto i = 0; i < kStream; i++) {
+      sample.Update(i);
+    }
+    auto vals = sample.MakeSnapshot().getValues();
+    ASSERT_EQ(kReservoir, vals.size());
+    std::set<double> distinct(vals.begin(), vals.end());
+    EXPECT_EQ(vals.size(), distinct.size());
+    for (auto& v : vals) {
+      observed[static_cast<int>(v) * kBuckets / kStream]++;
+    }
+  }
+  double expected = double(kTrials) * kReservoir / kBuckets;
+  double chi2 = 0;
+  for (auto o : observed) {
+    chi2 += (o - expected) * (o - expected) / expected;
+  }
+  EXPECT_LT(chi2, 27.88);
+}
+
+
+TEST(UniformSampleTest, concurrentUpdates) {
+  UniformSample sample {100};
+  std::vector<std::thread> threads;
+  for (auto t = 0; t < 4; t++) {
+    threads.emplace_back([&sample, t] {
+      for (auto i = 0; i < 100000; i++) {
+        sample.Update(t * 100000 + i);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(100, sample.size());
+  for (auto& v : sample.MakeSnapshot().getValues()) {
+    EXPECT_LT(v, 400000.0);
+    EXPECT_GE(v, 0.0);
+  }
+}
+
+
+TEST(UniformSampleTest, mergeOfSmallSamplesKeepsEverything) {
+  UniformSample a {100}, b {100};
+  for (auto i = 0; i < 30; i++) {
+    a.Update(i);
+    b.Update(100 + i);
+  }
+  a.Merge(b);
+  EXPECT_EQ(60, a.size());
+  auto vals = a.MakeSnapshot().getValues();
+  std::multiset<double> got(vals.begin(), vals.end());
+  for (auto i = 0; i < 30; i++) {
+    EXPECT_EQ(1u, got.count(i));
+    EXPECT_EQ(1u, got.count(100 + i));
+  }
+}
+
+
+TEST(UniformSampleTest, mergeWeighsByStreamLength) {
+  // b has seen three times as many updates as a, so about three quarters
+  // of the merged reservoir should come from b.
+  std::size_t fromA = 0;
+  for (auto round = 0; round < 50; round++) {
+    UniformSample a {100}, b {100};
+    for (auto i = 0; i < 1000; i++) {
+      a.Update(1);
+    }
+    for (auto i = 0; i < 3000; i++) {
+      b.Update(2);
+    }
+    a.Merge(b);
+    EXPECT_EQ(100, a.size());
+    for (auto v : a.MakeSnapshot().getValues()) {
+      fromA += v == 1;
+    }
+  }
+  EXPECT_NEAR(0.25, fromA / 5000.0, 0.03);
+}
+
+
+TEST(UniformSampleTest, mergeRejectsOtherSampleTypes) {
+  UniformSample a {100};
+  class Other : public Sample {
+    void Clear() {}
+    std::uint64_t size() const { return 0; }
+    void Update(std::int64_t) {}
+    Snapshot MakeSnapshot(uint64_t) const { return {std::vector<double>()}; }
+    void Merge(const Sample&) {}
+  } other;
+  EXPECT_THROW(a.Merge(other), std::invalid_argument);
+}
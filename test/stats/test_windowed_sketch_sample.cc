@@ -0,0 +1,134 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/stats/windowed_sketch_sample.h"
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+using namespace medida;
+using namespace medida::stats;
+
+namespace {
+
+// A parameter other than the default, which samples cannot mix with it.
+template <typename Sample>
+double OtherParameter();
+
+template <>
+double OtherParameter<DDSketchSample>() {
+  return 0.05;
+}
+
+template <>
+double OtherParameter<TDigestSample>() {
+  return 200;
+}
+
+} // namespace
+
+template <typename T>
+class WindowedSketchSampleTest : public ::testing::Test {
+};
+
+typedef ::testing::Types<DDSketchSample, TDigestSample> SketchSamples;
+TYPED_TEST_CASE(WindowedSketchSampleTest, SketchSamples);
+
+
+TYPED_TEST(WindowedSketchSampleTest, reportsThePreviousWindow) {
+  TypeParam sample {std::chrono::seconds(30)};
+  auto t = Clock::time_point() + std::chrono::seconds(3000);
+  for (auto i = 1; i <= 1000; i++) {
+    sample.Update(i, t + std::chrono::milliseconds(i));
+  }
+  // Still the window the values went into.
+  EXPECT_EQ(0u, sample.size(t + std::chrono::seconds(10)));
+
+  auto snapshot = sample.MakeSnapshot(t + std::chrono::seconds(40));
+  EXPECT_EQ(1000u, snapshot.size());
+  EXPECT_NEAR(500, snapshot.getMedian(), 10);
+  EXPECT_NEAR(990, snapshot.get99thPercentile(), 10);
+  EXPECT_EQ(1000, snapshot.max());
+  EXPECT_THROW(snapshot.getValues(), std::runtime_error);
+
+  // A window with no input empties both.
+  EXPECT_EQ(0u, sample.size(t + std::chrono::seconds(90)));
+}
+
+
+TYPED_TEST(WindowedSketchSampleTest, aMergeLinesUpWindows) {
+  TypeParam a, b;
+  auto t = Clock::time_point() + std::chrono::seconds(3000);
+  for (auto i = 0; i < 10; i++) {
+    a.Update(1, t + std::chrono::seconds(i));
+    b.Update(2, t + std::chrono::seconds(i));
+  }
+  for (auto i = 0; i < 10; i++) {
+    b.Update(3, t + std::chrono::seconds(30 + i));
+  }
+  a.Merge(b);
+  auto snapshot = a.MakeSnapshot(t + std::chrono::seconds(40));
+  EXPECT_EQ(20u, snapshot.size());
+  EXPECT_EQ(2, snapshot.max());
+  EXPECT_EQ(10u, a.size(t + std::chrono::seconds(60)));
+
+  TypeParam c {std::chrono::seconds(10)};
+  EXPECT_THROW(a.Merge(c), std::invalid_argument);
+  TypeParam d {std::chrono::seconds(30), OtherParameter<TypeParam>()};
+  EXPECT_THROW(a.Merge(d), std::invalid_argument);
+}
+
+
+TYPED_TEST(WindowedSketchSampleTest, aRestoreRoundTrips) {
+  TypeParam saved;
+  auto t = Clock::time_point() + std::chrono::seconds(3000);
+  for (auto i = 1; i <= 100; i++) {
+    saved.Update(i, t + std::chrono::milliseconds(i));
+  }
+  for (auto i = 1; i <= 50; i++) {
+    saved.Update(1000 + i, t + std::chrono::seconds(30) + std::chrono::milliseconds(i));
+  }
+  auto taken = t + std::chrono::seconds(40);
+  auto state = saved.SaveState(taken);
+
+  // Restored at once, both windows come back where they were.
+  TypeParam restored;
+  restored.RestoreState(state, Clock::duration::zero(), taken);
+  EXPECT_EQ(100u, restored.size(taken));
+  EXPECT_EQ(100, restored.MakeSnapshot(taken).max());
+  EXPECT_TRUE(state == restored.SaveState(taken));
+  auto next = t + std::chrono::seconds(60);
+  EXPECT_EQ(50u, restored.size(next));
+  EXPECT_EQ(1050, restored.MakeSnapshot(next).max());
+
+  EXPECT_THROW(restored.RestoreState(state.substr(0, state.size() - 1), Clock::duration::zero()),
+               std::invalid_argument);
+}
+
+
+TYPED_TEST(WindowedSketchSampleTest, aRestoreMovesWindowsOn) {
+  TypeParam saved;
+  auto t = Clock::time_point() + std::chrono::seconds(3000);
+  for (auto i = 1; i <= 100; i++) {
+    saved.Update(i, t + std::chrono::milliseconds(i));
+  }
+  auto state = saved.SaveState(t + std::chrono::seconds(10));
+
+  // The saved current window has ended by the time it is restored.
+  TypeParam restored;
+  auto now = t + std::chrono::seconds(6000);
+  restored.RestoreState(state, std::chrono::seconds(25), now);
+  EXPECT_EQ(100u, restored.size(now));
+  EXPECT_EQ(100, restored.MakeSnapshot(now).max());
+
+  TypeParam late;
+  late.RestoreState(state, std::chrono::seconds(60), now);
+  EXPECT_EQ(0u, late.size(now));
+
+  TypeParam other {std::chrono::seconds(30), OtherParameter<TypeParam>()};
+  EXPECT_THROW(other.RestoreState(state, std::chrono::seconds(0)), std::invalid_argument);
+  TypeParam shorter {std::chrono::seconds(10)};
+  EXPECT_THROW(shorter.RestoreState(state, std::chrono::seconds(0)), std::invalid_argument);
+}
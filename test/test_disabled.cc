@@ -0,0 +1,57 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// Built only with MEDIDA_DISABLE, in place of the metric types' own tests.
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "medida/medida.h"
+
+using namespace medida;
+
+TEST(DisabledTest, metricsReadZero) {
+  MetricsRegistry registry;
+  auto& counter = registry.NewCounter({"a", "b", "counter"}, 5);
+  auto& meter = registry.NewMeter({"a", "b", "meter"}, "things");
+  auto& histogram = registry.NewHistogram({"a", "b", "histogram"});
+  auto& timer = registry.NewTimer({"a", "b", "timer"});
+
+  counter.inc(3);
+  meter.Mark(7);
+  histogram.Update(42);
+  timer.Update(std::chrono::milliseconds(5));
+  {
+    auto context = timer.TimeScope();
+    EXPECT_EQ(0, context.Stop().count());
+  }
+
+  EXPECT_EQ(0, counter.count());
+  EXPECT_EQ(0u, meter.count());
+  EXPECT_EQ("things", meter.event_type());
+  EXPECT_EQ(0u, histogram.count());
+  EXPECT_EQ(0u, histogram.GetSnapshot().size());
+  EXPECT_EQ(0u, timer.count());
+  EXPECT_EQ(std::chrono::milliseconds(1), timer.duration_unit());
+}
+
+
+TEST(DisabledTest, timeStillRunsTheFunction) {
+  Timer timer;
+  auto ran = false;
+  timer.Time([&] { ran = true; });
+  EXPECT_TRUE(ran);
+}
+
+
+TEST(DisabledTest, reportersStillRun) {
+  MetricsRegistry registry;
+  registry.NewCounter({"a", "b", "counter"}).inc();
+  registry.NewTimer({"a", "b", "timer"}).Update(std::chrono::milliseconds(1));
+  std::ostringstream out;
+  reporting::ConsoleReporter reporter {registry, out};
+  reporter.Run();
+  EXPECT_NE(std::string::npos, out.str().find("count = 0"));
+}
@@ -0,0 +1,67 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "medida/gauge.h"
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "medida/metrics_registry.h"
+
+using namespace medida;
+
+
+TEST(GaugeTest, settableStartsAtInitValue) {
+  Gauge zero;
+  Gauge init {1.5};
+  EXPECT_EQ(0.0, zero.value());
+  EXPECT_EQ(1.5, init.value());
+  EXPECT_FALSE(init.is_callback());
+}
+
+
+TEST(GaugeTest, settableReportsLastValue) {
+  Gauge gauge;
+  gauge.set_value(3.25);
+  gauge.set_value(-1.0);
+  EXPECT_EQ(-1.0, gauge.value());
+}
+
+
+TEST(GaugeTest, callbackIsEvaluatedOnRead) {
+  int calls = 0;
+  Gauge gauge {[&calls] { return double(++calls); }};
+  EXPECT_TRUE(gauge.is_callback());
+  EXPECT_EQ(0, calls);
+  EXPECT_EQ(1.0, gauge.value());
+  EXPECT_EQ(2.0, gauge.value());
+}
+
+
+TEST(GaugeTest, callbackCannotBeSet) {
+  Gauge gauge {[] { return 1.0; }};
+  EXPECT_THROW(gauge.set_value(2.0), std::logic_error);
+  EXPECT_THROW(Gauge {std::function<double()>()}, std::invalid_argument);
+}
+
+
+TEST(GaugeTest, registryReturnsExistingGauge) {
+  MetricsRegistry registry;
+  auto& a = registry.NewGauge({"a", "b", "c"}, [] { return 1.0; });
+  auto& b = registry.NewGauge({"a", "b", "c"}, [] { return 2.0; });
+  EXPECT_EQ(&a, &b);
+  EXPECT_EQ(1.0, b.value());
+}
+
+
+TEST(GaugeTest, processorDispatch) {
+  struct Processor : MetricProcessor {
+    double seen = 0;
+    void Process(Gauge& gauge) { seen = gauge.value(); }
+  } processor;
+  Gauge gauge {4.0};
+  static_cast<MetricInterface&>(gauge).Process(processor);
+  EXPECT_EQ(4.0, processor.seen);
+}
@@ -5,6 +5,7 @@
 #include "medida/histogram.h"
 
 #include <gtest/gtest.h>
+#include <stdexcept>
 #include <thread>
 
 #include "medida/metrics_registry.h"
@@ -92,3 +93,111 @@ TEST(HistogramTest, ckmsMetrics) {
   EXPECT_EQ(28, h.sum());
   EXPECT_EQ(7, h.count());
 }
+
+TEST(HistogramTest, ddsketchMetrics) {
+  MetricsRegistry r {std::chrono::seconds(1)};
+  auto& h = r.NewHistogram({"a", "b", "c"}, SamplingInterface::kDDSketch);
+
+  for (int i = 1; i <= 7; i++) {
+      h.Update(i);
+  }
+
+  EXPECT_EQ(1, h.min());
+  EXPECT_EQ(7, h.max());
+  EXPECT_EQ(28, h.sum());
+  EXPECT_EQ(7, h.count());
+
+  // The sketch reports the previous one-second window.
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  auto s = h.GetSnapshot();
+  EXPECT_EQ(7, s.size());
+  EXPECT_NEAR(4, s.getMedian(), 4 * 0.01);
+  EXPECT_EQ(7, s.max());
+}
+
+TEST(HistogramTest, tdigestMetrics) {
+  MetricsRegistry r {std::chrono::seconds(1)};
+  auto& h = r.NewHistogram({"a", "b", "c"}, SamplingInterface::kTDigest);
+
+  for (int i = 1; i <= 7; i++) {
+      h.Update(i);
+  }
+
+  EXPECT_EQ(1, h.min());
+  EXPECT_EQ(7, h.max());
+  EXPECT_EQ(28, h.sum());
+  EXPECT_EQ(7, h.count());
+
+  // The digest reports the previous one-second window.
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  auto s = h.GetSnapshot();
+  EXPECT_EQ(7, s.size());
+  EXPECT_EQ(4, s.getMedian());
+  EXPECT_EQ(7, s.max());
+}
+
+TEST(HistogramTest, mergeFromMatchesOneHistogramOfBothStreams) {
+  Histogram a {SamplingInterface::kUniform};
+  Histogram b {SamplingInterface::kUniform};
+  Histogram both {SamplingInterface::kUniform};
+  for (int i = 1; i <= 100; i++) {
+      (i % 3 ? a : b).Update(i * i);
+      both.Update(i * i);
+  }
+  a.MergeFrom(b);
+  EXPECT_EQ(both.count(), a.count());
+  EXPECT_EQ(both.sum(), a.sum());
+  EXPECT_EQ(both.min(), a.min());
+  EXPECT_EQ(both.max(), a.max());
+  EXPECT_NEAR(both.mean(), a.mean(), 1e-9);
+  EXPECT_NEAR(both.variance(), a.variance(), 1e-6 * both.variance());
+  EXPECT_EQ(100, a.GetSnapshot().size());
+
+  Histogram empty {SamplingInterface::kUniform};
+  empty.MergeFrom(a);
+  EXPECT_EQ(a.min(), empty.min());
+  EXPECT_NEAR(a.variance(), empty.variance(), 1e-6 * a.variance());
+
+  Histogram ckms {SamplingInterface::kCKMS};
+  EXPECT_THROW(a.MergeFrom(ckms), std::invalid_argument);
+}
+
+TEST(HistogramTest, restoreSkipsOnlyIncompatibleWindows) {
+  Histogram saved {SamplingInterface::kDDSketch};
+  for (int i = 1; i <= 7; i++) {
+    saved.Update(i);
+  }
+  auto state = saved.SaveState();
+
+  // Windows from another type of sample are left out; the rest is kept.
+  Histogram ckms;
+  ckms.RestoreState(state, Clock::duration::zero());
+  EXPECT_EQ(7u, ckms.count());
+  EXPECT_EQ(28, ckms.sum());
+
+  // A malformed sample record is an error, not a mismatch. After the
+  // histogram's magic, count, five doubles and the record's length come
+  // the sample's magic, window size and position in its window.
+  auto corrupt = state;
+  auto position = 4 + 8 + 5 * 8 + 4 + 4 + 8;
+  corrupt.replace(position, 8, 8, '\xff');
+  Histogram ddsketch {SamplingInterface::kDDSketch};
+  EXPECT_THROW(ddsketch.RestoreState(corrupt, Clock::duration::zero()), std::invalid_argument);
+  EXPECT_EQ(0u, ddsketch.count());
+  ddsketch.RestoreState(state, Clock::duration::zero());
+  EXPECT_EQ(7u, ddsketch.count());
+}
+
+
+TEST(HistogramTest, configuredQuantiles) {
+  EXPECT_EQ((std::vector<double> {0.5, 0.75, 0.95, 0.98, 0.99, 0.999}),
+            Histogram().quantiles());
+
+  Histogram h {SamplingInterface::kCKMS, std::chrono::seconds(1),
+               {{0.999, 0.0001}, {0.5, 0.01}}};
+  EXPECT_EQ((std::vector<double> {0.5, 0.999}), h.quantiles());
+
+  EXPECT_THROW(Histogram(SamplingInterface::kCKMS, std::chrono::seconds(1),
+                         {{1.0, 0.001}}),
+               std::invalid_argument);
+}
@@ -4,10 +4,15 @@
 
 #include "medida/meter.h"
 
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "medida/encoding.h"
 #include "medida/metrics_registry.h"
 
 using namespace medida;
@@ -46,3 +51,57 @@ TEST(MeterTest, meterTiming) {
   EXPECT_NEAR(10, meter.mean_rate(), 0.1);
 }
 
+
+TEST(MeterTest, ticksCountEveryEvent) {
+  Meter meter {"things"};
+  // Writers mark across the first tick, which one of them runs.
+  std::atomic<bool> stop {false};
+  std::vector<std::thread> writers;
+  for (auto i = 0; i < 4; i++) {
+    writers.emplace_back([&meter, &stop] {
+      while (!stop.load()) {
+        meter.Mark();
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(5500));
+  stop = true;
+  for (auto& writer : writers) {
+    writer.join();
+  }
+
+  // The tick folded in every event marked before it, and the rest,
+  // including any marked while it ran, wait for the next.
+  auto state = meter.SaveState();
+  encoding::Reader in {state, "meter state"};
+  ASSERT_TRUE(in.Expect("MTR1", 4));
+  auto count = in.GetU64();
+  auto uncounted = in.GetU64();
+  in.GetI64();
+  EXPECT_EQ(meter.count(), count);
+  for (auto i = 0; i < 3; i++) {
+    EXPECT_EQ(1u, in.GetU32());
+    // The first tick sets each rate to its events over the 5 s interval.
+    auto ticked = in.GetDouble() * 5e9;
+    EXPECT_EQ(count - uncounted, std::llround(ticked));
+  }
+}
+
+
+TEST(MeterTest, saveAndRestore) {
+  Meter saved {"things"};
+  saved.Mark(5);
+  auto state = saved.SaveState();
+
+  // Restoring adds to what the meter already holds.
+  Meter meter {"things"};
+  meter.Mark(2);
+  meter.RestoreState(state, std::chrono::seconds(10));
+  EXPECT_EQ(7, meter.count());
+  // Ten seconds down count towards the mean rate.
+  EXPECT_GT(1.0, meter.mean_rate());
+
+  EXPECT_THROW(meter.RestoreState("MTR1", std::chrono::seconds(0)), std::invalid_argument);
+  EXPECT_THROW(meter.RestoreState(state + "x", std::chrono::seconds(0)), std::invalid_argument);
+  EXPECT_EQ(7, meter.count());
+}
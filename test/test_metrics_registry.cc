@@ -4,10 +4,28 @@
 
 #include "medida/metrics_registry.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 using namespace medida;
 
+namespace {
+
+std::string CheckpointPath(const std::string& test) {
+  return "/tmp/medida-test-" + test + "-" + std::to_string(getpid());
+}
+
+} // namespace
+
 struct MetricsRegistryTest : public ::testing::Test {
   MetricsRegistry registry;
 };
@@ -21,3 +39,219 @@ TEST_F(MetricsRegistryTest, keysByName) {
   EXPECT_EQ(&abc, &abc2) << "Counter a.b.c was created twice";
   EXPECT_NE(&abc, &abcd) << "Counter a.b.c and a.b.c.d are the same object";
 }
+
+
+TEST_F(MetricsRegistryTest, remove) {
+  registry.NewCounter({"a", "b", "c"}).inc();
+  auto held = registry.GetAllMetrics().at({"a", "b", "c"});
+  EXPECT_TRUE(registry.Remove({"a", "b", "c"}));
+  EXPECT_FALSE(registry.Remove({"a", "b", "c"}));
+  EXPECT_EQ(0u, registry.GetAllMetrics().size());
+
+  // An outstanding shared_ptr keeps the removed metric usable.
+  auto& counter = dynamic_cast<Counter&>(*held);
+  counter.inc();
+  EXPECT_EQ(2, counter.count());
+
+  // Re-registering the name creates a fresh metric.
+  EXPECT_EQ(0, registry.NewCounter({"a", "b", "c"}).count());
+  EXPECT_NE(&counter, &registry.NewCounter({"a", "b", "c"}));
+}
+
+
+TEST_F(MetricsRegistryTest, removeIdle) {
+  auto ttl = std::chrono::milliseconds(50);
+  auto busy = registry.NewCounterShared({"a", "b", "busy"});
+  registry.NewCounterShared({"a", "b", "idle"});
+  registry.NewTimerShared({"a", "b", "idle_timer"});
+
+  // The first pass only starts tracking.
+  EXPECT_EQ(0u, registry.RemoveIdle(std::chrono::seconds(0)));
+
+  std::this_thread::sleep_for(ttl);
+  busy->inc();
+  EXPECT_EQ(2u, registry.RemoveIdle(ttl));
+  EXPECT_EQ(1u, registry.GetAllMetrics().count({"a", "b", "busy"}));
+  EXPECT_EQ(1u, registry.GetAllMetrics().size());
+
+  // Reads do not keep a metric alive, but holding it does.
+  std::this_thread::sleep_for(ttl);
+  busy->count();
+  EXPECT_EQ(0u, registry.RemoveIdle(ttl));
+  busy.reset();
+  EXPECT_EQ(1u, registry.RemoveIdle(ttl));
+  EXPECT_EQ(0u, registry.GetAllMetrics().size());
+}
+
+
+TEST_F(MetricsRegistryTest, removeIdleSeesUpdatesBetweenCalls) {
+  auto ttl = std::chrono::milliseconds(50);
+  for (auto round = 0; round < 5; round++) {
+    MetricsRegistry registry;
+    // Read after the others, so that a call reads it well after starting
+    // its epoch.
+    for (auto i = 0; i < 10000; i++) {
+      registry.NewCounter({"a", "b", std::to_string(i)});
+    }
+    // Not held, so that nothing but idleness keeps it.
+    auto counter = registry.NewCounterShared({"z", "z", "z"}).get();
+    registry.RemoveIdle(ttl);
+    std::atomic<bool> stop {false};
+    std::thread writer([counter, &stop] {
+      while (!stop.load()) {
+        counter->inc();
+      }
+    });
+    // The writer will have touched the counter in this call's epoch by the
+    // time it is read, and then keeps updating it past the ttl.
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    registry.RemoveIdle(ttl);
+    std::this_thread::sleep_for(ttl * 2);
+    stop = true;
+    writer.join();
+    EXPECT_EQ(0u, registry.RemoveIdle(ttl)) << "round " << round;
+  }
+}
+
+
+TEST_F(MetricsRegistryTest, removeIdleKeepsHeldMetrics) {
+  auto ttl = std::chrono::milliseconds(20);
+  auto& counter = registry.NewCounter({"a", "b", "counter"});
+  auto& meter = registry.NewMeter({"a", "b", "meter"}, "things");
+  auto timer = registry.NewTimerShared({"a", "b", "timer"});
+  // Fetching a metric by reference keeps it too.
+  registry.NewHistogramShared({"a", "b", "histogram"});
+  registry.NewHistogram({"a", "b", "histogram"});
+  // A reporter's copy of the registry does not, but keeps what it lists
+  // usable.
+  registry.NewCounterShared({"a", "b", "reported"});
+  auto metrics = registry.GetAllMetricsShared();
+
+  registry.StartSweeper(ttl, std::chrono::milliseconds(5));
+  std::this_thread::sleep_for(ttl * 5);
+  registry.StopSweeper();
+  EXPECT_EQ(4u, registry.GetAllMetrics().size());
+  dynamic_cast<Counter&>(*metrics->at({"a", "b", "reported"})).inc();
+  counter.inc();
+  meter.Mark();
+  timer->Update(std::chrono::milliseconds(1));
+  EXPECT_EQ(1, counter.count());
+  EXPECT_EQ(1u, meter.count());
+  EXPECT_EQ(1u, timer->count());
+
+  // Only what nothing outside the registry holds goes.
+  metrics.reset();
+  timer.reset();
+  registry.RemoveIdle(ttl);
+  std::this_thread::sleep_for(ttl);
+  EXPECT_EQ(1u, registry.RemoveIdle(ttl));
+  EXPECT_EQ(3u, registry.GetAllMetrics().size());
+}
+
+
+TEST_F(MetricsRegistryTest, sweeper) {
+  registry.NewHistogramShared({"a", "b", "c"})->Update(1);
+  registry.StartSweeper(std::chrono::milliseconds(20), std::chrono::milliseconds(10));
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!registry.GetAllMetrics().empty() &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  registry.StopSweeper();
+  EXPECT_EQ(0u, registry.GetAllMetrics().size());
+}
+
+
+TEST_F(MetricsRegistryTest, checkpointAndRestore) {
+  auto path = CheckpointPath("checkpoint");
+  registry.NewCounter({"a", "b", "counter"}).inc(42);
+  registry.NewMeter({"a", "b", "meter"}, "things").Mark(7);
+  auto& histogram = registry.NewHistogram({"a", "b", "histogram"});
+  for (auto i = 1; i <= 100; i++) {
+    histogram.Update(i);
+  }
+  registry.NewTimer({"a", "b", "timer"}).Update(std::chrono::milliseconds(5));
+  registry.NewGauge({"a", "b", "gauge"}, 1.0);
+  registry.Checkpoint(path);
+
+  MetricsRegistry restarted;
+  // Metrics that exist already take their state at once.
+  auto& counter = restarted.NewCounter({"a", "b", "counter"}, 1);
+  EXPECT_EQ(4u, restarted.Restore(path));
+  EXPECT_EQ(43, counter.count());
+
+  // The rest take it when they are created.
+  EXPECT_EQ(7u, restarted.NewMeter({"a", "b", "meter"}, "things").count());
+  auto& restored = restarted.NewHistogram({"a", "b", "histogram"});
+  EXPECT_EQ(100u, restored.count());
+  EXPECT_DOUBLE_EQ(histogram.sum(), restored.sum());
+  EXPECT_DOUBLE_EQ(histogram.std_dev(), restored.std_dev());
+  EXPECT_EQ(1, restored.min());
+  EXPECT_EQ(100, restored.max());
+  auto& timer = restarted.NewTimer({"a", "b", "timer"});
+  EXPECT_EQ(1u, timer.count());
+  EXPECT_DOUBLE_EQ(5.0, timer.max());
+
+  // State saved for another type of metric is dropped.
+  MetricsRegistry mismatched;
+  mismatched.Restore(path);
+  EXPECT_EQ(0u, mismatched.NewHistogram({"a", "b", "counter"}).count());
+  std::remove(path.c_str());
+}
+
+
+TEST_F(MetricsRegistryTest, checkpointsCarryUnclaimedState) {
+  auto path = CheckpointPath("unclaimed");
+  registry.NewCounter({"a", "b", "early"}).inc(1);
+  registry.NewCounter({"a", "b", "late"}).inc(2);
+  registry.Checkpoint(path);
+
+  MetricsRegistry first;
+  first.Restore(path);
+  first.NewCounter({"a", "b", "early"}).inc(10);
+  first.Checkpoint(path);
+
+  MetricsRegistry second;
+  EXPECT_EQ(2u, second.Restore(path));
+  EXPECT_EQ(11, second.NewCounter({"a", "b", "early"}).count());
+  EXPECT_EQ(2, second.NewCounter({"a", "b", "late"}).count());
+  std::remove(path.c_str());
+}
+
+
+TEST_F(MetricsRegistryTest, restoreRejectsOtherFiles) {
+  auto path = CheckpointPath("garbage");
+  EXPECT_EQ(0u, registry.Restore(path));
+
+  registry.NewCounter({"a", "b", "c"}).inc(3);
+  registry.Checkpoint(path);
+  std::string bytes;
+  {
+    std::ifstream in {path, std::ios::binary};
+    bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream out {path, std::ios::binary | std::ios::trunc};
+    out << bytes.substr(0, bytes.size() - 1);
+  }
+  MetricsRegistry restarted;
+  EXPECT_THROW(restarted.Restore(path), std::runtime_error);
+  EXPECT_EQ(0, restarted.NewCounter({"a", "b", "c"}).count());
+  std::remove(path.c_str());
+}
+
+
+TEST_F(MetricsRegistryTest, checkpointer) {
+  auto path = CheckpointPath("checkpointer");
+  auto& counter = registry.NewCounter({"a", "b", "c"});
+  counter.inc(1);
+  registry.StartCheckpointing(path, std::chrono::hours(1));
+  counter.inc(1);
+  // Stopping writes a last checkpoint.
+  registry.StopCheckpointing();
+
+  MetricsRegistry restarted;
+  EXPECT_EQ(1u, restarted.Restore(path));
+  EXPECT_EQ(2, restarted.NewCounter({"a", "b", "c"}).count());
+  std::remove(path.c_str());
+}
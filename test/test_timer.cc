@@ -159,3 +159,18 @@ TEST_F(TimerTest, timerTimeLambda) {
   EXPECT_EQ(1, timer.count());
   EXPECT_NEAR(100.0, timer.mean(), 1.0);
 }
+
+
+TEST_F(TimerTest, mergeFrom) {
+  Timer other {std::chrono::milliseconds(1),
+              std::chrono::seconds(1),
+              std::chrono::seconds(1)};
+  timer.Update(std::chrono::milliseconds(10));
+  other.Update(std::chrono::milliseconds(20));
+  other.Update(std::chrono::milliseconds(30));
+  timer.MergeFrom(other);
+  EXPECT_EQ(3, timer.count());
+  EXPECT_NEAR(10.0, timer.min(), 1e-6);
+  EXPECT_NEAR(30.0, timer.max(), 1e-6);
+  EXPECT_NEAR(60.0, timer.sum(), 1e-6);
+}
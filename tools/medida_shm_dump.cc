@@ -0,0 +1,60 @@
+// Copyright 2026 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// medida-shm-dump: prints the metrics a ShmReporter has published, one per
+// line, as the metric name and type followed by field=value pairs:
+//
+//   medida-shm-dump [PATH]
+//
+// PATH defaults to ShmReporter's, /dev/shm/medida. Units, where a metric
+// has them, are given in nanoseconds.
+
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "medida/reporting/shm_reader.h"
+
+using namespace medida::reporting;
+
+int main(int argc, char* argv[]) {
+  if (argc > 2 || (argc == 2 && argv[1][0] == '-')) {
+    std::cerr << "usage: " << argv[0] << " [PATH]" << std::endl;
+    return 2;
+  }
+  std::string path = argc == 2 ? argv[1] : "/dev/shm/medida";
+  try {
+    ShmReader reader {path};
+    auto metrics = reader.Read();
+    auto published = std::chrono::duration_cast<std::chrono::milliseconds>(
+        reader.last_published().time_since_epoch()).count();
+    std::cout << "# pid=" << reader.pid()
+              << " published_ms=" << published
+              << " metrics=" << metrics.size()
+              << " dropped=" << reader.dropped()
+              << (reader.superseded() ? " superseded" : "") << "\n";
+    char number[32];
+    for (auto& m : metrics) {
+      std::cout << m.name << " " << ShmReader::TypeName(m.type);
+      if (m.duration_unit.count()) {
+        std::cout << " duration_unit_ns=" << m.duration_unit.count();
+      }
+      if (m.rate_unit.count()) {
+        std::cout << " rate_unit_ns=" << m.rate_unit.count();
+      }
+      auto& fields = ShmReader::FieldNames(m.type);
+      for (std::size_t i = 0; i < fields.size(); i++) {
+        snprintf(number, sizeof(number), "%.17g", m.values[i]);
+        std::cout << " " << fields[i] << "=" << number;
+      }
+      std::cout << "\n";
+    }
+  } catch (const std::exception& e) {
+    std::cerr << argv[0] << ": " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}